@@ -0,0 +1,196 @@
+/**
+ * @file diagonal_gaussian_distribution.cpp
+ *
+ * Implementation of the diagonal Gaussian distribution class.
+ */
+#include "diagonal_gaussian_distribution.hpp"
+
+using namespace mlpack;
+using namespace mlpack::distribution;
+
+double DiagonalGaussianDistribution::Probability(
+    const arma::vec& observation) const
+{
+  return exp(LogProbability(observation));
+}
+
+double DiagonalGaussianDistribution::LogProbability(
+    const arma::vec& observation) const
+{
+  // If the variances were modified through Variances(), the cached values are
+  // out of date, so we have to use a temporary distribution.
+  if (!upToDate)
+    return DiagonalGaussianDistribution(mean, variances).LogProbability(
+        observation);
+
+  const arma::vec diff = observation - mean;
+  const double exponent = arma::dot(diff % diff, invVariances);
+
+  return -0.5 * (observation.n_elem * log(2 * M_PI) + logDetCov + exponent);
+}
+
+/**
+ * Calculates the log of the probability density function for each data point
+ * (column) in the given matrix.
+ *
+ * @param x List of observations.
+ * @param logProbabilities Output log probabilities for each input observation.
+ */
+void DiagonalGaussianDistribution::LogProbability(
+    const arma::mat& x,
+    arma::vec& logProbabilities) const
+{
+  if (!upToDate)
+  {
+    DiagonalGaussianDistribution(mean, variances).LogProbability(x,
+        logProbabilities);
+    return;
+  }
+
+  // The exponent for each point is the sum of its squared differences from the
+  // mean, weighted by the inverse variances; that is one matrix-vector product
+  // for the whole batch.
+  const arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
+  const arma::vec exponents = trans(diffs % diffs) * invVariances;
+
+  logProbabilities = -0.5 * (x.n_rows * log(2 * M_PI) + logDetCov + exponents);
+}
+
+arma::vec DiagonalGaussianDistribution::Random() const
+{
+  return arma::sqrt(variances) % arma::randn<arma::vec>(mean.n_elem) + mean;
+}
+
+/**
+ * Compute the inverse variances and the log-determinant of the covariance.
+ */
+void DiagonalGaussianDistribution::UpdateVariances()
+{
+  upToDate = true;
+  invVariances = 1.0 / variances;
+  logDetCov = arma::accu(arma::log(variances));
+}
+
+/**
+ * Estimate the Gaussian distribution directly from the given observations.
+ *
+ * @param observations List of observations.
+ */
+void DiagonalGaussianDistribution::Estimate(const arma::mat& observations)
+{
+  if (observations.n_cols == 0)
+  {
+    // This will end up just being empty.
+    mean.zeros(0);
+    Variances(arma::zeros<arma::vec>(0));
+    return;
+  }
+
+  mean = arma::sum(observations, 1) / observations.n_cols;
+
+  const arma::mat diffs = observations -
+      (mean * arma::ones<arma::rowvec>(observations.n_cols));
+
+  // Normalize with (1 / (n - 1)) so that each variance is the unbiased
+  // estimator, as in GaussianDistribution::Estimate().
+  arma::vec newVariances = arma::sum(diffs % diffs, 1) /
+      (observations.n_cols - 1);
+
+  // Ensure that the covariance is positive definite.
+  for (size_t i = 0; i < newVariances.n_elem; ++i)
+  {
+    if (newVariances[i] <= 1e-50)
+    {
+      Log::Debug << "DiagonalGaussianDistribution::Estimate(): variance of "
+          << "dimension " << i << " is not positive.  Adding perturbation."
+          << std::endl;
+      newVariances[i] = 1e-50;
+    }
+  }
+
+  Variances(newVariances);
+}
+
+/**
+ * Estimate the Gaussian distribution from the given observations, taking into
+ * account the probability of each observation actually being from this
+ * distribution.
+ */
+void DiagonalGaussianDistribution::Estimate(const arma::mat& observations,
+                                            const arma::vec& probabilities)
+{
+  if (observations.n_cols == 0)
+  {
+    // This will end up just being empty.
+    mean.zeros(0);
+    Variances(arma::zeros<arma::vec>(0));
+    return;
+  }
+
+  const double sumProb = arma::accu(probabilities);
+  if (sumProb == 0)
+  {
+    // Nothing in this Gaussian!  At least set the variances so that they are
+    // invertible.
+    mean.zeros(observations.n_rows);
+    Variances(1e-50 * arma::ones<arma::vec>(observations.n_rows));
+    return;
+  }
+
+  mean = (observations * probabilities) / sumProb;
+
+  const arma::mat diffs = observations -
+      (mean * arma::ones<arma::rowvec>(observations.n_cols));
+  arma::vec newVariances = ((diffs % diffs) * probabilities) / sumProb;
+
+  // Ensure that the covariance is positive definite.
+  for (size_t i = 0; i < newVariances.n_elem; ++i)
+  {
+    if (newVariances[i] <= 1e-50)
+    {
+      Log::Debug << "DiagonalGaussianDistribution::Estimate(): variance of "
+          << "dimension " << i << " is not positive.  Adding perturbation."
+          << std::endl;
+      newVariances[i] = 1e-50;
+    }
+  }
+
+  Variances(newVariances);
+}
+
+/**
+ * Returns a string representation of this object.
+ */
+std::string DiagonalGaussianDistribution::ToString() const
+{
+  std::ostringstream convert;
+  convert << "DiagonalGaussianDistribution [" << this << "]" << std::endl;
+
+  // Secondary ostringstream so things can be indented right.
+  std::ostringstream data;
+  data << "Mean: " << std::endl << mean;
+  data << "Variances: " << std::endl << variances;
+
+  convert << util::Indent(data.str());
+  return convert.str();
+}
+
+/**
+ * Save to SaveRestoreUtility.
+ */
+void DiagonalGaussianDistribution::Save(util::SaveRestoreUtility& sr) const
+{
+  sr.SaveParameter(Type(), "type");
+  sr.SaveParameter(mean, "mean");
+  sr.SaveParameter(variances, "variances");
+}
+
+/**
+ * Load from SaveRestoreUtility.
+ */
+void DiagonalGaussianDistribution::Load(const util::SaveRestoreUtility& sr)
+{
+  sr.LoadParameter(mean, "mean");
+  sr.LoadParameter(variances, "variances");
+  UpdateVariances();
+}
@@ -0,0 +1,208 @@
+/**
+ * @file diagonal_gaussian_distribution.hpp
+ *
+ * Implementation of the Gaussian distribution with a diagonal covariance.
+ */
+#ifndef __MLPACK_CORE_DISTS_DIAGONAL_GAUSSIAN_DISTRIBUTION_HPP
+#define __MLPACK_CORE_DISTS_DIAGONAL_GAUSSIAN_DISTRIBUTION_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace distribution {
+
+/**
+ * A multivariate Gaussian distribution whose covariance is diagonal; that is,
+ * each dimension is independent, with its own variance.  Only the vector of
+ * variances is stored, so the memory used and the time taken to evaluate the
+ * density of a point are linear in the dimensionality, instead of quadratic
+ * (or, for the factorization of the covariance, cubic) as for
+ * GaussianDistribution.  In high dimensions this is far cheaper, and it can be
+ * used in place of GaussianDistribution in an HMM, or as the component of a
+ * GMM:
+ *
+ * @code
+ * // A GMM with diagonal Gaussian components.
+ * GMM<EMFit<KMeans<>, PositiveDefiniteConstraint,
+ *     DiagonalGaussianDistribution> > gmm(gaussians, dimensionality);
+ *
+ * // An HMM with diagonal Gaussian emissions.
+ * HMM<DiagonalGaussianDistribution> hmm(states,
+ *     DiagonalGaussianDistribution(dimensionality));
+ * @endcode
+ */
+class DiagonalGaussianDistribution
+{
+ private:
+  //! Mean of the distribution.
+  arma::vec mean;
+  //! Variance of each dimension (the diagonal of the covariance).
+  arma::vec variances;
+  //! Inverse of each variance.
+  arma::vec invVariances;
+  //! Log-determinant of the covariance (the sum of the log-variances).
+  double logDetCov;
+  //! Whether or not invVariances and logDetCov are up to date.
+  bool upToDate;
+
+ public:
+  /**
+   * Default constructor, which creates a Gaussian with zero dimension.
+   */
+  DiagonalGaussianDistribution() : logDetCov(0.0), upToDate(true)
+  { /* nothing to do */ }
+
+  /**
+   * Create a Gaussian distribution with zero mean and identity covariance with
+   * the given dimensionality.
+   */
+  DiagonalGaussianDistribution(const size_t dimension) :
+      mean(arma::zeros<arma::vec>(dimension)),
+      variances(arma::ones<arma::vec>(dimension))
+  {
+    UpdateVariances();
+  }
+
+  /**
+   * Create a Gaussian distribution with the given mean and variances (the
+   * diagonal of the covariance).
+   */
+  DiagonalGaussianDistribution(const arma::vec& mean,
+                               const arma::vec& variances) :
+      mean(mean), variances(variances)
+  {
+    UpdateVariances();
+  }
+
+  //! Return the dimensionality of this distribution.
+  size_t Dimensionality() const { return mean.n_elem; }
+
+  /**
+   * Return the probability of the given observation.
+   */
+  double Probability(const arma::vec& observation) const;
+
+  /**
+   * Calculates the probability density function for each data point (column)
+   * in the given matrix.
+   *
+   * @param x List of observations.
+   * @param probabilities Output probabilities for each input observation.
+   */
+  void Probability(const arma::mat& x, arma::vec& probabilities) const;
+
+  /**
+   * Return the log probability of the given observation.
+   */
+  double LogProbability(const arma::vec& observation) const;
+
+  /**
+   * Calculates the log of the probability density function for each data point
+   * (column) in the given matrix.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
+
+  /**
+   * Return a randomly generated observation according to the probability
+   * distribution defined by this object.
+   *
+   * @return Random observation from this Gaussian distribution.
+   */
+  arma::vec Random() const;
+
+  /**
+   * Estimate the Gaussian distribution directly from the given observations.
+   *
+   * @param observations List of observations.
+   */
+  void Estimate(const arma::mat& observations);
+
+  /**
+   * Estimate the Gaussian distribution from the given observations, taking into
+   * account the probability of each observation actually being from this
+   * distribution.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities);
+
+  /**
+   * Return the mean.
+   */
+  const arma::vec& Mean() const { return mean; }
+
+  /**
+   * Return a modifiable copy of the mean.
+   */
+  arma::vec& Mean() { return mean; }
+
+  /**
+   * Return the variances (the diagonal of the covariance).
+   */
+  const arma::vec& Variances() const { return variances; }
+
+  /**
+   * Return a modifiable copy of the variances.  As with
+   * GaussianDistribution::Covariance(), this invalidates the cached inverse
+   * variances, so prefer Variances(const arma::vec&) when possible.
+   */
+  arma::vec& Variances() { upToDate = false; return variances; }
+
+  /**
+   * Set the variances, and recompute the cached inverse variances and
+   * log-determinant.
+   */
+  void Variances(const arma::vec& newVariances)
+  {
+    variances = newVariances;
+    UpdateVariances();
+  }
+
+  /**
+   * Return the full covariance matrix.  This takes memory quadratic in the
+   * dimensionality, so it should only be used for output.
+   */
+  arma::mat Covariance() const { return arma::diagmat(variances); }
+
+  /**
+   * Returns a string representation of this object.
+   */
+  std::string ToString() const;
+
+  /*
+   * Save to or Load from SaveRestoreUtility
+   */
+  void Save(util::SaveRestoreUtility& n) const;
+  void Load(const util::SaveRestoreUtility& n);
+  static std::string const Type() { return "DiagonalGaussianDistribution"; }
+
+ private:
+  /**
+   * Compute the inverse variances and log-determinant of the covariance, and
+   * mark them as up to date.
+   */
+  void UpdateVariances();
+};
+
+/**
+ * Calculates the probability density function for each data point (column) in
+ * the given matrix.
+ *
+ * @param x List of observations.
+ * @param probabilities Output probabilities for each input observation.
+ */
+inline void DiagonalGaussianDistribution::Probability(
+    const arma::mat& x,
+    arma::vec& probabilities) const
+{
+  arma::vec logProbabilities;
+  LogProbability(x, logProbabilities);
+  probabilities = arma::exp(logProbabilities);
+}
+
+}; // namespace distribution
+}; // namespace mlpack
+
+#endif
@@ -10,36 +10,115 @@
 using namespace mlpack;
 using namespace mlpack::distribution;
 
+double GaussianDistribution::Probability(const arma::vec& observation) const
+{
+  return exp(LogProbability(observation));
+}
+
+double GaussianDistribution::LogProbability(const arma::vec& observation) const
+{
+  // If the covariance was modified through Covariance(), the cached values are
+  // out of date, so we have to use a temporary distribution.
+  if (!factored)
+    return GaussianDistribution(mean, covariance).LogProbability(observation);
+
+  const arma::vec diff = observation - mean;
+  const double exponent = arma::dot(diff, invCov * diff);
+
+  return -0.5 * (observation.n_elem * log(2 * M_PI) + logDetCov + exponent);
+}
+
 /**
- * Calculates the multivariate Gaussian probability density function for each
- * data point (column) in the given matrix, with respect to the given mean and
- * variance.
+ * Calculates the log of the multivariate Gaussian probability density function
+ * for each data point (column) in the given matrix.
  *
  * @param x List of observations.
- * @param mean Mean of multivariate Gaussian.
- * @param cov Covariance of multivariate Gaussian.
- * @param probabilities Output probabilities for each input observation.
+ * @param logProbabilities Output log probabilities for each input observation.
  */
-
-double GaussianDistribution::Probability(const arma::vec& observation) const
+void GaussianDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities) const
 {
-  arma::vec diff = mean - observation;
-
-  arma::vec exponent = -0.5 * (trans(diff) * inv(covariance) * diff);
+  if (!factored)
+  {
+    GaussianDistribution(mean, covariance).LogProbability(x, logProbabilities);
+    return;
+  }
 
-  // TODO: What if det(cov) < 0?
-  return pow(2 * M_PI, (double) observation.n_elem / -2.0) *
-      pow(det(covariance), -0.5) * exp(exponent[0]);
-}
+  // Column i of 'diffs' is the difference between x.col(i) and the mean.
+  const arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
 
+  // We only need the diagonal elements of (diffs' * cov^-1 * diffs).  With the
+  // Cholesky factor L of the covariance, these are the squared norms of the
+  // columns of L^-1 * diffs, which we get with one triangular solve.  If the
+  // covariance is not positive definite, we have to use the inverse.
+  arma::rowvec exponents;
+  if (covLower.n_elem > 0)
+  {
+    const arma::mat z = arma::solve(arma::trimatl(covLower), diffs);
+    exponents = arma::sum(z % z, 0);
+  }
+  else
+  {
+    exponents = arma::sum(diffs % (invCov * diffs), 0);
+  }
 
+  logProbabilities = -0.5 * (x.n_rows * log(2 * M_PI) + logDetCov +
+      trans(exponents));
+}
 
 arma::vec GaussianDistribution::Random() const
 {
-  // Should we store chol(covariance) for easier calculation later?
+  if (factored && covLower.n_elem > 0)
+    return covLower * arma::randn<arma::vec>(mean.n_elem) + mean;
+
   return trans(chol(covariance)) * arma::randn<arma::vec>(mean.n_elem) + mean;
 }
 
+/**
+ * Compute the Cholesky factor, inverse, and log-determinant of the covariance.
+ */
+void GaussianDistribution::FactorCovariance()
+{
+  factored = true;
+
+  if (covariance.n_elem == 0)
+  {
+    covLower.reset();
+    invCov.reset();
+    logDetCov = 0.0;
+    return;
+  }
+
+  // The Cholesky decomposition only uses one triangle of the covariance, so it
+  // can only be used if the covariance is symmetric.
+  const double maxAsymmetry = arma::max(arma::max(arma::abs(covariance -
+      trans(covariance))));
+  const bool symmetric = (maxAsymmetry <=
+      1e-10 * arma::max(arma::max(arma::abs(covariance))));
+
+  arma::mat upper;
+  if (symmetric && arma::chol(upper, covariance))
+  {
+    // The determinant of the covariance is the squared product of the diagonal
+    // of the Cholesky factor, and the inverse can be found from the inverse of
+    // the triangular factor.
+    covLower = trans(upper);
+    logDetCov = 2.0 * arma::accu(arma::log(covLower.diag()));
+
+    const arma::mat invLower = arma::inv(arma::trimatl(covLower));
+    invCov = trans(invLower) * invLower;
+  }
+  else
+  {
+    // The covariance is not symmetric positive definite, so we have to use the
+    // general inverse and determinant.
+    covLower.reset();
+    logDetCov = log(arma::det(covariance));
+    if (!arma::inv(invCov, covariance))
+      invCov = arma::pinv(covariance);
+  }
+}
+
 /**
  * Estimate the Gaussian distribution directly from the given observations.
  *
@@ -56,6 +135,7 @@ void GaussianDistribution::Estimate(const arma::mat& observations)
   {
     mean.zeros(0);
     covariance.zeros(0);
+    FactorCovariance();
     return;
   }
 
@@ -90,6 +170,8 @@ void GaussianDistribution::Estimate(const arma::mat& observations)
       perturbation *= 10; // Slow, but we don't want to add too much.
     }
   }
+
+  FactorCovariance();
 }
 
 /**
@@ -109,6 +191,7 @@ void GaussianDistribution::Estimate(const arma::mat& observations,
   {
     mean.zeros(0);
     covariance.zeros(0);
+    FactorCovariance();
     return;
   }
 
@@ -127,6 +210,7 @@ void GaussianDistribution::Estimate(const arma::mat& observations,
     // Nothing in this Gaussian!  At least set the covariance so that it's
     // invertible.
     covariance.diag() += 1e-50;
+    FactorCovariance();
     return;
   }
 
@@ -156,6 +240,8 @@ void GaussianDistribution::Estimate(const arma::mat& observations,
       perturbation *= 10; // Slow, but we don't want to add too much.
     }
   }
+
+  FactorCovariance();
 }
 
 /**
@@ -193,4 +279,5 @@ void GaussianDistribution::Load(const util::SaveRestoreUtility& sr)
 {
   sr.LoadParameter(mean, "mean");
   sr.LoadParameter(covariance, "covariance");
+  FactorCovariance();
 }
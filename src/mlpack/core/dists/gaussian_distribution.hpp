@@ -23,12 +23,22 @@ class GaussianDistribution
   arma::vec mean;
   //! Covariance of the distribution.
   arma::mat covariance;
+  //! Lower triangular Cholesky factor of the covariance (covariance = L L^T),
+  //! or empty if the covariance is not positive definite.
+  arma::mat covLower;
+  //! Inverse of the covariance.
+  arma::mat invCov;
+  //! Log-determinant of the covariance.
+  double logDetCov;
+  //! Whether or not covLower, invCov and logDetCov are up to date.
+  bool factored;
 
  public:
   /**
    * Default constructor, which creates a Gaussian with zero dimension.
    */
-  GaussianDistribution() { /* nothing to do */ }
+  GaussianDistribution() : logDetCov(0.0), factored(true)
+  { /* nothing to do */ }
 
   /**
    * Create a Gaussian distribution with zero mean and identity covariance with
@@ -37,13 +47,18 @@ class GaussianDistribution
   GaussianDistribution(const size_t dimension) :
       mean(arma::zeros<arma::vec>(dimension)),
       covariance(arma::eye<arma::mat>(dimension, dimension))
-  { /* Nothing to do. */ }
+  {
+    FactorCovariance();
+  }
 
   /**
    * Create a Gaussian distribution with the given mean and covariance.
    */
   GaussianDistribution(const arma::vec& mean, const arma::mat& covariance) :
-      mean(mean), covariance(covariance) { /* Nothing to do. */ }
+      mean(mean), covariance(covariance)
+  {
+    FactorCovariance();
+  }
 
   //! Return the dimensionality of this distribution.
   size_t Dimensionality() const { return mean.n_elem; }
@@ -61,7 +76,23 @@ class GaussianDistribution
    * @param probabilities Output probabilities for each input observation.
    */
   void Probability(const arma::mat& x, arma::vec& probabilities) const;
-  
+
+  /**
+   * Return the log probability of the given observation.
+   */
+  double LogProbability(const arma::vec& observation) const;
+
+  /**
+   * Calculates the log of the multivariate Gaussian probability density
+   * function for each data point (column) in the given matrix.  This uses
+   * triangular solves with the Cholesky factor of the covariance, and does not
+   * underflow for observations far from the mean.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -101,9 +132,23 @@ class GaussianDistribution
   const arma::mat& Covariance() const { return covariance; }
 
   /**
-   * Return a modifiable copy of the covariance.
+   * Return a modifiable copy of the covariance.  The Cholesky factor, inverse,
+   * and log-determinant of the covariance are cached, and the cache can't know
+   * about changes made through this reference, so it is invalidated, and the
+   * probability functions will be slow until the covariance is set with
+   * Covariance(const arma::mat&).  Prefer that function when possible.
    */
-  arma::mat& Covariance() { return covariance; }
+  arma::mat& Covariance() { factored = false; return covariance; }
+
+  /**
+   * Set the covariance, and recompute its cached Cholesky factor, inverse, and
+   * log-determinant.
+   */
+  void Covariance(const arma::mat& newCovariance)
+  {
+    covariance = newCovariance;
+    FactorCovariance();
+  }
 
   /**
    * Returns a string representation of this object.
@@ -116,9 +161,13 @@ class GaussianDistribution
   void Save(util::SaveRestoreUtility& n) const;
   void Load(const util::SaveRestoreUtility& n);
   static std::string const Type() { return "GaussianDistribution"; }
-  
-  
-    
+
+ private:
+  /**
+   * Compute the Cholesky factor, inverse, and log-determinant of the
+   * covariance, and mark them as up to date.
+   */
+  void FactorCovariance();
 };
 
 /**
@@ -131,22 +180,10 @@ class GaussianDistribution
 inline void GaussianDistribution::Probability(const arma::mat& x,
                                               arma::vec& probabilities) const
 {
-  // Column i of 'diffs' is the difference between x.col(i) and the mean.
-  arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
-  
-  // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1 *
-  // diffs).  We just don't need any of the other elements.  We can calculate
-  // the right hand part of the equation (instead of the left side) so that
-  // later we are referencing columns, not rows -- that is faster.
-  arma::mat rhs = -0.5 * inv(covariance) * diffs;
-  arma::vec exponents(diffs.n_cols); // We will now fill this.
-  for (size_t i = 0; i < diffs.n_cols; i++)
-    exponents(i) = exp(accu(diffs.unsafe_col(i) % rhs.unsafe_col(i)));
-  
-  probabilities = pow(2 * M_PI, (double) mean.n_elem / -2.0) *
-  pow(arma::det(covariance), -0.5) * exponents;
+  arma::vec logProbabilities;
+  LogProbability(x, logProbabilities);
+  probabilities = arma::exp(logProbabilities);
 }
-  
 
 }; // namespace distribution
 }; // namespace mlpack
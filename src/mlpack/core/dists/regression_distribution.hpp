@@ -48,7 +48,9 @@ class RegressionDistribution
       rf(regression::LinearRegression(predictors, responses))
   {
     err = GaussianDistribution(1);
-    err.Covariance() = rf.ComputeError(predictors, responses);
+    arma::mat covariance(1, 1);
+    covariance(0, 0) = rf.ComputeError(predictors, responses);
+    err.Covariance(covariance);
   }
 
   /**
@@ -0,0 +1,156 @@
+/**
+ * @file parallel_column_reduce.hpp
+ *
+ * A simple parallel map-reduce over a range of data columns, used by objective
+ * functions to split their full-batch objective and gradient between threads.
+ */
+#ifndef __MLPACK_CORE_MATH_PARALLEL_COLUMN_REDUCE_HPP
+#define __MLPACK_CORE_MATH_PARALLEL_COLUMN_REDUCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * Split the columns [begin, end) into one contiguous block per thread, compute
+ * a partial result for each block with the given block function, and sum the
+ * partial results.  The block function is called as
+ *
+ * @code
+ * blockFunction(blockBegin, blockEnd, blockResult);
+ * @endcode
+ *
+ * and must set blockResult to the result for columns [blockBegin, blockEnd).
+ * If [begin, end) is empty, the block function is still called once, with
+ * blockBegin == blockEnd, so it must handle an empty range (usually by setting
+ * blockResult to zero).  The partial results are summed with operator+=, so
+ * any type for which this makes sense (double, arma::vec, arma::mat, ...) can
+ * be used.
+ *
+ * The block boundaries depend only on the number of columns and threads, and
+ * the partial results are always summed in the same order, so the result does
+ * not depend on thread scheduling.  If OpenMP is not available, there are too
+ * few columns to be worth splitting, or this is called from inside a parallel
+ * region, the block function is called once for the whole range.
+ *
+ * @param begin Index of the first column.
+ * @param end One past the index of the last column.
+ * @param blockFunction Function that computes the result for a block; it is
+ *     called concurrently, so it must be thread-safe.
+ * @param result Object to store the result in.
+ * @param minBlockSize Minimum number of columns in a block.
+ */
+template<typename BlockFunctionType, typename ResultType>
+void ParallelColumnReduce(const size_t begin,
+                          const size_t end,
+                          const BlockFunctionType& blockFunction,
+                          ResultType& result,
+                          const size_t minBlockSize = 1)
+{
+  const size_t numColumns = end - begin;
+#ifdef _OPENMP
+  // If we are already inside a parallel region (for instance, one of several
+  // models being trained concurrently), nested regions run on one thread, so
+  // there is no point in splitting the work.
+  const size_t maxThreads = omp_in_parallel() ? 1 : omp_get_max_threads();
+  const size_t numBlocks = std::min(maxThreads,
+      numColumns / std::max(minBlockSize, (size_t) 1));
+#else
+  const size_t numBlocks = 1;
+#endif
+
+  if (numBlocks <= 1)
+  {
+    blockFunction(begin, end, result);
+    return;
+  }
+
+  std::vector<ResultType> results(numBlocks);
+
+  #pragma omp parallel for schedule(static)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t blockBegin = begin + (b * numColumns) / numBlocks;
+    const size_t blockEnd = begin + ((b + 1) * numColumns) / numBlocks;
+    blockFunction(blockBegin, blockEnd, results[b]);
+  }
+
+  result = results[0];
+  for (size_t b = 1; b < numBlocks; ++b)
+    result += results[b];
+}
+
+/**
+ * Split the columns [begin, end) into one contiguous block per thread, and
+ * compute and sum two partial results for each block.  This is the same as the
+ * single-result ParallelColumnReduce(), but the block function is called as
+ *
+ * @code
+ * blockFunction(blockBegin, blockEnd, blockResult1, blockResult2);
+ * @endcode
+ *
+ * which is useful when two different quantities (for instance an objective and
+ * its gradient) are calculated from the same intermediate values.  As with the
+ * single-result version, the block function must handle an empty range.
+ *
+ * @param begin Index of the first column.
+ * @param end One past the index of the last column.
+ * @param blockFunction Function that computes the results for a block; it is
+ *     called concurrently, so it must be thread-safe.
+ * @param result1 Object to store the first result in.
+ * @param result2 Object to store the second result in.
+ * @param minBlockSize Minimum number of columns in a block.
+ */
+template<typename BlockFunctionType,
+         typename ResultType1,
+         typename ResultType2>
+void ParallelColumnReduce(const size_t begin,
+                          const size_t end,
+                          const BlockFunctionType& blockFunction,
+                          ResultType1& result1,
+                          ResultType2& result2,
+                          const size_t minBlockSize = 1)
+{
+  const size_t numColumns = end - begin;
+#ifdef _OPENMP
+  // If we are already inside a parallel region (for instance, one of several
+  // models being trained concurrently), nested regions run on one thread, so
+  // there is no point in splitting the work.
+  const size_t maxThreads = omp_in_parallel() ? 1 : omp_get_max_threads();
+  const size_t numBlocks = std::min(maxThreads,
+      numColumns / std::max(minBlockSize, (size_t) 1));
+#else
+  const size_t numBlocks = 1;
+#endif
+
+  if (numBlocks <= 1)
+  {
+    blockFunction(begin, end, result1, result2);
+    return;
+  }
+
+  std::vector<ResultType1> results1(numBlocks);
+  std::vector<ResultType2> results2(numBlocks);
+
+  #pragma omp parallel for schedule(static)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t blockBegin = begin + (b * numColumns) / numBlocks;
+    const size_t blockEnd = begin + ((b + 1) * numColumns) / numBlocks;
+    blockFunction(blockBegin, blockEnd, results1[b], results2[b]);
+  }
+
+  result1 = results1[0];
+  result2 = results2[0];
+  for (size_t b = 1; b < numBlocks; ++b)
+  {
+    result1 += results1[b];
+    result2 += results2[b];
+  }
+}
+
+}; // namespace math
+}; // namespace mlpack
+
+#endif
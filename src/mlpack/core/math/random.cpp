@@ -9,27 +9,29 @@
 namespace mlpack {
 namespace math {
 
+// Each thread has its own generator; see random.hpp.
 #if BOOST_VERSION >= 104700
   // Global random object.
-  boost::random::mt19937 randGen;
+  thread_local boost::random::mt19937 randGen;
   // Global uniform distribution.
-  boost::random::uniform_01<> randUniformDist;
+  thread_local boost::random::uniform_01<> randUniformDist;
   // Global normal distribution.
-  boost::random::normal_distribution<> randNormalDist;
+  thread_local boost::random::normal_distribution<> randNormalDist;
 #else
   // Global random object.
-  boost::mt19937 randGen;
+  thread_local boost::mt19937 randGen;
 
   #if BOOST_VERSION >= 103900
     // Global uniform distribution.
-    boost::uniform_01<> randUniformDist;
+    thread_local boost::uniform_01<> randUniformDist;
   #else
     // Pre-1.39 Boost.Random did not give default template parameter values.
-    boost::uniform_01<boost::mt19937, double> randUniformDist(randGen);
+    thread_local boost::uniform_01<boost::mt19937, double>
+        randUniformDist(randGen);
   #endif
 
   // Global normal distribution.
-  boost::normal_distribution<> randNormalDist;
+  thread_local boost::normal_distribution<> randNormalDist;
 #endif
 
 }; // namespace math
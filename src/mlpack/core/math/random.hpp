@@ -15,33 +15,42 @@ namespace math /** Miscellaneous math routines. */ {
 // Annoying Boost versioning issues.
 #include <boost/version.hpp>
 
+// Each thread has its own random number generator, so that the random
+// functions can be called from parallel code without data races, and so that a
+// thread can be given its own reproducible stream of random numbers with
+// RandomSeed().
 #if BOOST_VERSION >= 104700
   // Global random object.
-  extern boost::random::mt19937 randGen;
+  extern thread_local boost::random::mt19937 randGen;
   // Global uniform distribution.
-  extern boost::random::uniform_01<> randUniformDist;
+  extern thread_local boost::random::uniform_01<> randUniformDist;
   // Global normal distribution.
-  extern boost::random::normal_distribution<> randNormalDist;
+  extern thread_local boost::random::normal_distribution<> randNormalDist;
 #else
   // Global random object.
-  extern boost::mt19937 randGen;
+  extern thread_local boost::mt19937 randGen;
 
   #if BOOST_VERSION >= 103900
     // Global uniform distribution.
-    extern boost::uniform_01<> randUniformDist;
+    extern thread_local boost::uniform_01<> randUniformDist;
   #else
     // Pre-1.39 Boost.Random did not give default template parameter values.
-    extern boost::uniform_01<boost::mt19937, double> randUniformDist;
+    extern thread_local boost::uniform_01<boost::mt19937, double>
+        randUniformDist;
   #endif
 
   // Global normal distribution.
-  extern boost::normal_distribution<> randNormalDist;
+  extern thread_local boost::normal_distribution<> randNormalDist;
 #endif
 
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
  * The seed is casted to a 32-bit integer before being given to the random
  * number generator, but a size_t is taken as a parameter for API consistency.
+ * Each thread has its own generator, and only the generator of the calling
+ * thread is seeded; other threads keep their current streams.  The seeds of
+ * the C and Armadillo generators, which are shared by all threads, are set
+ * too.
  *
  * @param seed Seed for the random number generator.
  */
@@ -57,6 +66,22 @@ inline void RandomSeed(const size_t seed)
 #endif
 }
 
+/**
+ * Set the random seed of the generator of the calling thread only.  This is
+ * meant for parallel code, where each thread (or each task) should have its own
+ * reproducible stream of random numbers.  Like RandomSeed(), it only seeds the
+ * mlpack generator of the calling thread; unlike RandomSeed(), it does not
+ * reseed the C and Armadillo generators, which are shared by all threads.
+ *
+ * @param seed Seed for the random number generator of this thread.
+ */
+inline void ThreadRandomSeed(const size_t seed)
+{
+  randGen.seed((uint32_t) seed);
+  randUniformDist.reset();
+  randNormalDist.reset();
+}
+
 /**
  * Generates a uniform random number between 0 and 1.
  */
@@ -0,0 +1,108 @@
+/**
+ * @file adagrad_update.hpp
+ *
+ * AdaGrad update rule for MiniBatchSGDType.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_ADAPTIVE_SGD_ADAGRAD_UPDATE_HPP
+#define __MLPACK_CORE_OPTIMIZERS_ADAPTIVE_SGD_ADAGRAD_UPDATE_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * AdaGrad scales the step for each coordinate by the inverse square root of the
+ * sum of the squares of all past gradients for that coordinate, so coordinates
+ * with large or frequent gradients take smaller steps.  For more information,
+ * see the following paper:
+ *
+ * @code
+ * @article{duchi2011adaptive,
+ *   title={Adaptive subgradient methods for online learning and stochastic
+ *       optimization},
+ *   author={Duchi, John and Hazan, Elad and Singer, Yoram},
+ *   journal={The Journal of Machine Learning Research},
+ *   volume={12},
+ *   pages={2121--2159},
+ *   year={2011}
+ * }
+ * @endcode
+ */
+class AdaGradUpdate
+{
+ public:
+  /**
+   * Construct the AdaGrad update rule.
+   *
+   * @param epsilon Value added to the denominator, to avoid division by zero.
+   */
+  AdaGradUpdate(const double epsilon = 1e-8) : epsilon(epsilon) { }
+
+  /**
+   * Reset the state of the update rule before optimization.
+   *
+   * @param rows Number of rows in the iterate.
+   * @param cols Number of columns in the iterate.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    squaredGradient.zeros(rows, cols);
+  }
+
+  /**
+   * Update the iterate with the given gradient.
+   *
+   * @param iterate Point to update.
+   * @param stepSize Step size.
+   * @param gradient Gradient at the point.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient)
+  {
+    squaredGradient += gradient % gradient;
+    iterate -= stepSize * gradient / (arma::sqrt(squaredGradient) + epsilon);
+  }
+
+  /**
+   * Update the given columns of the iterate, for a gradient that is zero in
+   * every other column.  A zero gradient changes neither the iterate nor the
+   * sum of squares, so this takes the same step as the full update.
+   *
+   * @param iterate Point to update.
+   * @param stepSize Step size.
+   * @param gradient Gradient of the given columns (column k holds the gradient
+   *     of column columns[k] of the iterate).
+   * @param columns Indices of the columns with a nonzero gradient.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient,
+              const arma::uvec& columns)
+  {
+    for (size_t k = 0; k < columns.n_elem; ++k)
+    {
+      const size_t c = columns[k];
+      squaredGradient.col(c) += gradient.col(k) % gradient.col(k);
+      iterate.col(c) -= stepSize * gradient.col(k) /
+          (arma::sqrt(squaredGradient.col(c)) + epsilon);
+    }
+  }
+
+  //! Get the value used for numerical stability.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used for numerical stability.
+  double& Epsilon() { return epsilon; }
+
+ private:
+  //! The value used for numerical stability.
+  double epsilon;
+  //! The sum of the squares of all past gradients.
+  arma::mat squaredGradient;
+};
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
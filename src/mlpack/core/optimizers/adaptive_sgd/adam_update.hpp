@@ -0,0 +1,166 @@
+/**
+ * @file adam_update.hpp
+ *
+ * Adam update rule for MiniBatchSGDType.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_ADAPTIVE_SGD_ADAM_UPDATE_HPP
+#define __MLPACK_CORE_OPTIMIZERS_ADAPTIVE_SGD_ADAM_UPDATE_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Adam keeps moving averages of both the gradient and the squared gradient for
+ * each coordinate, and steps along the (bias-corrected) average gradient,
+ * scaled by the inverse square root of the (bias-corrected) average squared
+ * gradient.  For more information, see the following paper:
+ *
+ * @code
+ * @article{kingma2014adam,
+ *   title={Adam: A method for stochastic optimization},
+ *   author={Kingma, Diederik and Ba, Jimmy},
+ *   journal={arXiv preprint arXiv:1412.6980},
+ *   year={2014}
+ * }
+ * @endcode
+ */
+class AdamUpdate
+{
+ public:
+  /**
+   * Construct the Adam update rule.
+   *
+   * @param beta1 Decay rate of the moving average of the gradient.
+   * @param beta2 Decay rate of the moving average of the squared gradient.
+   * @param epsilon Value added to the denominator, to avoid division by zero.
+   */
+  AdamUpdate(const double beta1 = 0.9,
+             const double beta2 = 0.999,
+             const double epsilon = 1e-8) :
+      beta1(beta1),
+      beta2(beta2),
+      epsilon(epsilon),
+      iteration(0)
+  { }
+
+  /**
+   * Reset the state of the update rule before optimization.
+   *
+   * @param rows Number of rows in the iterate.
+   * @param cols Number of columns in the iterate.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    m.zeros(rows, cols);
+    v.zeros(rows, cols);
+    lastUpdate.zeros(cols);
+    iteration = 0;
+  }
+
+  /**
+   * Update the iterate with the given gradient.
+   *
+   * @param iterate Point to update.
+   * @param stepSize Step size.
+   * @param gradient Gradient at the point.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient)
+  {
+    ++iteration;
+
+    m = beta1 * m + (1 - beta1) * gradient;
+    v = beta2 * v + (1 - beta2) * (gradient % gradient);
+
+    // The bias corrections of both averages are folded into the step size.
+    const double biasCorrection1 = 1.0 - std::pow(beta1, (double) iteration);
+    const double biasCorrection2 = 1.0 - std::pow(beta2, (double) iteration);
+
+    iterate -= (stepSize * std::sqrt(biasCorrection2) / biasCorrection1) * m /
+        (arma::sqrt(v) + epsilon);
+  }
+
+  /**
+   * Update the given columns of the iterate, for a gradient that is zero in
+   * every other column.  The moving averages of a column are only decayed
+   * when the column is next updated, so the cost is independent of the number
+   * of columns.  Unlike the full update, the columns that are not given are
+   * not moved along their (decaying) average gradient, so this is an
+   * approximation of Adam (sometimes called lazy Adam).  Only one form of
+   * Update() should be used in one optimization.
+   *
+   * @param iterate Point to update.
+   * @param stepSize Step size.
+   * @param gradient Gradient of the given columns (column k holds the gradient
+   *     of column columns[k] of the iterate).
+   * @param columns Indices of the columns with a nonzero gradient.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient,
+              const arma::uvec& columns)
+  {
+    ++iteration;
+
+    const double biasCorrection1 = 1.0 - std::pow(beta1, (double) iteration);
+    const double biasCorrection2 = 1.0 - std::pow(beta2, (double) iteration);
+    const double scaledStepSize = stepSize * std::sqrt(biasCorrection2) /
+        biasCorrection1;
+
+    for (size_t k = 0; k < columns.n_elem; ++k)
+    {
+      const size_t c = columns[k];
+
+      // Catch up on the decay of the updates that skipped this column.
+      const double skipped = (double) (iteration - lastUpdate[c]);
+      m.col(c) = std::pow(beta1, skipped) * m.col(c) +
+          (1 - beta1) * gradient.col(k);
+      v.col(c) = std::pow(beta2, skipped) * v.col(c) +
+          (1 - beta2) * (gradient.col(k) % gradient.col(k));
+      lastUpdate[c] = iteration;
+
+      iterate.col(c) -= scaledStepSize * m.col(c) /
+          (arma::sqrt(v.col(c)) + epsilon);
+    }
+  }
+
+  //! Get the decay rate of the moving average of the gradient.
+  double Beta1() const { return beta1; }
+  //! Modify the decay rate of the moving average of the gradient.
+  double& Beta1() { return beta1; }
+
+  //! Get the decay rate of the moving average of the squared gradient.
+  double Beta2() const { return beta2; }
+  //! Modify the decay rate of the moving average of the squared gradient.
+  double& Beta2() { return beta2; }
+
+  //! Get the value used for numerical stability.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used for numerical stability.
+  double& Epsilon() { return epsilon; }
+
+ private:
+  //! The decay rate of the moving average of the gradient.
+  double beta1;
+  //! The decay rate of the moving average of the squared gradient.
+  double beta2;
+  //! The value used for numerical stability.
+  double epsilon;
+
+  //! The moving average of the gradient.
+  arma::mat m;
+  //! The moving average of the squared gradient.
+  arma::mat v;
+  //! The update in which each column was last updated (for column updates).
+  arma::Col<size_t> lastUpdate;
+  //! The number of updates so far.
+  size_t iteration;
+};
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file adaptive_sgd.hpp
+ *
+ * Mini-batch stochastic gradient descent with adaptive per-coordinate step
+ * sizes (AdaGrad, RMSProp, and Adam).
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_ADAPTIVE_SGD_ADAPTIVE_SGD_HPP
+#define __MLPACK_CORE_OPTIMIZERS_ADAPTIVE_SGD_ADAPTIVE_SGD_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/minibatch_sgd/minibatch_sgd.hpp>
+
+#include "adagrad_update.hpp"
+#include "rmsprop_update.hpp"
+#include "adam_update.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The adaptive optimizers are mini-batch stochastic gradient descent (see
+ * MiniBatchSGDType) where the step taken for the gradient of each batch is
+ * computed by an update rule that adapts the step size of each coordinate
+ * based on the gradients seen so far.  Adaptive methods are much less sensitive
+ * to the choice of step size than plain SGD, and usually need fewer passes over
+ * the data.
+ *
+ * The available update rules are AdaGradUpdate, RMSPropUpdate, and AdamUpdate;
+ * the AdaGrad, RMSProp, and Adam templates are shortcuts for MiniBatchSGDType
+ * with each of these, and can be used wherever an optimizer template is
+ * expected:
+ *
+ * @code
+ * LogisticRegression<Adam> lr(predictors, responses);
+ * RegularizedSVD<AdaGrad> rsvd;
+ * @endcode
+ *
+ * The function to be optimized must implement the batch interface described
+ * in MiniBatchSGDType.
+ */
+
+//! AdaGrad: mini-batch SGD with the AdaGrad update rule.
+template<typename DecomposableFunctionType>
+using AdaGrad = MiniBatchSGDType<DecomposableFunctionType, AdaGradUpdate>;
+
+//! RMSProp: mini-batch SGD with the RMSProp update rule.
+template<typename DecomposableFunctionType>
+using RMSProp = MiniBatchSGDType<DecomposableFunctionType, RMSPropUpdate>;
+
+//! Adam: mini-batch SGD with the Adam update rule.
+template<typename DecomposableFunctionType>
+using Adam = MiniBatchSGDType<DecomposableFunctionType, AdamUpdate>;
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file rmsprop_update.hpp
+ *
+ * RMSProp update rule for MiniBatchSGDType.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_ADAPTIVE_SGD_RMSPROP_UPDATE_HPP
+#define __MLPACK_CORE_OPTIMIZERS_ADAPTIVE_SGD_RMSPROP_UPDATE_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * RMSProp scales the step for each coordinate by the inverse square root of a
+ * moving average of the squares of the recent gradients for that coordinate.
+ * Unlike AdaGrad, old gradients are forgotten, so the steps do not shrink
+ * towards zero over time.  RMSProp was proposed by Tieleman and Hinton in
+ * lecture 6.5 of the Coursera course "Neural Networks for Machine Learning"
+ * (2012).
+ */
+class RMSPropUpdate
+{
+ public:
+  /**
+   * Construct the RMSProp update rule.
+   *
+   * @param alpha Decay rate of the moving average.
+   * @param epsilon Value added to the denominator, to avoid division by zero.
+   */
+  RMSPropUpdate(const double alpha = 0.99, const double epsilon = 1e-8) :
+      alpha(alpha),
+      epsilon(epsilon),
+      iteration(0)
+  { }
+
+  /**
+   * Reset the state of the update rule before optimization.
+   *
+   * @param rows Number of rows in the iterate.
+   * @param cols Number of columns in the iterate.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    meanSquaredGradient.zeros(rows, cols);
+    lastUpdate.zeros(cols);
+    iteration = 0;
+  }
+
+  /**
+   * Update the iterate with the given gradient.
+   *
+   * @param iterate Point to update.
+   * @param stepSize Step size.
+   * @param gradient Gradient at the point.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient)
+  {
+    meanSquaredGradient = alpha * meanSquaredGradient +
+        (1 - alpha) * (gradient % gradient);
+    iterate -= stepSize * gradient /
+        (arma::sqrt(meanSquaredGradient) + epsilon);
+  }
+
+  /**
+   * Update the given columns of the iterate, for a gradient that is zero in
+   * every other column.  The moving average of a column is only decayed when
+   * the column is next updated, so the cost is independent of the number of
+   * columns; as a zero gradient does not move the iterate, this takes the same
+   * steps as the full update.  Only one form of Update() should be used in
+   * one optimization.
+   *
+   * @param iterate Point to update.
+   * @param stepSize Step size.
+   * @param gradient Gradient of the given columns (column k holds the gradient
+   *     of column columns[k] of the iterate).
+   * @param columns Indices of the columns with a nonzero gradient.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient,
+              const arma::uvec& columns)
+  {
+    ++iteration;
+
+    for (size_t k = 0; k < columns.n_elem; ++k)
+    {
+      const size_t c = columns[k];
+
+      // Catch up on the decay of the updates that skipped this column.
+      meanSquaredGradient.col(c) = std::pow(alpha,
+          (double) (iteration - lastUpdate[c])) * meanSquaredGradient.col(c) +
+          (1 - alpha) * (gradient.col(k) % gradient.col(k));
+      lastUpdate[c] = iteration;
+
+      iterate.col(c) -= stepSize * gradient.col(k) /
+          (arma::sqrt(meanSquaredGradient.col(c)) + epsilon);
+    }
+  }
+
+  //! Get the decay rate of the moving average.
+  double Alpha() const { return alpha; }
+  //! Modify the decay rate of the moving average.
+  double& Alpha() { return alpha; }
+
+  //! Get the value used for numerical stability.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used for numerical stability.
+  double& Epsilon() { return epsilon; }
+
+ private:
+  //! The decay rate of the moving average.
+  double alpha;
+  //! The value used for numerical stability.
+  double epsilon;
+  //! The moving average of the squared gradients.
+  arma::mat meanSquaredGradient;
+  //! The update in which each column was last updated (for column updates).
+  arma::Col<size_t> lastUpdate;
+  //! The number of updates so far.
+  size_t iteration;
+};
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
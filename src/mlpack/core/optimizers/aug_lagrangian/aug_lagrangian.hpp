@@ -38,6 +38,14 @@ namespace optimization {
  * the given coordinates.  Evaluate() should provide the objective function
  * value for the given coordinates.
  *
+ * If the LagrangianFunction also implements
+ *
+ * - double EvaluateWithGradient(const arma::mat& coordinates,
+ *        arma::mat& gradient);
+ *
+ * then L-BFGS uses it to calculate the objective and the gradient of the
+ * Augmented Lagrangian function together.
+ *
  * @tparam LagrangianFunction Function which can be optimized by this class.
  */
 template<typename LagrangianFunction>
@@ -0,0 +1,129 @@
+/**
+ * @file evaluate_with_gradient.hpp
+ *
+ * Detection of the optional EvaluateWithGradient() function of objective
+ * functions, and helpers that use it when it is available.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_EVALUATE_WITH_GRADIENT_HPP
+#define __MLPACK_CORE_OPTIMIZERS_EVALUATE_WITH_GRADIENT_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An objective function may optionally implement
+ *
+ *   double EvaluateWithGradient(const arma::mat& coordinates,
+ *                               arma::mat& gradient);
+ *
+ * which returns the objective at the given coordinates and stores the gradient
+ * at the same point.  Separable functions (see SGD) may also implement
+ *
+ *   double EvaluateWithGradient(const arma::mat& coordinates,
+ *                               const size_t i,
+ *                               arma::mat& gradient);
+ *
+ * Either may be const.  Many functions compute the same intermediate results
+ * for the objective and the gradient, so when the optimizer needs both at one
+ * point, this is faster than calling Evaluate() and Gradient().  The optimizers
+ * detect these functions with the traits below, and use the
+ * EvaluateWithGradient() helpers, which fall back to Evaluate() and Gradient()
+ * for functions that do not implement them.
+ */
+HAS_MEM_FUNC(EvaluateWithGradient, HasEvaluateWithGradientSignature);
+
+//! Whether or not FunctionType implements the non-separable
+//! EvaluateWithGradient().
+template<typename FunctionType>
+struct HasEvaluateWithGradient
+{
+  static const bool value =
+      HasEvaluateWithGradientSignature<FunctionType,
+          double(FunctionType::*)(const arma::mat&, arma::mat&)>::value ||
+      HasEvaluateWithGradientSignature<FunctionType,
+          double(FunctionType::*)(const arma::mat&, arma::mat&) const>::value;
+};
+
+//! Whether or not FunctionType implements the separable
+//! EvaluateWithGradient().
+template<typename FunctionType>
+struct HasSeparableEvaluateWithGradient
+{
+  static const bool value =
+      HasEvaluateWithGradientSignature<FunctionType,
+          double(FunctionType::*)(const arma::mat&, const size_t,
+                                  arma::mat&)>::value ||
+      HasEvaluateWithGradientSignature<FunctionType,
+          double(FunctionType::*)(const arma::mat&, const size_t,
+                                  arma::mat&) const>::value;
+};
+
+/**
+ * Evaluate the objective and the gradient of the function at the given point,
+ * using the function's EvaluateWithGradient().
+ */
+template<typename FunctionType>
+typename boost::enable_if_c<HasEvaluateWithGradient<FunctionType>::value,
+    double>::type
+EvaluateWithGradient(FunctionType& function,
+                     const arma::mat& coordinates,
+                     arma::mat& gradient)
+{
+  return function.EvaluateWithGradient(coordinates, gradient);
+}
+
+/**
+ * Evaluate the objective and the gradient of the function at the given point,
+ * for a function without EvaluateWithGradient().
+ */
+template<typename FunctionType>
+typename boost::disable_if_c<HasEvaluateWithGradient<FunctionType>::value,
+    double>::type
+EvaluateWithGradient(FunctionType& function,
+                     const arma::mat& coordinates,
+                     arma::mat& gradient)
+{
+  const double objective = function.Evaluate(coordinates);
+  function.Gradient(coordinates, gradient);
+  return objective;
+}
+
+/**
+ * Evaluate the objective and the gradient of the i'th function of a separable
+ * function at the given point, using the function's EvaluateWithGradient().
+ */
+template<typename FunctionType>
+typename boost::enable_if_c<
+    HasSeparableEvaluateWithGradient<FunctionType>::value, double>::type
+EvaluateWithGradient(FunctionType& function,
+                     const arma::mat& coordinates,
+                     const size_t i,
+                     arma::mat& gradient)
+{
+  return function.EvaluateWithGradient(coordinates, i, gradient);
+}
+
+/**
+ * Evaluate the objective and the gradient of the i'th function of a separable
+ * function at the given point, for a function without EvaluateWithGradient().
+ */
+template<typename FunctionType>
+typename boost::disable_if_c<
+    HasSeparableEvaluateWithGradient<FunctionType>::value, double>::type
+EvaluateWithGradient(FunctionType& function,
+                     const arma::mat& coordinates,
+                     const size_t i,
+                     arma::mat& gradient)
+{
+  const double objective = function.Evaluate(coordinates, i);
+  function.Gradient(coordinates, i, gradient);
+  return objective;
+}
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
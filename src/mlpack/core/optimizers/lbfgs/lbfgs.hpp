@@ -9,6 +9,7 @@
 #define __MLPACK_CORE_OPTIMIZERS_LBFGS_LBFGS_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -24,6 +25,14 @@ namespace optimization {
  *  - double Evaluate(const arma::mat& coordinates);
  *  - void Gradient(const arma::mat& coordinates, arma::mat& gradient);
  *  - arma::mat& GetInitialPoint();
+ *
+ * If the function also implements
+ *
+ *  - double EvaluateWithGradient(const arma::mat& coordinates,
+ *                                arma::mat& gradient);
+ *
+ * then it is used whenever both the objective and the gradient are needed at
+ * the same point, which is the case for every step of the line search.
  */
 template<typename FunctionType>
 class L_BFGS
@@ -174,12 +183,12 @@ class L_BFGS
   std::pair<arma::mat, double> minPointIterate;
 
   /**
-   * Evaluate the function at the given iterate point and store the result if it
-   * is a new minimum.
+   * Evaluate the function and its gradient at the given iterate point and store
+   * the result if it is a new minimum.
    *
    * @return The value of the function.
    */
-  double Evaluate(const arma::mat& iterate);
+  double EvaluateWithGradient(const arma::mat& iterate, arma::mat& gradient);
 
   /**
    * Calculate the scaling factor, gamma, which is used to scale the Hessian
@@ -106,6 +106,11 @@ void AugLagrangianFunction<LRSDPFunction>::Gradient(
     const arma::mat& coordinates,
     arma::mat& gradient) const;
 
+template<>
+double AugLagrangianFunction<LRSDPFunction>::EvaluateWithGradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient) const;
+
 };
 };
 
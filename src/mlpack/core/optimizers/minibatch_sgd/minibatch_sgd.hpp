@@ -0,0 +1,220 @@
+/**
+ * @file minibatch_sgd.hpp
+ *
+ * Mini-batch stochastic gradient descent.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_MINIBATCH_SGD_HPP
+#define __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_MINIBATCH_SGD_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+#include "parallel_batch_gradient.hpp"
+#include "vanilla_update.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+HAS_MEM_FUNC(Gradient, HasGradientSignature);
+
+//! Whether or not FunctionType implements the batch Gradient() that only
+//! calculates the columns with a nonzero gradient (see MiniBatchSGDType).
+template<typename FunctionType>
+struct HasColumnBatchGradient
+{
+  static const bool value =
+      HasGradientSignature<FunctionType,
+          void(FunctionType::*)(const arma::mat&, const size_t, arma::uvec&,
+                                arma::mat&, const size_t)>::value ||
+      HasGradientSignature<FunctionType,
+          void(FunctionType::*)(const arma::mat&, const size_t, arma::uvec&,
+                                arma::mat&, const size_t) const>::value;
+};
+
+/**
+ * Mini-batch stochastic gradient descent is a variant of SGD which, instead of
+ * taking a step for each individual function \f$ f_i(A) \f$, takes a step for
+ * the sum of a small batch of contiguous functions:
+ *
+ * \f[
+ * A_{j + 1} = A_j - \alpha \sum_{i = b_j}^{b_j + B - 1} \nabla f_i(A)
+ * \f]
+ *
+ * where \f$ B \f$ is the batch size and \f$ b_j \f$ is the first function of
+ * the j'th batch.  This is the update taken by MiniBatchSGD; MiniBatchSGDType
+ * takes an UpdateRuleType that computes the step from the gradient of each
+ * batch instead, so the same loop also implements adaptive optimizers such as
+ * AdaGrad, RMSProp, and Adam (see adaptive_sgd.hpp).  Because each batch is a
+ * contiguous block of functions, a data-dependent function can compute the
+ * gradient of the whole batch with a few matrix operations on a block of
+ * columns of its dataset, instead of one call per point.  If OpenMP is
+ * available, each batch is additionally split between the threads, and the
+ * gradients of the pieces are summed (in a fixed order, so results do not
+ * depend on scheduling).
+ *
+ * With shuffling, the order in which the batches are visited is shuffled, but
+ * the contents of each batch are not; so, if the dataset is sorted (for
+ * instance, by label), it should be shuffled before training.
+ *
+ * For MiniBatchSGD to work, a DecomposableFunctionType template parameter is
+ * required.  This class must implement the following functions:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t begin,
+ *                   const size_t batchSize);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t begin,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * NumFunctions() should return the number of functions, and Evaluate() and
+ * Gradient() should return the sum of the objective (or gradient) of functions
+ * begin through (begin + batchSize - 1).  Gradient() must be safe to call from
+ * several threads at once.
+ *
+ * If the gradient of a batch is nonzero in only a few columns of the
+ * coordinates (as for matrix factorization, where a rating only involves one
+ * user and one item), the function can implement this Gradient() instead:
+ *
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t begin,
+ *                 arma::uvec& columns,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * which stores the indices of the columns with a nonzero gradient in columns,
+ * and the gradient of column columns[k] in column k of gradient.  Then only
+ * those columns are updated, so each step takes time proportional to the
+ * size of the batch, not the size of the coordinates.  This Gradient() is
+ * called from one thread only.
+ *
+ * An UpdateRuleType must implement the following functions:
+ *
+ *   // Reset the state of the rule for an iterate of the given size.
+ *   void Initialize(const size_t rows, const size_t cols);
+ *   // Take one step.
+ *   void Update(arma::mat& iterate,
+ *               const double stepSize,
+ *               const arma::mat& gradient);
+ *   // Take one step that only changes the given columns (used for functions
+ *   // with the column batch Gradient()).
+ *   void Update(arma::mat& iterate,
+ *               const double stepSize,
+ *               const arma::mat& gradient,
+ *               const arma::uvec& columns);
+ *
+ * @tparam DecomposableFunctionType Decomposable objective function type to be
+ *     minimized.
+ * @tparam UpdateRuleType Rule used to compute each step.
+ */
+template<typename DecomposableFunctionType, typename UpdateRuleType>
+class MiniBatchSGDType
+{
+ public:
+  /**
+   * Construct the mini-batch SGD optimizer with the given function and
+   * parameters.  The first parameters have the same meaning as for SGD, so the
+   * two optimizers can be used interchangeably; in particular, the number of
+   * iterations is counted in individual functions, not batches.
+   *
+   * @param function Function to be optimized (minimized).
+   * @param stepSize Step size for each iteration.
+   * @param maxIterations Maximum number of functions to visit (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the batch order is shuffled; otherwise, each batch
+   *     is visited in linear order.
+   * @param batchSize Number of functions in each batch.
+   * @param updateRule Instantiated update rule.
+   */
+  MiniBatchSGDType(DecomposableFunctionType& function,
+                   const double stepSize = 0.01,
+                   const size_t maxIterations = 100000,
+                   const double tolerance = 1e-5,
+                   const bool shuffle = true,
+                   const size_t batchSize = 32,
+                   const UpdateRuleType& updateRule = UpdateRuleType());
+
+  /**
+   * Optimize the given function using mini-batch stochastic gradient descent.
+   * The given starting point will be modified to store the finishing point of
+   * the algorithm, and the final objective value is returned.
+   *
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  double Optimize(arma::mat& iterate);
+
+  //! Get the instantiated function to be optimized.
+  const DecomposableFunctionType& Function() const { return function; }
+  //! Modify the instantiated function.
+  DecomposableFunctionType& Function() { return function; }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the batches are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the batches are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the update rule.
+  const UpdateRuleType& UpdateRule() const { return updateRule; }
+  //! Modify the update rule.
+  UpdateRuleType& UpdateRule() { return updateRule; }
+
+  // Convert the object into a string.
+  std::string ToString() const;
+
+ private:
+  //! The instantiated function.
+  DecomposableFunctionType& function;
+
+  //! The step size for each batch.
+  double stepSize;
+
+  //! The maximum number of functions to visit.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the batches are shuffled when iterating.
+  bool shuffle;
+
+  //! The number of functions in each batch.
+  size_t batchSize;
+
+  //! The update rule.
+  UpdateRuleType updateRule;
+};
+
+//! MiniBatchSGD: mini-batch SGD with the plain gradient step.
+template<typename DecomposableFunctionType>
+using MiniBatchSGD = MiniBatchSGDType<DecomposableFunctionType, VanillaUpdate>;
+
+}; // namespace optimization
+}; // namespace mlpack
+
+// Include implementation.
+#include "minibatch_sgd_impl.hpp"
+
+#endif
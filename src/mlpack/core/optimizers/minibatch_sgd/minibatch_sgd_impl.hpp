@@ -0,0 +1,196 @@
+/**
+ * @file minibatch_sgd_impl.hpp
+ *
+ * Implementation of mini-batch stochastic gradient descent.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_MINIBATCH_SGD_IMPL_HPP
+#define __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_MINIBATCH_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "minibatch_sgd.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecomposableFunctionType, typename UpdateRuleType>
+MiniBatchSGDType<DecomposableFunctionType, UpdateRuleType>::MiniBatchSGDType(
+    DecomposableFunctionType& function,
+    const double stepSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle,
+    const size_t batchSize,
+    const UpdateRuleType& updateRule) :
+    function(function),
+    stepSize(stepSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    batchSize(batchSize),
+    updateRule(updateRule)
+{ /* Nothing to do. */ }
+
+/**
+ * Take one step for the batch of functions begin through (begin + size - 1),
+ * for a function that only calculates the columns with a nonzero gradient.
+ * Only those columns are updated.
+ */
+template<typename FunctionType, typename UpdateRuleType>
+typename boost::enable_if_c<HasColumnBatchGradient<FunctionType>::value>::type
+BatchStep(FunctionType& function,
+          UpdateRuleType& updateRule,
+          arma::mat& iterate,
+          const size_t begin,
+          const size_t size,
+          const double stepSize,
+          arma::uvec& columns,
+          arma::mat& gradient)
+{
+  function.Gradient(iterate, begin, columns, gradient, size);
+  updateRule.Update(iterate, stepSize, gradient, columns);
+}
+
+/**
+ * Take one step for the batch of functions begin through (begin + size - 1),
+ * for a function with the full batch gradient.  The gradient is split between
+ * threads.
+ */
+template<typename FunctionType, typename UpdateRuleType>
+typename boost::disable_if_c<HasColumnBatchGradient<FunctionType>::value>::type
+BatchStep(FunctionType& function,
+          UpdateRuleType& updateRule,
+          arma::mat& iterate,
+          const size_t begin,
+          const size_t size,
+          const double stepSize,
+          arma::uvec& /* columns */,
+          arma::mat& gradient)
+{
+  ParallelBatchGradient(function, iterate, begin, gradient, size);
+  updateRule.Update(iterate, stepSize, gradient);
+}
+
+//! Optimize the function (minimize).
+template<typename DecomposableFunctionType, typename UpdateRuleType>
+double MiniBatchSGDType<DecomposableFunctionType, UpdateRuleType>::Optimize(
+    arma::mat& iterate)
+{
+  if (batchSize == 0)
+  {
+    Log::Fatal << "MiniBatchSGD::Optimize(): batch size must be greater than 0!"
+        << std::endl;
+  }
+
+  // Find the number of functions and batches to use.
+  const size_t numFunctions = function.NumFunctions();
+  const size_t numBatches = (numFunctions + batchSize - 1) / batchSize;
+
+  arma::Col<size_t> visitationOrder(numBatches);
+  for (size_t i = 0; i < numBatches; ++i)
+    visitationOrder[i] = i;
+  if (shuffle)
+    visitationOrder = arma::shuffle(visitationOrder);
+
+  // Reset the state of the update rule.
+  updateRule.Initialize(iterate.n_rows, iterate.n_cols);
+
+  // To keep track of where we are and how things are going.
+  size_t currentBatch = 0;
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+
+  // Calculate the first objective function.
+  for (size_t i = 0; i < numBatches; ++i)
+  {
+    const size_t begin = i * batchSize;
+    overallObjective += function.Evaluate(iterate, begin,
+        std::min(batchSize, numFunctions - begin));
+  }
+
+  // Now iterate!  i counts the number of functions visited so far.
+  arma::mat gradient;
+  arma::uvec columns;
+  for (size_t i = 0; (maxIterations == 0) || (i < maxIterations);
+       ++currentBatch)
+  {
+    // Is this iteration the start of a sequence?
+    if ((currentBatch % numBatches) == 0)
+    {
+      // Output current objective function.
+      Log::Info << "Mini-batch SGD: iteration " << i << ", objective "
+          << overallObjective << "." << std::endl;
+
+      if (overallObjective != overallObjective)
+      {
+        Log::Warn << "Mini-batch SGD: converged to " << overallObjective
+            << "; terminating with failure.  Try a smaller step size?"
+            << std::endl;
+        return overallObjective;
+      }
+
+      if (std::abs(lastObjective - overallObjective) < tolerance)
+      {
+        Log::Info << "Mini-batch SGD: minimized within tolerance "
+            << tolerance << "; terminating optimization." << std::endl;
+        return overallObjective;
+      }
+
+      // Reset the counter variables.
+      lastObjective = overallObjective;
+      overallObjective = 0;
+      currentBatch = 0;
+
+      if (shuffle) // Determine order of visitation.
+        visitationOrder = arma::shuffle(visitationOrder);
+    }
+
+    // Find the batch for this iteration.  The last batch may be smaller than
+    // the others.
+    const size_t begin = visitationOrder[currentBatch] * batchSize;
+    const size_t size = std::min(batchSize, numFunctions - begin);
+
+    // Evaluate the gradient for this iteration, and let the update rule take
+    // the step.
+    BatchStep(function, updateRule, iterate, begin, size, stepSize, columns,
+        gradient);
+
+    // Now add that to the overall objective function.
+    overallObjective += function.Evaluate(iterate, begin, size);
+
+    i += size;
+  }
+
+  Log::Info << "Mini-batch SGD: maximum iterations (" << maxIterations << ") "
+      << "reached; terminating optimization." << std::endl;
+  // Calculate final objective.
+  overallObjective = 0;
+  for (size_t i = 0; i < numBatches; ++i)
+  {
+    const size_t begin = i * batchSize;
+    overallObjective += function.Evaluate(iterate, begin,
+        std::min(batchSize, numFunctions - begin));
+  }
+  return overallObjective;
+}
+
+// Convert the object to a string.
+template<typename DecomposableFunctionType, typename UpdateRuleType>
+std::string MiniBatchSGDType<DecomposableFunctionType, UpdateRuleType>::
+    ToString() const
+{
+  std::ostringstream convert;
+  convert << "MiniBatchSGD [" << this << "]" << std::endl;
+  convert << "  Function:" << std::endl;
+  convert << util::Indent(function.ToString(), 2);
+  convert << "  Step size: " << stepSize << std::endl;
+  convert << "  Maximum iterations: " << maxIterations << std::endl;
+  convert << "  Tolerance: " << tolerance << std::endl;
+  convert << "  Shuffle batches: " << (shuffle ? "true" : "false") << std::endl;
+  convert << "  Batch size: " << batchSize << std::endl;
+  return convert.str();
+}
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
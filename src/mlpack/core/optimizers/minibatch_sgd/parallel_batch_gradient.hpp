@@ -0,0 +1,44 @@
+/**
+ * @file parallel_batch_gradient.hpp
+ *
+ * Compute the gradient of a batch of functions, split between threads.  This
+ * is shared by the optimizers that work on batches of a decomposable function.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_PARALLEL_BATCH_GRADIENT_HPP
+#define __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_PARALLEL_BATCH_GRADIENT_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * Compute the gradient of functions begin through (begin + size - 1) of the
+ * given decomposable function, using its batch Gradient() (see MiniBatchSGD).
+ * The batch is split between threads with math::ParallelColumnReduce(), so the
+ * result does not depend on scheduling.
+ *
+ * @param function Decomposable function; Gradient() must be thread-safe.
+ * @param iterate Point to evaluate the gradient at.
+ * @param begin Index of the first function in the batch.
+ * @param gradient Matrix to store the gradient in.
+ * @param size Number of functions in the batch.
+ */
+template<typename DecomposableFunctionType>
+void ParallelBatchGradient(DecomposableFunctionType& function,
+                           const arma::mat& iterate,
+                           const size_t begin,
+                           arma::mat& gradient,
+                           const size_t size)
+{
+  math::ParallelColumnReduce(begin, begin + size,
+      [&](const size_t pieceBegin, const size_t pieceEnd, arma::mat& result)
+      {
+        function.Gradient(iterate, pieceBegin, result, pieceEnd - pieceBegin);
+      }, gradient);
+}
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
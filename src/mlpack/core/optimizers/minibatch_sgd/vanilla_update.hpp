@@ -0,0 +1,73 @@
+/**
+ * @file vanilla_update.hpp
+ *
+ * Plain gradient step update rule for MiniBatchSGDType.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_VANILLA_UPDATE_HPP
+#define __MLPACK_CORE_OPTIMIZERS_MINIBATCH_SGD_VANILLA_UPDATE_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * The vanilla update rule takes a step of the given size along the negative
+ * gradient, with the same step size for every coordinate:
+ *
+ * \f[
+ * A_{j + 1} = A_j - \alpha \nabla f(A_j)
+ * \f]
+ *
+ * This is the update rule used by MiniBatchSGD.
+ */
+class VanillaUpdate
+{
+ public:
+  /**
+   * Reset the state of the update rule before optimization.  The vanilla
+   * update rule has no state, so this does nothing.
+   *
+   * @param rows Number of rows in the iterate.
+   * @param cols Number of columns in the iterate.
+   */
+  void Initialize(const size_t /* rows */, const size_t /* cols */) { }
+
+  /**
+   * Update the iterate with the given gradient.
+   *
+   * @param iterate Point to update.
+   * @param stepSize Step size.
+   * @param gradient Gradient at the point.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient)
+  {
+    iterate -= stepSize * gradient;
+  }
+
+  /**
+   * Update the given columns of the iterate, for a gradient that is zero in
+   * every other column.
+   *
+   * @param iterate Point to update.
+   * @param stepSize Step size.
+   * @param gradient Gradient of the given columns (column k holds the gradient
+   *     of column columns[k] of the iterate).
+   * @param columns Indices of the columns with a nonzero gradient.
+   */
+  void Update(arma::mat& iterate,
+              const double stepSize,
+              const arma::mat& gradient,
+              const arma::uvec& columns)
+  {
+    for (size_t k = 0; k < columns.n_elem; ++k)
+      iterate.col(columns[k]) -= stepSize * gradient.col(k);
+  }
+};
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
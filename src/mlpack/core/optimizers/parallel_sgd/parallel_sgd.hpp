@@ -0,0 +1,165 @@
+/**
+ * @file parallel_sgd.hpp
+ *
+ * Lock-free parallel stochastic gradient descent (Hogwild!).
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_HPP
+#define __MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace optimization {
+
+/**
+ * An implementation of parallel stochastic gradient descent without locking,
+ * as described in the following paper:
+ *
+ * @code
+ * @inproceedings{recht2011hogwild,
+ *   title={Hogwild!: A lock-free approach to parallelizing stochastic gradient
+ *       descent},
+ *   author={Recht, Benjamin and Re, Christopher and Wright, Stephen and Niu,
+ *       Feng},
+ *   booktitle={Advances in Neural Information Processing Systems 24 (NIPS
+ *       2011)},
+ *   pages={693--701},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The optimizer works in the same way as SGD, except that each pass over the
+ * functions \f$ f_i(A) \f$ is split between all of the available OpenMP
+ * threads, and each thread applies its updates to the shared iterate without
+ * any locking.  This works well when the gradient of each \f$ f_i(A) \f$ only
+ * touches a small number of the coordinates of \f$ A \f$ (as in matrix
+ * factorization, where each rating only touches one user vector and one item
+ * vector), because then two threads rarely write to the same coordinate at the
+ * same time, and when they do, the lost update does not noticeably slow
+ * convergence.  Without OpenMP, this is the same as SGD with shuffling.
+ *
+ * Because updates may be interleaved differently on each run, the results are
+ * not bitwise reproducible when more than one thread is used.
+ *
+ * For ParallelSGD to work, a DecomposableFunctionType template parameter is
+ * required.  This class must implement the following functions:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates, const size_t i);
+ *
+ * Evaluate() must be safe to call from several threads at once.  Because the
+ * updates only scale if each thread touches a few coordinates of the iterate,
+ * there is no generic implementation of Optimize(); each function type
+ * specializes it to update only the coordinates its functions depend on.  See
+ * RegularizedSVDFunction for an example.
+ *
+ * @tparam DecomposableFunctionType Decomposable objective function type to be
+ *     minimized.
+ */
+template<typename DecomposableFunctionType>
+class ParallelSGD
+{
+ public:
+  /**
+   * Construct the ParallelSGD optimizer with the given function and
+   * parameters.  The parameters have the same meaning as for SGD, so the two
+   * optimizers can be used interchangeably.
+   *
+   * @param function Function to be optimized (minimized).
+   * @param stepSize Step size for each iteration.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled before each pass;
+   *     otherwise, each thread visits its share of the functions in linear
+   *     order.
+   */
+  ParallelSGD(DecomposableFunctionType& function,
+              const double stepSize = 0.01,
+              const size_t maxIterations = 100000,
+              const double tolerance = 1e-5,
+              const bool shuffle = true);
+
+  /**
+   * Optimize the given function using lock-free parallel stochastic gradient
+   * descent.  The given starting point will be modified to store the finishing
+   * point of the algorithm, and the final objective value is returned.  This
+   * is only defined for function types that specialize it; for any other
+   * function type, it fails to compile.
+   *
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  double Optimize(arma::mat& iterate);
+
+  //! Get the instantiated function to be optimized.
+  const DecomposableFunctionType& Function() const { return function; }
+  //! Modify the instantiated function.
+  DecomposableFunctionType& Function() { return function; }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  // Convert the object into a string.
+  std::string ToString() const;
+
+ private:
+  //! The instantiated function.
+  DecomposableFunctionType& function;
+
+  //! The step size for each example.
+  double stepSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+
+  /**
+   * Evaluate the objective function over all of the functions, in parallel.
+   */
+  double Evaluate(const arma::mat& iterate) const;
+
+  /**
+   * Check whether the optimization should be terminated after a pass over the
+   * functions, and print the status.  This is shared by the specializations of
+   * Optimize().
+   *
+   * @param iteration Number of iterations done so far.
+   * @param objective Objective after the last pass.
+   * @param lastObjective Objective after the pass before that.
+   */
+  bool Terminate(const size_t iteration,
+                 const double objective,
+                 const double lastObjective) const;
+};
+
+}; // namespace optimization
+}; // namespace mlpack
+
+// Include implementation.
+#include "parallel_sgd_impl.hpp"
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file parallel_sgd_impl.hpp
+ *
+ * Implementation of lock-free parallel stochastic gradient descent.
+ */
+#ifndef __MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_IMPL_HPP
+#define __MLPACK_CORE_OPTIMIZERS_PARALLEL_SGD_PARALLEL_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_sgd.hpp"
+
+namespace mlpack {
+namespace optimization {
+
+template<typename DecomposableFunctionType>
+ParallelSGD<DecomposableFunctionType>::ParallelSGD(
+    DecomposableFunctionType& function,
+    const double stepSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const bool shuffle) :
+    function(function),
+    stepSize(stepSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    shuffle(shuffle)
+{ /* Nothing to do. */ }
+
+template<typename DecomposableFunctionType>
+double ParallelSGD<DecomposableFunctionType>::Optimize(
+    arma::mat& /* iterate */)
+{
+  // This is only instantiated for function types that don't specialize
+  // Optimize().  The condition depends on the template parameter, so it is not
+  // checked unless that happens.
+  static_assert(sizeof(DecomposableFunctionType) == 0,
+      "ParallelSGD::Optimize() is not specialized for this function type; see "
+      "RegularizedSVDFunction for an example.");
+  return 0.0;
+}
+
+template<typename DecomposableFunctionType>
+double ParallelSGD<DecomposableFunctionType>::Evaluate(
+    const arma::mat& iterate) const
+{
+  const size_t numFunctions = function.NumFunctions();
+
+  double objective = 0;
+  #pragma omp parallel for reduction(+:objective)
+  for (size_t i = 0; i < numFunctions; ++i)
+    objective += function.Evaluate(iterate, i);
+
+  return objective;
+}
+
+template<typename DecomposableFunctionType>
+bool ParallelSGD<DecomposableFunctionType>::Terminate(
+    const size_t iteration,
+    const double objective,
+    const double lastObjective) const
+{
+  // Output current objective function.
+  Log::Info << "ParallelSGD: iteration " << iteration << ", objective "
+      << objective << "." << std::endl;
+
+  if (objective != objective)
+  {
+    Log::Warn << "ParallelSGD: converged to " << objective << "; terminating "
+        << "with failure.  Try a smaller step size?" << std::endl;
+    return true;
+  }
+
+  if (std::abs(lastObjective - objective) < tolerance)
+  {
+    Log::Info << "ParallelSGD: minimized within tolerance " << tolerance
+        << "; terminating optimization." << std::endl;
+    return true;
+  }
+
+  if ((maxIterations != 0) && (iteration >= maxIterations))
+  {
+    Log::Info << "ParallelSGD: maximum iterations (" << maxIterations << ") "
+        << "reached; terminating optimization." << std::endl;
+    return true;
+  }
+
+  return false;
+}
+
+// Convert the object to a string.
+template<typename DecomposableFunctionType>
+std::string ParallelSGD<DecomposableFunctionType>::ToString() const
+{
+  std::ostringstream convert;
+  convert << "ParallelSGD [" << this << "]" << std::endl;
+  convert << "  Function:" << std::endl;
+  convert << util::Indent(function.ToString(), 2);
+  convert << "  Step size: " << stepSize << std::endl;
+  convert << "  Maximum iterations: " << maxIterations << std::endl;
+  convert << "  Tolerance: " << tolerance << std::endl;
+  convert << "  Shuffle points: " << (shuffle ? "true" : "false") << std::endl;
+  return convert.str();
+}
+
+}; // namespace optimization
+}; // namespace mlpack
+
+#endif
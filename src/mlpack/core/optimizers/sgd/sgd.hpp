@@ -8,6 +8,7 @@
 #define __MLPACK_CORE_OPTIMIZERS_SGD_SGD_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/evaluate_with_gradient.hpp>
 
 namespace mlpack {
 namespace optimization {
@@ -64,6 +65,21 @@ namespace optimization {
  * objective function on the first point in the dataset (presumably, the dataset
  * is held internally in the DecomposableFunctionType).
  *
+ * If the function also implements
+ *
+ *   double EvaluateWithGradient(const arma::mat& coordinates,
+ *                               const size_t i,
+ *                               arma::mat& gradient);
+ *
+ * then it is used to calculate the objective and the gradient of each function
+ * at once (the choice is made at compile time).  In that case, the objective of
+ * each function is taken at the point before its step instead of after it, so
+ * the objective reported for each pass over the functions, which is also the
+ * one used for the tolerance check, is the sum of the objectives before each
+ * step.  This lags the objective at the end of the pass by up to one pass;
+ * the objective returned when the maximum number of iterations is reached is
+ * still calculated at the final point.
+ *
  * @tparam DecomposableFunctionType Decomposable objective function type to be
  *     minimized.
  */
@@ -27,6 +27,44 @@ SGD<DecomposableFunctionType>::SGD(DecomposableFunctionType& function,
     shuffle(shuffle)
 { /* Nothing to do. */ }
 
+/**
+ * Take one SGD step for the i'th function, for a function that implements the
+ * separable EvaluateWithGradient().  The objective and the gradient are
+ * calculated together, so the returned objective is the one before the step.
+ */
+template<typename FunctionType>
+typename boost::enable_if_c<
+    HasSeparableEvaluateWithGradient<FunctionType>::value, double>::type
+SGDStep(FunctionType& function,
+        arma::mat& iterate,
+        const size_t i,
+        const double stepSize,
+        arma::mat& gradient)
+{
+  const double objective = function.EvaluateWithGradient(iterate, i, gradient);
+  iterate -= stepSize * gradient;
+  return objective;
+}
+
+/**
+ * Take one SGD step for the i'th function, for a function without the
+ * separable EvaluateWithGradient().  The returned objective is the one after
+ * the step.
+ */
+template<typename FunctionType>
+typename boost::disable_if_c<
+    HasSeparableEvaluateWithGradient<FunctionType>::value, double>::type
+SGDStep(FunctionType& function,
+        arma::mat& iterate,
+        const size_t i,
+        const double stepSize,
+        arma::mat& gradient)
+{
+  function.Gradient(iterate, i, gradient);
+  iterate -= stepSize * gradient;
+  return function.Evaluate(iterate, i);
+}
+
 //! Optimize the function (minimize).
 template<typename DecomposableFunctionType>
 double SGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
@@ -83,21 +121,13 @@ double SGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
         visitationOrder = arma::shuffle(visitationOrder);
     }
 
-    // Evaluate the gradient for this iteration.
-    if (shuffle)
-      function.Gradient(iterate, visitationOrder[currentFunction], gradient);
-    else
-      function.Gradient(iterate, currentFunction, gradient);
-
-    // And update the iterate.
-    iterate -= stepSize * gradient;
-
-    // Now add that to the overall objective function.
-    if (shuffle)
-      overallObjective += function.Evaluate(iterate,
-          visitationOrder[currentFunction]);
-    else
-      overallObjective += function.Evaluate(iterate, currentFunction);
+    const size_t currentIndex = (shuffle ?
+        (size_t) visitationOrder[currentFunction] : currentFunction);
+
+    // Take the step, and add the objective of this function to the overall
+    // objective function.
+    overallObjective += SGDStep(function, iterate, currentIndex, stepSize,
+        gradient);
   }
 
   Log::Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
@@ -11,6 +11,10 @@
 #include <iostream>
 #include <string>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 #include "cli.hpp"
 #include "log.hpp"
 
@@ -476,6 +480,25 @@ void CLI::ParseStream(std::istream& stream)
   Timer::Start("total_time");
 }
 
+/**
+ * Set the number of OpenMP threads from the given integer parameter.
+ *
+ * @param identifier The name of the parameter holding the number of threads.
+ */
+void CLI::SetNumThreads(const std::string& identifier)
+{
+  const int threads = GetParam<int>(identifier);
+  if (threads < 0)
+  {
+    Log::Fatal << "Invalid number of threads (" << threads << "); must be 0 or "
+        << "greater." << std::endl;
+  }
+#ifdef _OPENMP
+  if (threads > 0)
+    omp_set_num_threads(threads);
+#endif
+}
+
 /* Prints out the current hierarchy. */
 void CLI::Print()
 {
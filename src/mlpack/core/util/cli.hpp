@@ -298,6 +298,17 @@
 #define PARAM_VECTOR_REQ(T, ID, DESC, ALIAS) PARAM(std::vector<T>, ID, DESC, \
     ALIAS, std::vector<T>(), true);
 
+/**
+ * Define the --threads parameter, which sets the number of OpenMP threads a
+ * program uses.  Every program that can run in parallel uses this, so that the
+ * option means the same thing everywhere; call CLI::SetNumThreads("threads")
+ * after CLI::ParseCommandLine() to apply it.
+ *
+ * @see mlpack::CLI, PROGRAM_INFO()
+ */
+#define PARAM_THREADS() PARAM_INT("threads", "The number of threads to use " \
+    "(0 uses the OpenMP default; ignored if OpenMP is not available).", "", 0)
+
 /**
  * @cond
  * Don't document internal macros.
@@ -661,6 +672,15 @@ class CLI
    */
   static void RegisterProgramDoc(util::ProgramDoc* doc);
 
+  /**
+   * Set the number of OpenMP threads from the given integer parameter.  A
+   * negative value is a fatal error, and 0 leaves the OpenMP default.  If
+   * OpenMP is not available, the value is only checked.
+   *
+   * @param identifier The name of the parameter holding the number of threads.
+   */
+  static void SetNumThreads(const std::string& identifier);
+
   /**
    * Destructor.
    */
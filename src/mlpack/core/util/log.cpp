@@ -11,6 +11,10 @@
 
 #include "log.hpp"
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 // Color code escape sequences -- but not on Windows.
 #ifndef _WIN32
   #define BASH_RED "\033[0;31m"
@@ -129,3 +133,40 @@ void Log::Assert(bool condition, const std::string& message)
 void Log::Assert(bool /* condition */, const std::string& /* message */)
 { }
 #endif
+
+LogSilencer::LogSilencer() :
+    active(true),
+    oldInfoIgnore(false),
+    oldWarnIgnore(false),
+    oldDebugIgnore(false)
+{
+#ifdef _OPENMP
+  // Other threads may be using the log, so it can't be changed here.
+  if (omp_in_parallel())
+    active = false;
+#endif
+
+  if (!active)
+    return;
+
+  oldInfoIgnore = Log::Info.ignoreInput;
+  oldWarnIgnore = Log::Warn.ignoreInput;
+  Log::Info.ignoreInput = true;
+  Log::Warn.ignoreInput = true;
+#ifdef DEBUG
+  oldDebugIgnore = Log::Debug.ignoreInput;
+  Log::Debug.ignoreInput = true;
+#endif
+}
+
+LogSilencer::~LogSilencer()
+{
+  if (!active)
+    return;
+
+  Log::Info.ignoreInput = oldInfoIgnore;
+  Log::Warn.ignoreInput = oldWarnIgnore;
+#ifdef DEBUG
+  Log::Debug.ignoreInput = oldDebugIgnore;
+#endif
+}
@@ -83,6 +83,55 @@ class Log
   static std::ostream& cout;
 };
 
+namespace util {
+
+/**
+ * While an object of this class exists, Log::Info and Log::Warn (and
+ * Log::Debug, in debug builds) are silenced, and they are restored when it is
+ * destroyed.  The log streams are not thread-safe, but an ignored stream is
+ * never modified, so code that may write to the log can run on several threads
+ * while the log is silenced.
+ *
+ * @code
+ * {
+ *   util::LogSilencer silencer;
+ *
+ *   #pragma omp parallel for
+ *   for (size_t i = 0; i < n; ++i)
+ *     ... // Anything written to the log here is dropped.
+ * }
+ * @endcode
+ *
+ * If the object is created inside a parallel region, it does nothing, since
+ * the other threads may be using the log; the log should be silenced before
+ * the parallel region starts.
+ */
+class LogSilencer
+{
+ public:
+  //! Silence the log, saving its previous state.
+  LogSilencer();
+  //! Restore the previous state of the log.
+  ~LogSilencer();
+
+ private:
+  //! Whether or not this object silenced the log.
+  bool active;
+  //! Whether or not Log::Info was ignored before.
+  bool oldInfoIgnore;
+  //! Whether or not Log::Warn was ignored before.
+  bool oldWarnIgnore;
+  //! Whether or not Log::Debug was ignored before (only used in debug mode).
+  bool oldDebugIgnore;
+
+  //! Copying a silencer would restore the log twice.
+  LogSilencer(const LogSilencer& other);
+  //! Copying a silencer would restore the log twice.
+  LogSilencer& operator=(const LogSilencer& other);
+};
+
+}; // namespace util
+
 }; //namespace mlpack
 
 #endif
@@ -114,7 +114,8 @@ class PrefixedOutStream
   //! The output stream that all data is to be sent too; example: std::cout.
   std::ostream& destination;
 
-  //! Discards input, prints nothing if true.
+  //! Discards input, prints nothing if true.  While this is set, the stream is
+  //! not modified by output, so it may be used from several threads at once.
   bool ignoreInput;
 
  private:
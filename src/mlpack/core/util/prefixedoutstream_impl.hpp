@@ -62,6 +62,12 @@ void PrefixedOutStream::CallBaseLogic(const T& s,
 template<typename T>
 void PrefixedOutStream::BaseLogic(const T& val)
 {
+  // If nothing is displayed, there is nothing to do.  Returning before any
+  // state is modified also means that an ignored stream can safely be written
+  // to from several threads at once.
+  if (ignoreInput)
+    return;
+
   // We will use this to track whether or not we need to terminate at the end of
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
@@ -60,7 +60,9 @@ class AdaBoost
   double tolerance;
 
   /**
-   * Classification Function. 
+   * Classification Function.  The test points are split into blocks, and the
+   * ensemble is evaluated on the blocks in parallel.
+   *
    * @param test Testing data.
    * @param predictedLabels Vector to store the predicted labels of the 
    *                         test set.
@@ -80,6 +82,23 @@ private:
    */
   void BuildWeightMatrix(const arma::mat& D, arma::rowvec& weights);
 
+  /**
+   *  Classify the given points with a weak learner, splitting the points into
+   *  blocks which are classified in parallel.  The weak learner's Classify()
+   *  must be safe to call concurrently.
+   *
+   *  @param learner The weak learner to classify with.
+   *  @param data The points to classify.
+   *  @param predictedLabels The output vector of predicted labels.
+   */
+  void ClassifyBlocks(WeakLearner& learner,
+                      const MatType& data,
+                      arma::Row<size_t>& predictedLabels);
+
+  //! Number of points in each block when classifying or updating the weights
+  //! in parallel.
+  static const size_t blockSize = 4096;
+
   size_t numClasses;
   
   std::vector<WeakLearner> wl;
@@ -78,6 +78,11 @@ AdaBoost<MatType, WeakLearner>::AdaBoost(
   // This is the final hypothesis.
   arma::Row<size_t> finalH(predictedLabels.n_cols);
 
+  // Each round's weak learner is built from the previous round's, so anything
+  // it caches about the training data (such as the sort order of a decision
+  // stump) is reused between rounds, and released when boosting ends.
+  boost::shared_ptr<WeakLearner> previous;
+
   // now start the boosting rounds
   for (int i = 0; i < iterations; i++)
   {
@@ -93,30 +98,27 @@ AdaBoost<MatType, WeakLearner>::AdaBoost(
     BuildWeightMatrix(D, weights);
 
     // call the other weak learner and train the labels.
-    WeakLearner w(other, tempData, weights, labels);
-    w.Classify(tempData, predictedLabels);
+    boost::shared_ptr<WeakLearner> w(new WeakLearner(
+        previous ? *previous : other, tempData, weights, labels));
+    ClassifyBlocks(*w, tempData, predictedLabels);
 
     // Now from predictedLabels, build ht, the weak hypothesis
     // buildClassificationMatrix(ht, predictedLabels);
 
-    // Now, start calculation of alpha(t) using ht
-
-    for (size_t j = 0;j < D.n_rows; j++) // instead of D, ht
+    // Now, start calculation of alpha(t) using ht.  The weight of each point
+    // (the sum of its row of D) is already in weights.
+    math::ParallelColumnReduce(0, D.n_rows, [&](const size_t begin,
+        const size_t end, double& blockRt)
     {
-      if (predictedLabels(j) == labels(j))
-      {
-        // for (int k = 0;k < numClasses; k++)
-        //   rt += D(j,k);
-        rt += arma::accu(D.row(j));
-      }
-
-      else
+      blockRt = 0.0;
+      for (size_t j = begin; j < end; j++)
       {
-        // for (int k = 0;k < numClasses; k++)
-        //   rt -= D(j,k);
-        rt -= arma::accu(D.row(j));
+        if (predictedLabels(j) == labels(j))
+          blockRt += weights(j);
+        else
+          blockRt -= weights(j);
       }
-    }
+    }, rt, blockSize);
     // end calculation of rt
 
     if (i > 0)
@@ -132,18 +134,25 @@ AdaBoost<MatType, WeakLearner>::AdaBoost(
     // end calculation of alphat
 
     alpha.push_back(alphat);
-    wl.push_back(w);
-
-    // now start modifying weights
-    for (size_t j = 0;j < D.n_rows; j++)
+    wl.push_back(*w);
+    previous = w;
+
+    // now start modifying weights.  Each point (row of D) is updated
+    // independently, so the points are split between threads, and zt is
+    // summed over the blocks.
+    const double expo = exp(alphat);
+    math::ParallelColumnReduce(0, D.n_rows, [&](const size_t begin,
+        const size_t end, double& blockZt)
     {
-      double expo = exp(alphat);
-      if (predictedLabels(j) == labels(j))
+      blockZt = 0.0;
+      for (size_t j = begin; j < end; j++)
       {
+        if (predictedLabels(j) == labels(j))
+        {
           for (size_t k = 0;k < D.n_cols; k++)
           {
             // we calculate zt, the normalization constant
-            zt += D(j,k) / expo; // * exp(-1 * alphat * yt(j,k) * ht(j,k));
+            blockZt += D(j,k) / expo; // * exp(-1 * alphat * yt(j,k) * ht(j,k));
             D(j,k) = D(j,k) / expo;
 
             // adding to the matrix of FinalHypothesis
@@ -153,13 +162,13 @@ AdaBoost<MatType, WeakLearner>::AdaBoost(
             else
               sumFinalH(j,k) -= (alphat);
           }
-      }
-      else
-      {
-        for (size_t k = 0;k < D.n_cols; k++)
+        }
+        else
+        {
+          for (size_t k = 0;k < D.n_cols; k++)
           {
             // we calculate zt, the normalization constant
-            zt += D(j,k) * expo;
+            blockZt += D(j,k) * expo;
             D(j,k) = D(j,k) * expo;
 
             // adding to the matrix of FinalHypothesis
@@ -168,11 +177,14 @@ AdaBoost<MatType, WeakLearner>::AdaBoost(
             else
               sumFinalH(j,k) -= (alphat);
           }
+        }
       }
-    }
+    }, zt, blockSize);
 
     // normalization of D
-    D = D / zt;
+    #pragma omp parallel for schedule(static)
+    for (size_t j = 0; j < D.n_elem; j++)
+      D[j] /= zt;
 
     // Accumulating the value of zt for the Hamming Loss bound.
     ztProduct *= zt;
@@ -181,14 +193,13 @@ AdaBoost<MatType, WeakLearner>::AdaBoost(
   // Iterations are over, now build a strong hypothesis
   // from a weighted combination of these weak hypotheses.
 
-  arma::colvec tempSumFinalH;
-  arma::uword max_index;
-  arma::mat sfh = sumFinalH.t();
+  const arma::mat sfh = sumFinalH.t();
 
+  #pragma omp parallel for schedule(static)
   for (size_t i = 0;i < sfh.n_cols; i++)
   {
-    tempSumFinalH = sfh.col(i);
-    tempSumFinalH.max(max_index);
+    arma::uword max_index;
+    sfh.unsafe_col(i).max(max_index);
     finalH(i) = max_index;
   }
   finalHypothesis = finalH;
@@ -205,28 +216,74 @@ void AdaBoost<MatType, WeakLearner>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(predictedLabels.n_cols);
-  arma::mat cMatrix(numClasses, test.n_cols);
+  predictedLabels.set_size(test.n_cols);
+
+  // Each block of test points is classified by the whole ensemble at once, so
+  // the votes for the block stay in cache.  The blocks are independent, so
+  // they are classified in parallel.
+  const size_t numBlocks = (test.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < numBlocks; b++)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) test.n_cols);
 
-  cMatrix.zeros();
-  predictedLabels.zeros();
+    // Use the memory of the test points without copying.
+    const MatType block(const_cast<typename MatType::elem_type*>(
+        test.colptr(begin)), test.n_rows, end - begin, false, true);
 
-  for (size_t i = 0;i < wl.size(); i++)
-  {
-    wl[i].Classify(test, tempPredictedLabels);
+    arma::Row<size_t> tempPredictedLabels(end - begin);
+    arma::mat cMatrix(numClasses, end - begin);
+    cMatrix.zeros();
+
+    for (size_t i = 0;i < wl.size(); i++)
+    {
+      wl[i].Classify(block, tempPredictedLabels);
+
+      for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
+        cMatrix(tempPredictedLabels(j), j) +=
+            (alpha[i] * tempPredictedLabels(j));
+    }
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
-      cMatrix(tempPredictedLabels(j), j) += (alpha[i] * tempPredictedLabels(j));
+    arma::uword max_index;
+    for (size_t i = 0; i < cMatrix.n_cols; i++)
+    {
+      cMatrix.unsafe_col(i).max(max_index);
+      predictedLabels(begin + i) = max_index;
+    }
   }
-  
-  arma::colvec cMRow;
-  arma::uword max_index;
+}
 
-  for (size_t i = 0; i < predictedLabels.n_cols; i++)
+/**
+ * Classify the given points with the given weak learner, splitting the points
+ * into blocks which are classified in parallel.
+ *
+ * @param learner Weak learner to classify with.
+ * @param data Points to classify.
+ * @param predictedLabels Vector to store the predicted labels in.
+ */
+template <typename MatType, typename WeakLearner>
+void AdaBoost<MatType, WeakLearner>::ClassifyBlocks(
+    WeakLearner& learner,
+    const MatType& data,
+    arma::Row<size_t>& predictedLabels)
+{
+  predictedLabels.set_size(data.n_cols);
+
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < numBlocks; b++)
   {
-    cMRow = cMatrix.col(i);
-    cMRow.max(max_index);
-    predictedLabels(i) = max_index;
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+
+    // Use the memory of the points without copying.
+    const MatType block(const_cast<typename MatType::elem_type*>(
+        data.colptr(begin)), data.n_rows, end - begin, false, true);
+
+    arma::Row<size_t> blockLabels(end - begin);
+    learner.Classify(block, blockLabels);
+    predictedLabels.subvec(begin, end - 1) = blockLabels;
   }
 }
 
@@ -244,14 +301,7 @@ void AdaBoost<MatType, WeakLearner>::BuildWeightMatrix(
     const arma::mat& D,
     arma::rowvec& weights)
 {
-  size_t i, j;
-  weights.fill(0.0);
-
-  for (i = 0; i < D.n_rows; i++)
-  {
-    for (j = 0; j < D.n_cols; j++)
-      weights(i) += D(i, j);
-  }
+  weights = arma::trans(arma::sum(D, 1));
 }
 
 } // namespace adaboost
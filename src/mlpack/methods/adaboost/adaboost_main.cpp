@@ -51,7 +51,14 @@ PROGRAM_INFO("AdaBoost","This program implements the AdaBoost (or Adaptive Boost
  "\n"
  "A test file is given through the --test_file (-T) parameter.  The "
  "predicted labels for the test set will be stored in the file specified by "
- "the --output_file (-o) parameter.");
+ "the --output_file (-o) parameter."
+ "\n\n"
+ "The weak learner is chosen with --weak_learner (-w), and is either "
+ "'perceptron' or 'decision_stump'.  For large datasets, the decision stumps "
+ "can be trained on quantized data by giving a number of bins (at most 256) "
+ "with --bins (-B); each attribute is then divided into that many bins once, "
+ "and each round only considers splits at the edges of the bins, which takes "
+ "time linear in the number of points.");
 
 //necessary parameters
 PARAM_STRING_REQ("train_file", "A file containing the training set.", "t");
@@ -60,11 +67,17 @@ PARAM_STRING_REQ("labels_file", "A file containing labels for the training set."
 PARAM_STRING_REQ("test_file", "A file containing the test set.", "T");
 
 //optional parameters.
-PARAM_STRING("output", "The file in which the predicted labels for the test set"
-    " will be written.", "o", "output.csv");
+PARAM_STRING("output_file", "The file in which the predicted labels for the "
+    "test set will be written.", "o", "output.csv");
 PARAM_INT("iterations","The maximum number of boosting iterations "
   "to be run", "i", 1000);
 PARAM_DOUBLE("tolerance","The tolerance for change in values of rt","e",1e-10);
+PARAM_STRING("weak_learner", "The type of weak learner to use: 'perceptron' or "
+    "'decision_stump'.", "w", "perceptron");
+PARAM_INT("bucket_size", "The minimum number of training points in each "
+    "decision stump bucket.", "b", 6);
+PARAM_INT("bins", "If nonzero, quantize each attribute into this many bins "
+    "(at most 256) for training decision stumps.", "B", 0);
 
 int main(int argc, char *argv[])
 {
@@ -120,21 +133,54 @@ int main(int argc, char *argv[])
         << "must be the same as training data (" << trainingData.n_rows - 1
         << ")!" << std::endl;
   int iterations = CLI::GetParam<int>("iterations");
-  
-  // define your own weak learner, perceptron in this case.
-  // defining the number of iterations of the perceptron.
-  int iter = 400;
-  
-  perceptron::Perceptron<> p(trainingData, labels.t(), iter);
-  
-  Timer::Start("Training");
-  AdaBoost<> a(trainingData, labels.t(), iterations, tolerance, p);
-  Timer::Stop("Training");
 
+  const string weakLearner = CLI::GetParam<string>("weak_learner");
   Row<size_t> predictedLabels(testingData.n_cols);
-  Timer::Start("testing");
-  a.Classify(testingData, predictedLabels);
-  Timer::Stop("testing");
+  if (weakLearner == "perceptron")
+  {
+    // define your own weak learner, perceptron in this case.
+    // defining the number of iterations of the perceptron.
+    int iter = 400;
+
+    perceptron::Perceptron<> p(trainingData, labels.t(), iter);
+
+    Timer::Start("Training");
+    AdaBoost<> a(trainingData, labels.t(), iterations, tolerance, p);
+    Timer::Stop("Training");
+
+    Timer::Start("testing");
+    a.Classify(testingData, predictedLabels);
+    Timer::Stop("testing");
+  }
+  else if (weakLearner == "decision_stump")
+  {
+    if (CLI::GetParam<int>("bucket_size") <= 0)
+      Log::Fatal << "Bucket size (" << CLI::GetParam<int>("bucket_size")
+          << ") must be positive!" << endl;
+    if (CLI::GetParam<int>("bins") < 0 || CLI::GetParam<int>("bins") > 256)
+      Log::Fatal << "Number of bins (" << CLI::GetParam<int>("bins")
+          << ") must be between 0 and 256!" << endl;
+
+    const size_t bucketSize = CLI::GetParam<int>("bucket_size");
+    const size_t bins = CLI::GetParam<int>("bins");
+    const size_t numClasses = labels.max() + 1;
+
+    Timer::Start("Training");
+    decision_stump::DecisionStump<> ds(trainingData, labels.t(), numClasses,
+        bucketSize, bins);
+    AdaBoost<mat, decision_stump::DecisionStump<> > a(trainingData,
+        labels.t(), iterations, tolerance, ds);
+    Timer::Stop("Training");
+
+    Timer::Start("testing");
+    a.Classify(testingData, predictedLabels);
+    Timer::Stop("testing");
+  }
+  else
+  {
+    Log::Fatal << "Unknown weak learner '" << weakLearner << "'; must be "
+        << "'perceptron' or 'decision_stump'." << endl;
+  }
 
   vec results;
   data::RevertLabels(predictedLabels.t(), mappings, results);
@@ -20,6 +20,8 @@
 #include <mlpack/methods/amf/update_rules/svd_batch_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
 
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 
@@ -176,6 +178,29 @@ using SVDCompleteIncrementalFactorizer = amf::AMF<amf::SimpleToleranceTerminatio
                                                   amf::RandomInitialization,
                                                   amf::SVDCompleteIncrementalLearning<MatType> >;
 
+/**
+ * SVDParallelIncrementalFactorizer factorizes given matrix V into two matrices
+ * W and H by complete incremental gradient descent, with the scores split
+ * between threads and W and H updated without locking.
+ *
+ * @see SVDParallelIncrementalLearning
+ */
+template<class MatType>
+using SVDParallelIncrementalFactorizer = amf::AMF<amf::SimpleToleranceTermination<MatType>,
+                                                  amf::RandomInitialization,
+                                                  amf::SVDParallelIncrementalLearning>;
+
+/**
+ * WeightedALSFactorizer factorizes given matrix V into two matrices W and H by
+ * weighted alternating least squares, treating zeros in V as missing.
+ *
+ * @see WeightedALSUpdate
+ */
+template<class MatType>
+using WeightedALSFactorizer = amf::AMF<amf::SimpleToleranceTermination<MatType>,
+                                       amf::RandomInitialization,
+                                       amf::WeightedALSUpdate>;
+
 #else // #ifdef MLPACK_USE_CXX11
 
 /**
@@ -251,6 +276,51 @@ typedef amf::AMF<amf::SimpleToleranceTermination<arma::mat>,
                  amf::SVDCompleteIncrementalLearning<arma::mat> > 
         SVDCompleteIncrementalFactorizer;
 
+/**
+ * SparseSVDParallelIncrementalFactorizer factorizes given sparse matrix V into
+ * two matrices W and H by complete incremental gradient descent, with the
+ * scores split between threads and W and H updated without locking.
+ *
+ * @see SVDParallelIncrementalLearning
+ */
+typedef amf::AMF<amf::SimpleToleranceTermination<arma::sp_mat>,
+                 amf::RandomInitialization,
+                 amf::SVDParallelIncrementalLearning>
+        SparseSVDParallelIncrementalFactorizer;
+
+/**
+ * SVDParallelIncrementalFactorizer factorizes given matrix V into two matrices
+ * W and H by complete incremental gradient descent, with the scores split
+ * between threads and W and H updated without locking.
+ *
+ * @see SVDParallelIncrementalLearning
+ */
+typedef amf::AMF<amf::SimpleToleranceTermination<arma::mat>,
+                 amf::RandomInitialization,
+                 amf::SVDParallelIncrementalLearning>
+        SVDParallelIncrementalFactorizer;
+
+/**
+ * SparseWeightedALSFactorizer factorizes given sparse matrix V into two
+ * matrices W and H by weighted alternating least squares, treating zeros in V
+ * as missing.
+ *
+ * @see WeightedALSUpdate
+ */
+typedef amf::AMF<amf::SimpleToleranceTermination<arma::sp_mat>,
+                 amf::RandomInitialization,
+                 amf::WeightedALSUpdate> SparseWeightedALSFactorizer;
+
+/**
+ * WeightedALSFactorizer factorizes given matrix V into two matrices W and H by
+ * weighted alternating least squares, treating zeros in V as missing.
+ *
+ * @see WeightedALSUpdate
+ */
+typedef amf::AMF<amf::SimpleToleranceTermination<arma::mat>,
+                 amf::RandomInitialization,
+                 amf::WeightedALSUpdate> WeightedALSFactorizer;
+
 #endif // #ifdef MLPACK_USE_CXX11
 
 
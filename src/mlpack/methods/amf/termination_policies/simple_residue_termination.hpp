@@ -62,8 +62,12 @@ class SimpleResidueTermination
    */
   bool IsConverged(arma::mat& W, arma::mat& H)
   {
-    // Calculate the norm and compute the residue
-    const double norm = arma::norm(W * H, "fro");
+    // Calculate the norm and compute the residue.  Because
+    // ||WH||_F^2 = trace((W^T W)(H H^T)), the norm can be computed from two
+    // small r x r matrices without forming the (possibly huge) product W * H.
+    const double normSquared = arma::accu((arma::trans(W) * W) %
+        (H * arma::trans(H)));
+    const double norm = std::sqrt(std::max(normSquared, 0.0));
     residue = fabs(normOld - norm) / normOld;
 
     // Store the norm.
@@ -74,23 +74,26 @@ class SVDIncompleteIncrementalLearning
                       arma::mat& W,
                       const arma::mat& H)
   {
-    arma::mat deltaW(n, W.n_cols);
-    deltaW.zeros();
-    
+    // Each row of W is only updated from its own old value, so the update can
+    // be done in place instead of accumulating a full n x r deltaW.
+    arma::rowvec deltaW(W.n_cols);
+
     // iterate through all the rating by this user to update corresponding
     // item feature feature vector
     for(size_t i = 0;i < n;i++)
     {
+      deltaW.zeros();
+
       double val;
       // update only if the rating is non-zero
       if((val = V(i, currentUserIndex)) != 0)
-        deltaW.row(i) += (val - arma::dot(W.row(i), H.col(currentUserIndex))) *
+        deltaW += (val - arma::dot(W.row(i), H.col(currentUserIndex))) *
                                          arma::trans(H.col(currentUserIndex));
       // add regularization
-      if(kw != 0) deltaW.row(i) -= kw * W.row(i);
-    }
+      if(kw != 0) deltaW -= kw * W.row(i);
 
-    W += u*deltaW;
+      W.row(i) += u * deltaW;
+    }
   }
 
   /**
@@ -148,26 +151,29 @@ class SVDIncompleteIncrementalLearning
 //! TODO : Merge this template specialized function for sparse matrix using 
 //!        common row_col_iterator
 
-//! template specialiazed functions for sparse matrices
+//! template specialiazed functions for sparse matrices.  These only visit the
+//! stored nonzeros of the current user's column, and only touch the
+//! corresponding rows of W, so each update costs O(nnz(column) * r) instead of
+//! O(n * r).
 template<>
 inline void SVDIncompleteIncrementalLearning::
                                     WUpdate<arma::sp_mat>(const arma::sp_mat& V,
                                                           arma::mat& W,
                                                           const arma::mat& H)
 {
-  arma::mat deltaW(n, W.n_cols);
-  deltaW.zeros();
+  arma::rowvec deltaW(W.n_cols);
   for(arma::sp_mat::const_iterator it = V.begin_col(currentUserIndex);
                                       it != V.end_col(currentUserIndex);it++)
   {
-    double val = *it;
-    size_t i = it.row();
-    deltaW.row(i) += (val - arma::dot(W.row(i), H.col(currentUserIndex))) *
+    const size_t i = it.row();
+    deltaW = (*it - arma::dot(W.row(i), H.col(currentUserIndex))) *
                                          arma::trans(H.col(currentUserIndex));
-    if(kw != 0) deltaW.row(i) -= kw * W.row(i);
-  }
+    if(kw != 0) deltaW -= kw * W.row(i);
 
-  W += u*deltaW;
+    // Each row appears only once in the column, so it is safe to update it in
+    // place.
+    W.row(i) += u * deltaW;
+  }
 }
 
 template<>
@@ -176,16 +182,14 @@ inline void SVDIncompleteIncrementalLearning::
                                                     const arma::mat& W,
                                                     arma::mat& H)
 {
-  arma::mat deltaH(H.n_rows, 1);
+  arma::vec deltaH(H.n_rows);
   deltaH.zeros();
 
   for(arma::sp_mat::const_iterator it = V.begin_col(currentUserIndex);
                                         it != V.end_col(currentUserIndex);it++)
   {
-    double val = *it;
-    size_t i = it.row();
-    if((val = V(i, currentUserIndex)) != 0)
-      deltaH += (val - arma::dot(W.row(i), H.col(currentUserIndex))) *
+    const size_t i = it.row();
+    deltaH += (*it - arma::dot(W.row(i), H.col(currentUserIndex))) *
                                                     arma::trans(W.row(i));
   }
   if(kh != 0) deltaH -= kh * H.col(currentUserIndex);
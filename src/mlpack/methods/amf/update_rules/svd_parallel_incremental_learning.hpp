@@ -0,0 +1,151 @@
+/**
+ * @file svd_parallel_incremental_learning.hpp
+ *
+ * Lock-free parallel SVD factorizer used in AMF (Alternating Matrix
+ * Factorization).
+ */
+#ifndef __MLPACK_METHODS_AMF_UPDATE_RULES_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+#define __MLPACK_METHODS_AMF_UPDATE_RULES_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class computes SVD by complete incremental learning (one update per
+ * score, as in SVDCompleteIncrementalLearning), with the scores split between
+ * all of the available OpenMP threads in the style of Hogwild!.  Each thread
+ * takes a set of users (columns of V); the feature vector of a user (a column
+ * of H) is only ever touched by the thread that owns the user, while the item
+ * feature vectors (rows of W) are shared and updated without locking.  Since
+ * each score only touches one row of W, conflicting writes are rare and do not
+ * noticeably slow convergence.
+ *
+ * One call to WUpdate() makes a full pass over all of the scores and updates
+ * both W and H; HUpdate() does nothing.  This means that one iteration of AMF
+ * is one pass over the data, so this rule should be used with a termination
+ * policy that checks the whole matrix, such as SimpleToleranceTermination.
+ *
+ * When more than one thread is used, results are not bitwise reproducible.
+ *
+ * @see SVDCompleteIncrementalLearning
+ */
+class SVDParallelIncrementalLearning
+{
+ public:
+  /**
+   * Empty constructor
+   *
+   * @param u step value used in learning
+   * @param kw regularization constant for W matrix
+   * @param kh regularization constant for H matrix
+   */
+  SVDParallelIncrementalLearning(double u = 0.001,
+                                 double kw = 0,
+                                 double kh = 0)
+      : u(u), kw(kw), kh(kh)
+  {}
+
+  /**
+   * Initialize parameters before factorization.  Nothing needs to be done.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank rank of factorization
+   */
+  template<typename MatType>
+  void Initialize(const MatType& /* dataset */, const size_t /* rank */)
+  { }
+
+  /**
+   * Make one pass over all of the scores in V, updating both W and H.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& V,
+                      arma::mat& W,
+                      arma::mat& H)
+  {
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (size_t j = 0; j < V.n_cols; ++j)
+    {
+      for (size_t i = 0; i < V.n_rows; ++i)
+      {
+        const double val = V(i, j);
+        // update only if the rating is non-zero
+        if (val != 0)
+          Update(i, j, val, W, H);
+      }
+    }
+  }
+
+  /**
+   * H has already been updated by WUpdate(), so this does nothing.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& /* V */,
+                      const arma::mat& /* W */,
+                      arma::mat& /* H */)
+  { }
+
+ private:
+  //! step count of learning
+  double u;
+  //! regularization parameter for W matrix
+  double kw;
+  //! regularization parameter for H matrix
+  double kh;
+
+  /**
+   * Update row i of W and column j of H from the score V(i, j).  Both are
+   * updated from their old values.
+   */
+  inline void Update(const size_t i,
+                     const size_t j,
+                     const double val,
+                     arma::mat& W,
+                     arma::mat& H) const
+  {
+    double* h = H.colptr(j);
+
+    double error = val;
+    for (size_t k = 0; k < W.n_cols; ++k)
+      error -= W(i, k) * h[k];
+
+    for (size_t k = 0; k < W.n_cols; ++k)
+    {
+      const double w = W(i, k);
+      W(i, k) += u * (error * h[k] - kw * w);
+      h[k] += u * (error * w - kh * h[k]);
+    }
+  }
+};
+
+//! template specialized function for sparse matrices.  Only the stored
+//! nonzeros of each column are visited.
+template<>
+inline void SVDParallelIncrementalLearning::
+                                    WUpdate<arma::sp_mat>(const arma::sp_mat& V,
+                                                          arma::mat& W,
+                                                          arma::mat& H)
+{
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (size_t j = 0; j < V.n_cols; ++j)
+  {
+    for (arma::sp_mat::const_iterator it = V.begin_col(j);
+         it != V.end_col(j); ++it)
+      Update(it.row(), j, *it, W, H);
+  }
+}
+
+}; // namespace amf
+}; // namespace mlpack
+
+#endif
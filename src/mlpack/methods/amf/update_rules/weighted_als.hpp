@@ -0,0 +1,182 @@
+/**
+ * @file weighted_als.hpp
+ *
+ * Weighted alternating least squares update rule for AMF (Alternating Matrix
+ * Factorization), for matrices with missing entries.
+ */
+#ifndef __MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+#define __MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class implements weighted alternating least squares with weighted
+ * lambda regularization (ALS-WR), as described in the following paper:
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title={Large-scale parallel collaborative filtering for the Netflix prize},
+ *   author={Zhou, Yunhong and Wilkinson, Dennis and Schreiber, Robert and Pan,
+ *       Rong},
+ *   booktitle={Algorithmic Aspects in Information and Management},
+ *   pages={337--348},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Unlike NMFALSUpdate, which treats every zero in V as an observed zero and
+ * solves for all of W (or H) at once, zeros in V are treated as missing.  Each
+ * row i of W is then the solution of its own r x r system, over only the
+ * observed entries of row i of V:
+ *
+ * \f[
+ * (\sum_{j \in J_i} h_j h_j^T + \lambda n_i I) w_i = \sum_{j \in J_i} V_{ij} h_j
+ * \f]
+ *
+ * where \f$ J_i \f$ is the set of observed entries in row i and \f$ n_i = |J_i|
+ * \f$; each column of H is solved for in the same way.  The systems are
+ * independent, so they are split between all available OpenMP threads, and
+ * each one is solved with a Cholesky decomposition.  Rows and columns with no
+ * observed entries are set to zero.
+ *
+ * The observed entries are copied into sparse matrices (one in each
+ * orientation) in Initialize(), so the update costs are proportional to the
+ * number of observed entries whether V is dense or sparse.
+ */
+class WeightedALSUpdate
+{
+ public:
+  /**
+   * Construct the update rule with the given regularization parameter.
+   *
+   * @param lambda Regularization parameter; the penalty for each row is scaled
+   *     by its number of observed entries.
+   */
+  WeightedALSUpdate(const double lambda = 0.01) : lambda(lambda) { }
+
+  /**
+   * Initialize the update rule before factorization, by storing the observed
+   * entries of the dataset.  This must be called before a new factorization.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank rank of factorization
+   */
+  template<typename MatType>
+  void Initialize(const MatType& dataset, const size_t /* rank */)
+  {
+    ratings = arma::sp_mat(dataset);
+    ratingsTrans = arma::trans(ratings);
+  }
+
+  /**
+   * The update rule for the basis matrix W.  Each row of W is solved for
+   * independently, using the observed entries in that row of V.
+   *
+   * @param V Input matrix to be factorized (the copy stored by Initialize() is
+   *     used).
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& /* V */,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    arma::mat wTrans;
+    Solve(ratingsTrans, H, wTrans);
+    W = arma::trans(wTrans);
+  }
+
+  /**
+   * The update rule for the encoding matrix H.  Each column of H is solved for
+   * independently, using the observed entries in that column of V.
+   *
+   * @param V Input matrix to be factorized (the copy stored by Initialize() is
+   *     used).
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& /* V */,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    // Transpose W so that the rows are contiguous.
+    Solve(ratings, arma::trans(W), H);
+  }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+ private:
+  //! The regularization parameter.
+  double lambda;
+
+  //! The observed entries of the dataset.
+  arma::sp_mat ratings;
+  //! The observed entries of the dataset, transposed.
+  arma::sp_mat ratingsTrans;
+
+  /**
+   * For each column j of the given ratings, solve the regularized least squares
+   * system over the observed entries of that column, where the factor of each
+   * observed entry (i, j) is factors.col(i).  The solutions are stored in the
+   * columns of the output matrix.
+   */
+  void Solve(const arma::sp_mat& data,
+             const arma::mat& factors,
+             arma::mat& output) const
+  {
+    const size_t rank = factors.n_rows;
+    output.set_size(rank, data.n_cols);
+
+    #pragma omp parallel
+    {
+      arma::mat a(rank, rank);
+      arma::vec b(rank);
+      arma::mat r;
+
+      #pragma omp for schedule(dynamic, 32)
+      for (size_t j = 0; j < data.n_cols; ++j)
+      {
+        a.zeros();
+        b.zeros();
+        size_t count = 0;
+        for (arma::sp_mat::const_iterator it = data.begin_col(j);
+             it != data.end_col(j); ++it)
+        {
+          a += factors.col(it.row()) * arma::trans(factors.col(it.row()));
+          b += (*it) * factors.col(it.row());
+          ++count;
+        }
+
+        if (count == 0)
+        {
+          output.col(j).zeros();
+          continue;
+        }
+
+        a.diag() += lambda * count;
+
+        // a = r^T r, so solve the two triangular systems.  If a is singular
+        // (which can only happen when lambda is 0), fall back to the
+        // pseudoinverse.
+        if (arma::chol(r, a))
+          output.col(j) = arma::solve(arma::trimatu(r),
+              arma::solve(arma::trimatl(arma::trans(r)), b));
+        else
+          output.col(j) = arma::pinv(a) * b;
+      }
+    }
+  }
+}; // class WeightedALSUpdate
+
+}; // namespace amf
+}; // namespace mlpack
+
+#endif
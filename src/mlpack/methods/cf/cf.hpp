@@ -19,6 +19,7 @@
 #include <set>
 #include <map>
 #include <iostream>
+#include <algorithm>
 
 namespace mlpack {
 namespace cf /** Collaborative filtering. */ {
@@ -141,8 +142,15 @@ class CF
   const arma::mat& W() const { return w; }
   //! Get the Item Matrix.
   const arma::mat& H() const { return h; }
-  //! Get the Rating Matrix.
-  const arma::mat& Rating() const { return rating; }
+  //! Get the full (items x users) matrix of estimated ratings, W * H.  This
+  //! may be very large, and GetRecommendations() does not need it, so it is
+  //! only computed (once) when it is first requested.
+  const arma::mat& Rating() const
+  {
+    if (rating.n_elem == 0)
+      rating = w * h;
+    return rating;
+  }
   //! Get the cleaned data matrix.
   const arma::sp_mat& CleanedData() const { return cleanedData; }
 
@@ -157,6 +165,11 @@ class CF
 
   /**
    * Generates the given number of recommendations for the specified users.
+   * This works directly on the low-rank factors W and H, and never forms the
+   * full rating matrix: the neighborhood of each user is found in the latent
+   * space, and the items are scored in blocks, keeping only the best numRecs
+   * candidates for each user.  If OpenMP is available, blocks of users are
+   * processed in parallel.
    *
    * @param numRecs Number of Recommendations
    * @param recommendations Matrix to save recommendations
@@ -182,29 +195,13 @@ class CF
   arma::mat w;
   //! Item matrix.
   arma::mat h;
-  //! Rating matrix.
-  arma::mat rating;
+  //! Rating matrix (W * H); empty until Rating() is called.
+  mutable arma::mat rating;
   //! Cleaned data matrix.
   arma::sp_mat cleanedData;
   //! Converts the User, Item, Value Matrix to User-Item Table
   void CleanData(const arma::mat& data);
 
-  /**
-   * Helper function to insert a point into the recommendation matrices.
-   *
-   * @param queryIndex Index of point whose recommendations we are inserting
-   *     into.
-   * @param pos Position in list to insert into.
-   * @param neighbor Index of item being inserted as a recommendation.
-   * @param value Value of recommendation.
-   */
-  void InsertNeighbor(const size_t queryIndex,
-                      const size_t pos,
-                      const size_t neighbor,
-                      const double value,
-                      arma::Mat<size_t>& recommendations,
-                      arma::mat& values) const;
-
 }; // class CF
 
 }; // namespace cf
@@ -111,86 +111,166 @@ void CF<FactorizerType>::GetRecommendations(const size_t numRecs,
   GetRecommendations(numRecs, recommendations, users);
 }
 
+/**
+ * For ordering candidate recommendations: a candidate is better than another if
+ * its estimated rating is higher, or if the ratings are equal and its item
+ * index is lower.  Used with the std heap functions, this keeps the worst
+ * candidate at the top of the heap.
+ */
+struct CandidateComparator
+{
+  bool operator()(const std::pair<double, size_t>& a,
+                  const std::pair<double, size_t>& b) const
+  {
+    return (a.first > b.first) || ((a.first == b.first) &&
+        (a.second < b.second));
+  }
+};
+
 template<typename FactorizerType>
 void CF<FactorizerType>::GetRecommendations(const size_t numRecs,
                                             arma::Mat<size_t>& recommendations,
                                             arma::Col<size_t>& users)
 {
-  // Generate new table by multiplying approximate values.
-  rating = w * h;
+  // We never form the full rating matrix W * H (which is items x users, and
+  // may not fit in memory); instead, we work with the factors directly.
+
+  // The neighborhood of a user is the set of users whose estimated ratings are
+  // closest in Euclidean distance, and
+  //   || W h_a - W h_b ||^2 = (h_a - h_b)^T (W^T W) (h_a - h_b).
+  // So if W^T W = V D V^T, that distance is the same as the distance between
+  // D^(1/2) V^T h_a and D^(1/2) V^T h_b, and the neighbor search can be done in
+  // the (rank-dimensional) latent space.
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  arma::eig_sym(eigenvalues, eigenvectors, trans(w) * w);
+  for (size_t i = 0; i < eigenvalues.n_elem; ++i)
+    eigenvalues[i] = (eigenvalues[i] > 0.0) ? std::sqrt(eigenvalues[i]) : 0.0;
 
-  // Now, we will use the decomposed w and h matrices to estimate what the user
-  // would have rated items as, and then pick the best items.
+  arma::mat latentUsers = arma::diagmat(eigenvalues) * trans(eigenvectors) * h;
 
   // Temporarily store feature vector of queried users.
-  arma::mat query(rating.n_rows, users.n_elem);
+  arma::mat query(latentUsers.n_rows, users.n_elem);
 
   // Select feature vectors of queried users.
   for (size_t i = 0; i < users.n_elem; i++)
-    query.col(i) = rating.col(users(i));
+    query.col(i) = latentUsers.col(users(i));
 
   // Temporary storage for neighborhood of the queried users.
   arma::Mat<size_t> neighborhood;
 
   // Calculate the neighborhood of the queried users.
   // This should be a templatized option.
-  neighbor::AllkNN a(rating, query);
+  neighbor::AllkNN a(latentUsers, query);
   arma::mat resultingDistances; // Temporary storage.
   a.Search(numUsersForSimilarity, neighborhood, resultingDistances);
 
-  // Temporary storage for storing the average rating for each user in their
-  // neighborhood.
-  arma::mat averages = arma::zeros<arma::mat>(rating.n_rows, query.n_cols);
+  // The average of the estimated ratings of the neighborhood is W times the
+  // average of the neighbors' columns of H, so we only store the latter.
+  arma::mat averages = arma::zeros<arma::mat>(h.n_rows, users.n_elem);
 
   // Iterate over each query user.
   for (size_t i = 0; i < neighborhood.n_cols; ++i)
   {
     // Iterate over each neighbor of the query user.
     for (size_t j = 0; j < neighborhood.n_rows; ++j)
-      averages.col(i) += rating.col(neighborhood(j, i));
+      averages.col(i) += h.col(neighborhood(j, i));
     // Normalize average.
     averages.col(i) /= neighborhood.n_rows;
   }
 
-  // Generate recommendations for each query user by finding the maximum numRecs
-  // elements in the averages matrix.
+  // Generate recommendations for each query user by finding the numRecs items
+  // with the highest estimated rating.  The estimated ratings are computed for
+  // a block of users and a block of items at a time, so only a small piece of
+  // the rating matrix exists at once; each user keeps a bounded heap of the
+  // best candidates.  Blocks of users are processed in parallel.
   recommendations.set_size(numRecs, users.n_elem);
   recommendations.fill(cleanedData.n_rows); // Invalid item number.
-  arma::mat values(numRecs, users.n_elem);
-  values.fill(-DBL_MAX); // The smallest possible value.
-  for (size_t i = 0; i < users.n_elem; i++)
+
+  const arma::sp_mat& data = cleanedData;
+  const size_t userBlockSize = 64;
+  const size_t itemBlockSize = 4096;
+  const size_t numUserBlocks = (users.n_elem + userBlockSize - 1) /
+      userBlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t block = 0; block < numUserBlocks; ++block)
   {
-    // Look through the averages column corresponding to the current user.
-    for (size_t j = 0; j < averages.n_rows; ++j)
+    typedef std::pair<double, size_t> Candidate;
+    const size_t userBegin = block * userBlockSize;
+    const size_t userEnd = std::min(userBegin + userBlockSize,
+        (size_t) users.n_elem);
+    const size_t blockUsers = userEnd - userBegin;
+
+    // For each user, the (sorted) items they have rated, and how far into that
+    // list we have gotten.
+    std::vector<std::vector<size_t> > ratedItems(blockUsers);
+    std::vector<size_t> ratedPositions(blockUsers, 0);
+    std::vector<std::vector<Candidate> > heaps(blockUsers);
+    for (size_t u = 0; u < blockUsers; ++u)
+    {
+      for (arma::sp_mat::const_iterator it = data.begin_col(users(userBegin +
+          u)); it != data.end_col(users(userBegin + u)); ++it)
+        ratedItems[u].push_back(it.row());
+
+      heaps[u].reserve(numRecs);
+    }
+
+    for (size_t itemBegin = 0; itemBegin < w.n_rows; itemBegin += itemBlockSize)
     {
-      // Ensure that the user hasn't already rated the item.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
+      const size_t itemEnd = std::min(itemBegin + itemBlockSize,
+          (size_t) w.n_rows);
+      const arma::mat ratings = w.rows(itemBegin, itemEnd - 1) *
+          averages.cols(userBegin, userEnd - 1);
 
-      // Is the estimated value better than the worst candidate?
-      const double value = averages(j, i);
-      if (value > values(values.n_rows - 1, i))
+      for (size_t u = 0; u < blockUsers; ++u)
       {
-        // It should be inserted.  Which position?
-        size_t insertPosition = values.n_rows - 1;
-        while (insertPosition > 0)
+        std::vector<Candidate>& heap = heaps[u];
+        const std::vector<size_t>& rated = ratedItems[u];
+        size_t& ratedPosition = ratedPositions[u];
+
+        for (size_t j = itemBegin; j < itemEnd; ++j)
         {
-          if (value <= values(insertPosition - 1, i))
-            break; // The current value is the right one.
-          insertPosition--;
-        }
+          // Ensure that the user hasn't already rated the item.
+          while ((ratedPosition < rated.size()) && (rated[ratedPosition] < j))
+            ++ratedPosition;
+          if ((ratedPosition < rated.size()) && (rated[ratedPosition] == j))
+            continue; // The user already rated the item.
 
-        // Now insert it into the list.
-        InsertNeighbor(i, insertPosition, j, value, recommendations,
-            values);
+          const Candidate candidate(ratings(j - itemBegin, u), j);
+          if (heap.size() < numRecs)
+          {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end(), CandidateComparator());
+          }
+          else if (CandidateComparator()(candidate, heap.front()))
+          {
+            // It is better than the worst candidate, so replace that one.
+            std::pop_heap(heap.begin(), heap.end(), CandidateComparator());
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end(), CandidateComparator());
+          }
+        }
       }
     }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(values.n_rows - 1, i) == cleanedData.n_rows + 1)
-      Log::Warn << "Could not provide " << values.n_rows << " recommendations "
-          << "for user " << users(i) << " (not enough un-rated items)!" << std::endl;
+    // Sorting with the comparator puts the best candidates first.
+    for (size_t u = 0; u < blockUsers; ++u)
+    {
+      std::sort(heaps[u].begin(), heaps[u].end(), CandidateComparator());
+      for (size_t k = 0; k < heaps[u].size(); ++k)
+        recommendations(k, userBegin + u) = heaps[u][k].second;
+    }
+  }
+
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (numRecs > 0 && recommendations(numRecs - 1, i) == cleanedData.n_rows)
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << users(i) << " (not enough un-rated items)!"
+          << std::endl;
   }
 }
 
@@ -217,39 +297,6 @@ void CF<FactorizerType>::CleanData(const arma::mat& data)
   cleanedData = arma::sp_mat(locations, values, maxItemID, maxUserID);
 }
 
-/**
- * Helper function to insert a point into the recommendation matrices.
- *
- * @param queryIndex Index of point whose recommendations we are inserting into.
- * @param pos Position in list to insert into.
- * @param neighbor Index of item being inserted as a recommendation.
- * @param value Value of recommendation.
- */
-template<typename FactorizerType>
-void CF<FactorizerType>::InsertNeighbor(const size_t queryIndex,
-                                        const size_t pos,
-                                        const size_t neighbor,
-                                        const double value,
-                                        arma::Mat<size_t>& recommendations,
-                                        arma::mat& values) const
-{
-  // We only memmove() if there is actually a need to shift something.
-  if (pos < (recommendations.n_rows - 1))
-  {
-    const int len = (values.n_rows - 1) - pos;
-    memmove(values.colptr(queryIndex) + (pos + 1),
-        values.colptr(queryIndex) + pos,
-        sizeof(double) * len);
-    memmove(recommendations.colptr(queryIndex) + (pos + 1),
-        recommendations.colptr(queryIndex) + pos,
-        sizeof(size_t) * len);
-  }
-
-  // Now put the new information in the right index.
-  values(pos, queryIndex) = value;
-  recommendations(pos, queryIndex) = neighbor;
-}
-
 // Return string of object.
 template<typename FactorizerType>
 std::string CF<FactorizerType>::ToString() const
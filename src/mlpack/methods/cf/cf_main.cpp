@@ -39,7 +39,13 @@ PROGRAM_INFO("Collaborating Filtering", "This program performs collaborative "
     "The following optimization algorithms can be used with --algorithm (-a) "
     "parameter: "
     "\n"
-    "RegSVD -- Regularized SVD using a SGD optimizer ");
+    "RegSVD -- Regularized SVD using a SGD optimizer "
+    "\n"
+    "RegSVDParallel -- Regularized SVD using a lock-free parallel SGD optimizer "
+    "\n"
+    "SVDParallelIncremental -- SVD by incremental learning on all threads "
+    "\n"
+    "WeightedALS -- Weighted alternating least squares on observed ratings ");
 
 // Parameters for program.
 PARAM_STRING_REQ("input_file", "Input dataset to perform CF on.", "i");
@@ -68,7 +74,11 @@ void ComputeRecommendations(Factorizer factorizer,
                             const size_t rank,
                             arma::Mat<size_t>& recommendations)
 {
+  // Time the factorization separately, so that the factorizers can be
+  // compared.
+  Timer::Start("factorization");
   CF<Factorizer> c(dataset, factorizer, neighbourhood, rank);
+  Timer::Stop("factorization");
 
   // Reading users.
   const string queryFile = CLI::GetParam<string>("query_file");
@@ -126,6 +136,12 @@ int main(int argc, char** argv)
     CR(SparseSVDCompleteIncrementalFactorizer());
   else if(algo == "RegSVD")
     CR(RegularizedSVD<>());
+  else if(algo == "RegSVDParallel")
+    CR(RegularizedSVD<optimization::ParallelSGD>());
+  else if(algo == "SVDParallelIncremental")
+    CR(SparseSVDParallelIncrementalFactorizer());
+  else if(algo == "WeightedALS")
+    CR(SparseWeightedALSFactorizer());
 
   const string outputFile = CLI::GetParam<string>("output_file");
   data::Save(outputFile, recommendations);
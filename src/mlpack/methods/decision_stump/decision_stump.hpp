@@ -8,6 +8,7 @@
 #define __MLPACK_METHODS_DECISION_STUMP_DECISION_STUMP_HPP
 
 #include <mlpack/core.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace mlpack {
 namespace decision_stump {
@@ -23,6 +24,27 @@ namespace decision_stump {
  * last bin has range up to \infty (split[i + 1] does not exist in that case).
  * Points that are below the first bin will take the label of the first bin.
  *
+ * Training needs the points in sorted order along each attribute.  A stump
+ * trained with the constructor that takes another stump and a weight vector
+ * reuses the sort order computed by that stump, if it was trained on the same
+ * data, and keeps it so the next stump can reuse it too.  So, when boosting,
+ * each round only takes time linear in the size of the data, instead of sorting
+ * every attribute again.  The sort order is not kept by a stump trained without
+ * weights, and is never carried by copies of a stump, so the stumps stored by
+ * AdaBoost do not hold it.  The attributes are evaluated in parallel, if OpenMP
+ * is available.
+ *
+ * For large datasets, the stump can instead be trained on quantized data, by
+ * passing a number of bins (at most 256) to the constructor.  Each attribute is
+ * then divided into that many bins at quantiles of its values (estimated from
+ * a subsample of the points), and the bin of every point is stored in one byte.
+ * Splits are only considered at the edges of the bins: for each attribute, a
+ * histogram of the (weighted) labels in each bin is built in one pass over the
+ * points, and the consecutive bins are grouped into buckets of at least
+ * inpBucketSize points.  This takes time linear in the number of points and
+ * needs no sorting, at the cost of an approximate split.  The bins are reused
+ * between stumps in the same way as the sort order.
+ *
  * @tparam MatType Type of matrix that is being used (sparse or dense).
  */
 template <typename MatType = arma::mat>
@@ -37,11 +59,14 @@ class DecisionStump
    * @param labels Labels of training data.
    * @param classes Number of distinct classes in labels.
    * @param inpBucketSize Minimum size of bucket when splitting.
+   * @param bins Number of bins to quantize each attribute into, or 0 to find
+   *     the exact best split.
    */
   DecisionStump(const MatType& data,
                 const arma::Row<size_t>& labels,
                 const size_t classes,
-                size_t inpBucketSize);
+                size_t inpBucketSize,
+                const size_t bins = 0);
 
   /**
    * Classification function. After training, classify test, and put the
@@ -85,6 +110,10 @@ class DecisionStump
   //! Modify the labels for each split bin (be careful!).
   arma::Col<size_t>& BinLabels() { return binLabels; }
 
+  //! Get the number of bins each attribute is quantized into (0 if the data
+  //! is not quantized).
+  size_t Bins() const { return bins; }
+
  private:
   //! Stores the number of classes.
   size_t numClass;
@@ -101,16 +130,114 @@ class DecisionStump
   //! Stores the labels for each splitting bin.
   arma::Col<size_t> binLabels;
 
+  //! Number of bins to quantize each attribute into (0 for exact splits).
+  size_t bins;
+
+  //! The training data, quantized into bins.
+  struct BinnedData
+  {
+    //! Bin of each point along each attribute (one column for each
+    //! attribute).
+    arma::Mat<unsigned char> bin;
+    //! The edges between the bins of each attribute; bin b of attribute i
+    //! holds the values in [edges[i][b - 1], edges[i][b]).
+    std::vector<arma::vec> edges;
+  };
+
+  //! What is computed from the training data to train the stump, and can be
+  //! reused by the next stump trained on the same data.  Copies of a stump
+  //! start with an empty cache, so only the stump being trained holds it.
+  struct TrainingCache
+  {
+    TrainingCache() { }
+    TrainingCache(const TrainingCache& /* other */) { }
+    TrainingCache& operator=(const TrainingCache& /* other */)
+    {
+      Release();
+      return *this;
+    }
+
+    //! Release the cached data.
+    void Release()
+    {
+      binnedData.reset();
+      sortedIndices.reset();
+    }
+
+    //! The quantized training data, if bins is nonzero.
+    boost::shared_ptr<BinnedData> binnedData;
+    //! Indices of the training points in sorted order along each attribute
+    //! (one column for each attribute), if bins is zero.
+    boost::shared_ptr<arma::umat> sortedIndices;
+  };
+
+  //! The cached training data.
+  TrainingCache cache;
+
+  /**
+   * Compute the (stable) sort order of the points along each attribute of the
+   * given data, and store it in the cache.
+   *
+   * @param data Dataset to sort.
+   */
+  void Presort(const MatType& data);
+
+  /**
+   * Return whether or not the cache holds the stable sort order of the given
+   * data.  This takes time linear in the size of the data.
+   *
+   * @param data Dataset to check the sort order against.
+   */
+  bool PresortMatches(const MatType& data) const;
+
+  /**
+   * Quantize each attribute of the given data into bins, and store the result
+   * in the cache.
+   *
+   * @param data Dataset to quantize.
+   */
+  void Quantize(const MatType& data);
+
+  /**
+   * Return whether or not the cache holds the bins of the given data.  This
+   * takes time linear in the size of the data.
+   *
+   * @param data Dataset to check the bins against.
+   */
+  bool QuantizationMatches(const MatType& data) const;
+
+  /**
+   * Group the bins of an attribute into buckets of consecutive bins holding
+   * at least bucketSize points (unless there is only one bucket).
+   *
+   * @param binCounts Number of points in each bin.
+   * @param bucketStarts Vector to store the first bin of each bucket in.
+   */
+  void GroupBins(const arma::Col<size_t>& binCounts,
+                 std::vector<size_t>& bucketStarts) const;
+
+  /**
+   * Train the decision stump on the quantized data, splitting only at the
+   * edges of the bins.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for dataset.
+   * @param isWeight Whether we need to run a weighted Decision Stump.
+   */
+  template <bool isWeight>
+  void TrainBinned(const MatType& data, const arma::Row<size_t>& labels,
+                   const arma::rowvec& weightD);
+
   /**
    * Sets up attribute as if it were splitting on it and finds entropy when
    * splitting on attribute.
    *
-   * @param attribute A row from the training data, which might be a
-   *     candidate for the splitting attribute.
+   * @param sortedIndex Indices of the points in sorted order along the
+   *     attribute which might be a candidate for the splitting attribute.
    * @param isWeight Whether we need to run a weighted Decision Stump.
    */
   template <bool isWeight>
-  double SetupSplitAttribute(const arma::rowvec& attribute,
+  double SetupSplitAttribute(const arma::uvec& sortedIndex,
                              const arma::Row<size_t>& labels,
                              const arma::rowvec& weightD);
 
@@ -120,8 +247,11 @@ class DecisionStump
    *
    * @param attribute attribute is the attribute decided by the constructor
    *      on which we now train the decision stump.
+   * @param sortedIndex Indices of the points in sorted order along the
+   *      attribute.
    */
   template <typename rType> void TrainOnAtt(const arma::rowvec& attribute,
+                                            const arma::uvec& sortedIndex,
                                             const arma::Row<size_t>& labels);
 
   /**
@@ -139,13 +269,6 @@ class DecisionStump
   template <typename rType> rType CountMostFreq(const arma::Row<rType>&
       subCols);
 
-  /**
-   * Returns 1 if all the values of featureRow are not same.
-   *
-   * @param featureRow The attribute which is checked for identical values.
-   */
-  template <typename rType> int IsDistinct(const arma::Row<rType>& featureRow);
-
   /**
    * Calculate the entropy of the given attribute.
    *
@@ -21,19 +21,40 @@ namespace decision_stump {
  * @param labels Labels of data.
  * @param classes Number of distinct classes in labels.
  * @param inpBucketSize Minimum size of bucket when splitting.
+ * @param bins Number of bins to quantize each attribute into, or 0 to find the
+ *      exact best split.
  */
 template<typename MatType>
 DecisionStump<MatType>::DecisionStump(const MatType& data,
                                       const arma::Row<size_t>& labels,
                                       const size_t classes,
-                                      size_t inpBucketSize)
+                                      size_t inpBucketSize,
+                                      const size_t bins) :
+    bins(bins)
 {
   numClass = classes;
   bucketSize = inpBucketSize;
 
+  if (bins > 256)
+    Log::Fatal << "DecisionStump::DecisionStump(): number of bins (" << bins
+        << ") must be at most 256!" << std::endl;
+
   arma::rowvec weightD;
 
-  Train<false>(data, labels, weightD);
+  if (bins > 0)
+  {
+    Quantize(data);
+    TrainBinned<false>(data, labels, weightD);
+  }
+  else
+  {
+    Presort(data);
+    Train<false>(data, labels, weightD);
+  }
+
+  // Nothing will be trained from this stump on the same data with this cache,
+  // so don't hold on to it.
+  cache.Release();
 }
 
 /**
@@ -50,21 +71,36 @@ void DecisionStump<MatType>::Train(const MatType& data, const arma::Row<size_t>&
 {
   // If classLabels are not all identical, proceed with training.
   int bestAtt = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<size_t, isWeight>(
       labels.subvec(0, labels.n_elem - 1), 0, weightD);
 
+  // The entropy of splitting on each attribute is independent of the others,
+  // so the attributes are evaluated in parallel.
+  const arma::umat& order = *cache.sortedIndices;
+  arma::vec entropies(data.n_rows);
+  arma::uvec distinct(data.n_rows);
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    // An attribute has non-identical values if its smallest and largest values
+    // differ.
+    distinct[i] = (data(i, order(0, i)) != data(i, order(data.n_cols - 1, i)));
+
+    // For each attribute with non-identical values, treat it as a potential
+    // splitting attribute and calculate entropy if split on it.
+    if (distinct[i])
+      entropies[i] = SetupSplitAttribute<isWeight>(order.unsafe_col(i), labels,
+          weightD);
+  }
+
+  // Now pick the best attribute, in order, so that ties are broken the same
+  // way regardless of the number of threads.
   double gain, bestGain = 0.0;
   for (size_t i = 0; i < data.n_rows; i++)
   {
-    // Go through each attribute of the data.
-    if (IsDistinct<double>(data.row(i)))
+    if (distinct[i])
     {
-      // For each attribute with non-identical values, treat it as a potential
-      // splitting attribute and calculate entropy if split on it.
-      entropy = SetupSplitAttribute<isWeight>(data.row(i), labels, weightD);
-
-      gain = rootEntropy - entropy;
+      gain = rootEntropy - entropies[i];
       // Find the attribute with the best entropy so that the gain is
       // maximized.
 
@@ -81,7 +117,8 @@ void DecisionStump<MatType>::Train(const MatType& data, const arma::Row<size_t>&
   splitAttribute = bestAtt;
 
   // Once the splitting column/attribute has been decided, train on it.
-  TrainOnAtt<double>(data.row(splitAttribute), labels);
+  TrainOnAtt<double>(data.row(splitAttribute), order.unsafe_col(splitAttribute),
+      labels);
 }
 
 /**
@@ -138,49 +175,359 @@ DecisionStump<MatType>::DecisionStump(
 {
   numClass = other.numClass;
   bucketSize = other.bucketSize;
+  bins = other.bins;
+
+  // Boosting trains many stumps on the same data, so reuse the sort order (or
+  // the bins) of the other stump if it was trained on this data, and keep it
+  // for the stump trained from this one.
+  if (bins > 0)
+  {
+    if (other.QuantizationMatches(data))
+      cache.binnedData = other.cache.binnedData;
+    else
+      Quantize(data);
+
+    TrainBinned<true>(data, labels, weights);
+  }
+  else
+  {
+    if (other.PresortMatches(data))
+      cache.sortedIndices = other.cache.sortedIndices;
+    else
+      Presort(data);
+
+    Train<true>(data, labels, weights);
+  }
+}
+
+/**
+ * Compute the stable sort order of the points along each attribute.
+ *
+ * @param data Dataset to sort.
+ */
+template <typename MatType>
+void DecisionStump<MatType>::Presort(const MatType& data)
+{
+  boost::shared_ptr<arma::umat> order(new arma::umat(data.n_cols,
+      data.n_rows));
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < data.n_rows; i++)
+    order->col(i) = arma::stable_sort_index(trans(data.row(i)));
+
+  cache.sortedIndices = order;
+}
+
+/**
+ * Return whether or not the stored sort order is the stable sort order of the
+ * given data.
+ *
+ * @param data Dataset to check the sort order against.
+ */
+template <typename MatType>
+bool DecisionStump<MatType>::PresortMatches(const MatType& data) const
+{
+  if (!cache.sortedIndices || cache.sortedIndices->n_rows != data.n_cols ||
+      cache.sortedIndices->n_cols != data.n_rows)
+    return false;
+
+  // The order is the stable sort order if consecutive points are increasing in
+  // value, with ties in increasing order of index.  (Then no index can appear
+  // twice, so it is a permutation too.)
+  const arma::umat& order = *cache.sortedIndices;
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    for (size_t j = 1; j < data.n_cols; j++)
+    {
+      const double last = data(i, order(j - 1, i));
+      const double current = data(i, order(j, i));
+      if (!(last < current || (last == current &&
+          order(j - 1, i) < order(j, i))))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Quantize each attribute into bins at quantiles of its values.
+ *
+ * @param data Dataset to quantize.
+ */
+template <typename MatType>
+void DecisionStump<MatType>::Quantize(const MatType& data)
+{
+  // The quantiles are estimated from (at most) this many points, taken at even
+  // intervals, so that no attribute has to be sorted in full.
+  const size_t sampleSize = 65536;
+  const size_t stride = std::max((size_t) 1,
+      ((size_t) data.n_cols + sampleSize - 1) / sampleSize);
+
+  boost::shared_ptr<BinnedData> binned(new BinnedData);
+  binned->bin.set_size(data.n_cols, data.n_rows);
+  binned->edges.resize(data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    arma::vec sample((data.n_cols + stride - 1) / stride);
+    for (size_t j = 0; j < sample.n_elem; j++)
+      sample[j] = data(i, j * stride);
+    sample = arma::sort(sample);
+
+    // The edges are the quantiles of the sample, without duplicates (so an
+    // attribute with few distinct values has fewer bins).
+    std::vector<double> edges;
+    for (size_t k = 1; k < bins; k++)
+    {
+      const double edge = sample[(k * sample.n_elem) / bins];
+      if (edge > sample[0] && (edges.empty() || edge > edges.back()))
+        edges.push_back(edge);
+    }
+    binned->edges[i].set_size(edges.size());
+    for (size_t k = 0; k < edges.size(); k++)
+      binned->edges[i][k] = edges[k];
+
+    // The bin of each point is the number of edges at or below it.
+    const arma::vec& attributeEdges = binned->edges[i];
+    for (size_t j = 0; j < data.n_cols; j++)
+      binned->bin(j, i) = (unsigned char) (std::upper_bound(
+          attributeEdges.begin(), attributeEdges.end(), data(i, j)) -
+          attributeEdges.begin());
+  }
+
+  cache.binnedData = binned;
+}
+
+/**
+ * Return whether or not the stored bins are the bins of the given data.
+ *
+ * @param data Dataset to check the bins against.
+ */
+template <typename MatType>
+bool DecisionStump<MatType>::QuantizationMatches(const MatType& data) const
+{
+  if (!cache.binnedData || cache.binnedData->bin.n_rows != data.n_cols ||
+      cache.binnedData->bin.n_cols != data.n_rows)
+    return false;
+
+  // Each point has to be within the edges of its bin.
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    const arma::vec& edges = cache.binnedData->edges[i];
+    for (size_t j = 0; j < data.n_cols; j++)
+    {
+      const size_t b = cache.binnedData->bin(j, i);
+      if ((b > 0 && !(data(i, j) >= edges[b - 1])) ||
+          (b < edges.n_elem && !(data(i, j) < edges[b])))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Group the bins of an attribute into buckets of consecutive bins holding at
+ * least bucketSize points (unless there is only one bucket).
+ *
+ * @param binCounts Number of points in each bin.
+ * @param bucketStarts Vector to store the first bin of each bucket in.
+ */
+template <typename MatType>
+void DecisionStump<MatType>::GroupBins(const arma::Col<size_t>& binCounts,
+                                       std::vector<size_t>& bucketStarts) const
+{
+  bucketStarts.clear();
+  bucketStarts.push_back(0);
+
+  size_t count = 0;
+  for (size_t b = 0; b < binCounts.n_elem; b++)
+  {
+    // Start a new bucket at the next bin with points in it once the current
+    // bucket is full.  Empty bins go in the bucket before them.
+    if (binCounts[b] > 0 && count > 0 && count >= bucketSize)
+    {
+      bucketStarts.push_back(b);
+      count = 0;
+    }
 
-  // weightD = weights;
-  // tempD = weightD;
+    count += binCounts[b];
+  }
 
-  Train<true>(data, labels, weights);
+  // If the last bucket has too few points, merge it with the one before.
+  if (count < bucketSize && bucketStarts.size() > 1)
+    bucketStarts.pop_back();
+}
+
+/**
+ * Train the decision stump on the quantized data.
+ *
+ * @param data Dataset to train on.
+ * @param labels Labels for dataset.
+ * @param isWeight Whether we need to run a weighted Decision Stump.
+ */
+template <typename MatType>
+template <bool isWeight>
+void DecisionStump<MatType>::TrainBinned(const MatType& data,
+                                         const arma::Row<size_t>& labels,
+                                         const arma::rowvec& weightD)
+{
+  int bestAtt = 0;
+  const double rootEntropy = CalculateEntropy<size_t, isWeight>(
+      labels.subvec(0, labels.n_elem - 1), 0, weightD);
+
+  const BinnedData& binned = *cache.binnedData;
+  arma::vec entropies(data.n_rows);
+  arma::uvec candidate(data.n_rows);
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    // Build the histogram of the (weighted) labels in each bin.
+    const size_t numBins = binned.edges[i].n_elem + 1;
+    arma::mat histogram(numClass, numBins);
+    histogram.zeros();
+    arma::Col<size_t> binCounts(numBins);
+    binCounts.zeros();
+    for (size_t j = 0; j < data.n_cols; j++)
+    {
+      const size_t b = binned.bin(j, i);
+      histogram(labels[j], b) += (isWeight) ? weightD[j] : 1.0;
+      ++binCounts[b];
+    }
+
+    std::vector<size_t> bucketStarts;
+    GroupBins(binCounts, bucketStarts);
+
+    // An attribute with only one bucket can't be split on.
+    candidate[i] = (bucketStarts.size() > 1);
+    if (!candidate[i])
+      continue;
+
+    // Calculate the entropy of splitting at the buckets, as
+    // SetupSplitAttribute() does.
+    double entropy = 0.0;
+    for (size_t k = 0; k < bucketStarts.size(); k++)
+    {
+      const size_t end = (k + 1 < bucketStarts.size()) ? bucketStarts[k + 1] :
+          numBins;
+      const arma::vec classWeights = arma::sum(histogram.cols(bucketStarts[k],
+          end - 1), 1);
+      const double count = arma::accu(binCounts.subvec(bucketStarts[k],
+          end - 1));
+      const double accWeight = arma::accu(classWeights);
+      if (accWeight == 0.0)
+        continue;
+
+      double bucketEntropy = 0.0;
+      for (size_t c = 0; c < numClass; c++)
+      {
+        const double p1 = classWeights[c] / accWeight;
+        bucketEntropy += (p1 == 0) ? 0 : p1 * std::log(p1);
+      }
+
+      entropy += (count / data.n_cols) * bucketEntropy / std::log(2.0);
+    }
+
+    entropies[i] = entropy;
+  }
+
+  // Pick the best attribute in order, as Train() does.
+  double gain, bestGain = 0.0;
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    if (candidate[i])
+    {
+      gain = rootEntropy - entropies[i];
+      if (gain < bestGain)
+      {
+        bestAtt = i;
+        bestGain = gain;
+      }
+    }
+  }
+  splitAttribute = bestAtt;
+
+  // Now set up the buckets of the splitting attribute.  As in TrainOnAtt(),
+  // each bucket takes the most frequent label in it (the largest label, if
+  // there is a tie).
+  const arma::vec& edges = binned.edges[splitAttribute];
+  const size_t numBins = edges.n_elem + 1;
+  arma::Mat<size_t> classCounts(numClass, numBins);
+  classCounts.zeros();
+  arma::Col<size_t> binCounts(numBins);
+  binCounts.zeros();
+  for (size_t j = 0; j < data.n_cols; j++)
+  {
+    const size_t b = binned.bin(j, splitAttribute);
+    ++classCounts(labels[j], b);
+    ++binCounts[b];
+  }
+
+  std::vector<size_t> bucketStarts;
+  GroupBins(binCounts, bucketStarts);
+
+  const arma::rowvec attribute = data.row(splitAttribute);
+  split.set_size(bucketStarts.size());
+  binLabels.set_size(bucketStarts.size());
+  for (size_t k = 0; k < bucketStarts.size(); k++)
+  {
+    const size_t end = (k + 1 < bucketStarts.size()) ? bucketStarts[k + 1] :
+        numBins;
+
+    // The first bucket starts at the smallest value of the attribute.
+    split[k] = (k == 0) ? attribute.min() : edges[bucketStarts[k] - 1];
+
+    size_t mostFreq = 0, mostFreqCount = 0;
+    for (size_t c = 0; c < numClass; c++)
+    {
+      const size_t count = arma::accu(classCounts.submat(c, bucketStarts[k], c,
+          end - 1));
+      if (count >= mostFreqCount)
+      {
+        mostFreq = c;
+        mostFreqCount = count;
+      }
+    }
+    binLabels[k] = mostFreq;
+  }
+
+  // Merge buckets with the same label.
+  MergeRanges();
 }
 
 /**
  * Sets up attribute as if it were splitting on it and finds entropy when
  * splitting on attribute.
  *
- * @param attribute A row from the training data, which might be a candidate for
- *      the splitting attribute.
+ * @param sortedIndex Indices of the points in sorted order along the attribute
+ *      which might be a candidate for the splitting attribute.
  * @param isWeight Whether we need to run a weighted Decision Stump.
  */
 template <typename MatType>
 template <bool isWeight>
 double DecisionStump<MatType>::SetupSplitAttribute(
-    const arma::rowvec& attribute,
+    const arma::uvec& sortedIndex,
     const arma::Row<size_t>& labels,
     const arma::rowvec& weightD)
 {
   size_t i, count, begin, end;
   double entropy = 0.0;
 
-  // Sort the attribute in order to calculate splitting ranges.
-  arma::rowvec sortedAtt = arma::sort(attribute);
-
-  // Store the indices of the sorted attribute to build a vector of sorted
-  // labels.  This sort is stable.
-  arma::uvec sortedIndexAtt = arma::stable_sort_index(attribute.t());
-
-  arma::Row<size_t> sortedLabels(attribute.n_elem);
+  // Build a vector of labels (and weights) in sorted order of the attribute,
+  // in order to calculate splitting ranges.
+  arma::Row<size_t> sortedLabels(sortedIndex.n_elem);
   sortedLabels.fill(0);
 
   arma::rowvec tempD = arma::rowvec(weightD.n_cols);
 
-  for (i = 0; i < attribute.n_elem; i++)
+  for (i = 0; i < sortedIndex.n_elem; i++)
   {
-    sortedLabels(i) = labels(sortedIndexAtt(i));
+    sortedLabels(i) = labels(sortedIndex(i));
 
     if(isWeight)
-      tempD(i) = weightD(sortedIndexAtt(i));
+      tempD(i) = weightD(sortedIndex(i));
   }
 
   i = 0;
@@ -246,23 +593,28 @@ double DecisionStump<MatType>::SetupSplitAttribute(
  *
  * @param attribute Attribute is the attribute decided by the constructor on
  *      which we now train the decision stump.
+ * @param sortedIndex Indices of the points in sorted order along the
+ *      attribute.
  */
 template <typename MatType>
 template <typename rType>
 void DecisionStump<MatType>::TrainOnAtt(const arma::rowvec& attribute,
+                                        const arma::uvec& sortedIndex,
                                         const arma::Row<size_t>& labels)
 {
   size_t i, count, begin, end;
 
-  arma::rowvec sortedSplitAtt = arma::sort(attribute);
-  arma::uvec sortedSplitIndexAtt = arma::stable_sort_index(attribute.t());
+  arma::rowvec sortedSplitAtt(attribute.n_elem);
   arma::Row<size_t> sortedLabels(attribute.n_elem);
   sortedLabels.fill(0);
   arma::vec tempSplit;
   arma::Row<size_t> tempLabel;
 
   for (i = 0; i < attribute.n_elem; i++)
-    sortedLabels(i) = labels(sortedSplitIndexAtt(i));
+  {
+    sortedSplitAtt(i) = attribute(sortedIndex(i));
+    sortedLabels(i) = labels(sortedIndex(i));
+  }
 
   arma::rowvec subCols;
   rType mostFreq;
@@ -386,22 +738,6 @@ rType DecisionStump<MatType>::CountMostFreq(const arma::Row<rType>& subCols)
   return mostFreq;
 }
 
-/**
- * Returns 1 if all the values of featureRow are not same.
- *
- * @param featureRow The attribute which is checked for identical values.
- */
-template <typename MatType>
-template <typename rType>
-int DecisionStump<MatType>::IsDistinct(const arma::Row<rType>& featureRow)
-{
-  rType val = featureRow(0);
-  for (size_t i = 1; i < featureRow.n_elem; ++i)
-    if (val != featureRow(i))
-      return 1;
-  return 0;
-}
-
 /**
  * Calculate entropy of attribute.
  *
@@ -23,7 +23,10 @@ PROGRAM_INFO("Density Estimation With Density Estimation Trees",
     "in the DET can be calculated."
     "\n\n"
     "The created DET can be saved to a file, along with the density estimates "
-    "for the test set and the variable importances.");
+    "for the test set and the variable importances."
+    "\n\n"
+    "The cross-validation folds are run in parallel, and the number of threads "
+    "can be set with --threads.");
 
 // Input data files.
 PARAM_STRING_REQ("train_file", "The data set on which to build a density "
@@ -57,6 +60,7 @@ PARAM_INT("min_leaf_size", "The minimum size of a leaf in the unpruned, fully "
     "grown DET.", "N", 5);
 PARAM_INT("max_leaf_size", "The maximum size of a leaf in the unpruned, fully "
     "grown DET.", "M", 10);
+PARAM_THREADS();
 /*
 PARAM_FLAG("volume_regularization", "This flag gives the used the option to use"
     "a form of regularization similar to the usual alpha-pruning in decision "
@@ -99,6 +103,8 @@ int main(int argc, char *argv[])
   const int maxLeafSize = CLI::GetParam<int>("max_leaf_size");
   const int minLeafSize = CLI::GetParam<int>("min_leaf_size");
 
+  CLI::SetNumThreads("threads");
+
   // Obtain the optimal tree.
   Timer::Start("det_training");
   DTree *dtreeOpt = Trainer(trainingData, folds, regularization, maxLeafSize,
@@ -115,10 +121,13 @@ int main(int argc, char *argv[])
 
     // Compute density estimates for each point in the training set.
     Timer::Start("det_estimation_time");
-    for (size_t i = 0; i < trainingData.n_cols; i++)
-      fprintf(fp, "%lg\n", dtreeOpt->ComputeValue(trainingData.unsafe_col(i)));
+    arma::vec estimates;
+    dtreeOpt->ComputeValue(trainingData, estimates);
     Timer::Stop("det_estimation_time");
 
+    for (size_t i = 0; i < estimates.n_elem; i++)
+      fprintf(fp, "%lg\n", estimates[i]);
+
     fclose(fp);
   }
 
@@ -137,10 +146,13 @@ int main(int argc, char *argv[])
       fp = fopen(CLI::GetParam<string>("test_set_estimates_file").c_str(), "w");
 
       Timer::Start("det_test_set_estimation");
-      for (size_t i = 0; i < testData.n_cols; i++)
-        fprintf(fp, "%lg\n", dtreeOpt->ComputeValue(testData.unsafe_col(i)));
+      arma::vec estimates;
+      dtreeOpt->ComputeValue(testData, estimates);
       Timer::Stop("det_test_set_estimation");
 
+      for (size_t i = 0; i < estimates.n_elem; i++)
+        fprintf(fp, "%lg\n", estimates[i]);
+
       fclose(fp);
     }
   }
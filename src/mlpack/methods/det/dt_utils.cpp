@@ -129,11 +129,10 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
     std::ofstream outfile(unprunedTreeOutput.c_str());
     if (outfile.good())
     {
-      for (size_t i = 0; i < dataset.n_cols; ++i)
-      {
-        arma::vec testPoint = dataset.unsafe_col(i);
-        outfile << dtree->ComputeValue(testPoint) << std::endl;
-      }
+      arma::vec estimates;
+      dtree->ComputeValue(dataset, estimates);
+      for (size_t i = 0; i < estimates.n_elem; ++i)
+        outfile << estimates[i] << std::endl;
     }
     else
     {
@@ -170,47 +169,50 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
 
   delete dtree;
 
-  arma::mat cvData(dataset);
-  size_t testSize = dataset.n_cols / folds;
+  const size_t testSize = dataset.n_cols / folds;
 
-  std::vector<double> regularizationConstants;
-  regularizationConstants.resize(prunedSequence.size(), 0);
+  // The contribution of each fold to each regularization constant.  These are
+  // kept separately so that the folds can be run in parallel, and are summed
+  // in order afterwards so the result does not depend on the scheduling.
+  arma::mat foldConstants(prunedSequence.size(), folds);
+  foldConstants.zeros();
 
-  // Go through each fold.
+  // Go through each fold.  The folds are independent, so they can be computed
+  // in parallel.  No fold copies the dataset: the test points are taken
+  // directly from it, and the tree of each fold is grown on the indices of its
+  // training points.
+  #pragma omp parallel for schedule(dynamic)
   for (size_t fold = 0; fold < folds; fold++)
   {
     // Break up data into train and test sets.
-    size_t start = fold * testSize;
-    size_t end = std::min((fold + 1) * testSize, (size_t) cvData.n_cols);
-
-    arma::mat test = cvData.cols(start, end - 1);
-    arma::mat train(cvData.n_rows, cvData.n_cols - test.n_cols);
-
-    if (start == 0 && end < cvData.n_cols)
-    {
-      train.cols(0, train.n_cols - 1) = cvData.cols(end, cvData.n_cols - 1);
-    }
-    else if (start > 0 && end == cvData.n_cols)
-    {
-      train.cols(0, train.n_cols - 1) = cvData.cols(0, start - 1);
-    }
-    else
+    const size_t start = fold * testSize;
+    const size_t end = std::min((fold + 1) * testSize,
+        (size_t) dataset.n_cols);
+
+    arma::Col<size_t> trainIndices(dataset.n_cols - (end - start));
+    for (size_t i = 0; i < start; ++i)
+      trainIndices[i] = i;
+    for (size_t i = end; i < dataset.n_cols; ++i)
+      trainIndices[i - (end - start)] = i;
+
+    // Find the bounding box of the training points.
+    arma::vec maxVals = dataset.col(trainIndices[0]);
+    arma::vec minVals = dataset.col(trainIndices[0]);
+    for (size_t i = 1; i < trainIndices.n_elem; ++i)
     {
-      train.cols(0, start - 1) = cvData.cols(0, start - 1);
-      train.cols(start, train.n_cols - 1) = cvData.cols(end, cvData.n_cols - 1);
+      for (size_t j = 0; j < dataset.n_rows; ++j)
+      {
+        const double value = dataset(j, trainIndices[i]);
+        if (value > maxVals[j])
+          maxVals[j] = value;
+        if (value < minVals[j])
+          minVals[j] = value;
+      }
     }
 
-    // Initialize the tree.
-    DTree* cvDTree = new DTree(train);
-
-    // Getting ready to grow the tree...
-    arma::Col<size_t> cvOldFromNew(train.n_cols);
-    for (size_t i = 0; i < cvOldFromNew.n_elem; i++)
-      cvOldFromNew[i] = i;
-
-    // Grow the tree.
-    oldAlpha = 0.0;
-    alpha = cvDTree->Grow(train, cvOldFromNew, useVolumeReg, maxLeafSize,
+    // Initialize and grow the tree.
+    DTree* cvDTree = new DTree(maxVals, minVals, trainIndices.n_elem);
+    cvDTree->GrowIndices(dataset, trainIndices, useVolumeReg, maxLeafSize,
         minLeafSize);
 
     // Sequentially prune with all the values of available alphas and adding
@@ -221,37 +223,42 @@ DTree* mlpack::det::Trainer(arma::mat& dataset,
     {
       // Compute test values for this state of the tree.
       double cvVal = 0.0;
-      for (size_t j = 0; j < test.n_cols; j++)
+      for (size_t j = start; j < end; j++)
       {
-        arma::vec testPoint = test.unsafe_col(j);
+        arma::vec testPoint = dataset.unsafe_col(j);
         cvVal += cvDTree->ComputeValue(testPoint);
       }
 
       // Update the cv regularization constant.
-      regularizationConstants[i] += 2.0 * cvVal / (double) dataset.n_cols;
+      foldConstants(i, fold) = 2.0 * cvVal / (double) dataset.n_cols;
 
       // Determine the new alpha value and prune accordingly.
-      oldAlpha = 0.5 * (prunedSequence[i + 1].first +
+      const double cvAlpha = 0.5 * (prunedSequence[i + 1].first +
           prunedSequence[i + 2].first);
-      alpha = cvDTree->PruneAndUpdate(oldAlpha, train.n_cols, useVolumeReg);
+      cvDTree->PruneAndUpdate(cvAlpha, trainIndices.n_elem, useVolumeReg);
     }
 
     // Compute test values for this state of the tree.
     double cvVal = 0.0;
-    for (size_t i = 0; i < test.n_cols; ++i)
+    for (size_t i = start; i < end; ++i)
     {
-      arma::vec testPoint = test.unsafe_col(i);
+      arma::vec testPoint = dataset.unsafe_col(i);
       cvVal += cvDTree->ComputeValue(testPoint);
     }
 
     if (prunedSequence.size() > 2)
-      regularizationConstants[prunedSequence.size() - 2] += 2.0 * cvVal /
+      foldConstants(prunedSequence.size() - 2, fold) = 2.0 * cvVal /
           (double) dataset.n_cols;
 
-    test.reset();
     delete cvDTree;
   }
 
+  std::vector<double> regularizationConstants;
+  regularizationConstants.resize(prunedSequence.size(), 0);
+  for (size_t fold = 0; fold < folds; ++fold)
+    for (size_t i = 0; i < prunedSequence.size(); ++i)
+      regularizationConstants[i] += foldConstants(i, fold);
+
   double optimalAlpha = -1.0;
   long double cvBestError = -std::numeric_limits<long double>::max();
 
@@ -7,6 +7,7 @@
  *
  */
 #include "dtree.hpp"
+#include "flat_dtree.hpp"
 #include <stack>
 
 using namespace mlpack;
@@ -126,6 +127,7 @@ double DTree::LogNegativeError(const size_t totalPoints) const
 // all possible splits.  The dataset is the full data set but the start and
 // end are used to obtain the point in this node.
 bool DTree::FindSplit(const arma::mat& data,
+                      const arma::Col<size_t>& indices,
                       size_t& splitDim,
                       double& splitValue,
                       double& leftError,
@@ -138,6 +140,7 @@ bool DTree::FindSplit(const arma::mat& data,
   assert(data.n_rows == minVals.n_elem);
 
   const size_t points = end - start;
+  const size_t totalPoints = indices.n_elem;
 
   double minError = logNegError;
   bool splitFound = false;
@@ -166,7 +169,9 @@ bool DTree::FindSplit(const arma::mat& data,
     double volumeWithoutDim = logVolume - std::log(max - min);
 
     // Get the values for the dimension.
-    arma::rowvec dimVec = data.row(dim).subvec(start, end - 1);
+    arma::rowvec dimVec(points);
+    for (size_t i = 0; i < points; ++i)
+      dimVec[i] = data(dim, indices[start + i]);
 
     // Sort the values in ascending order.
     dimVec = arma::sort(dimVec);
@@ -212,7 +217,7 @@ bool DTree::FindSplit(const arma::mat& data,
     }
 
     double actualMinDimError = std::log(minDimError)
-        - 2 * std::log((double) data.n_cols) - volumeWithoutDim;
+        - 2 * std::log((double) totalPoints) - volumeWithoutDim;
 
     if ((actualMinDimError > minError) && dimSplitFound)
     {
@@ -221,9 +226,9 @@ bool DTree::FindSplit(const arma::mat& data,
       minError = actualMinDimError;
       splitDim = dim;
       splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
+      leftError = std::log(dimLeftError) - 2 * std::log((double) totalPoints)
           - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
+      rightError = std::log(dimRightError) - 2 * std::log((double) totalPoints)
           - volumeWithoutDim;
       splitFound = true;
     } // end if better split found in this dimension.
@@ -232,12 +237,12 @@ bool DTree::FindSplit(const arma::mat& data,
   return splitFound;
 }
 
-size_t DTree::SplitData(arma::mat& data,
+size_t DTree::SplitData(const arma::mat& data,
                         const size_t splitDim,
                         const double splitValue,
-                        arma::Col<size_t>& oldFromNew) const
+                        arma::Col<size_t>& indices) const
 {
-  // Swap all columns such that any columns with value in dimension splitDim
+  // Swap all indices such that any points with value in dimension splitDim
   // less than or equal to splitValue are on the left side, and all others are
   // on the right side.  A similar sort to this is also performed in
   // BinarySpaceTree construction (its comments are more detailed).
@@ -245,20 +250,17 @@ size_t DTree::SplitData(arma::mat& data,
   size_t right = end - 1;
   for (;;)
   {
-    while (data(splitDim, left) <= splitValue)
+    while (data(splitDim, indices[left]) <= splitValue)
       ++left;
-    while (data(splitDim, right) > splitValue)
+    while (data(splitDim, indices[right]) > splitValue)
       --right;
 
     if (left > right)
       break;
 
-    data.swap_cols(left, right);
-
-    // Store the mapping from old to new.
-    const size_t tmp = oldFromNew[left];
-    oldFromNew[left] = oldFromNew[right];
-    oldFromNew[right] = tmp;
+    const size_t tmp = indices[left];
+    indices[left] = indices[right];
+    indices[right] = tmp;
   }
 
   // This now refers to the first index of the "right" side.
@@ -271,6 +273,35 @@ double DTree::Grow(arma::mat& data,
                    const bool useVolReg,
                    const size_t maxLeafSize,
                    const size_t minLeafSize)
+{
+  // Grow the tree on the positions of the points, then reorder the dataset and
+  // the mapping in the same way.
+  arma::Col<size_t> indices(data.n_cols);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    indices[i] = i;
+
+  const double alpha = GrowIndices(data, indices, useVolReg, maxLeafSize,
+      minLeafSize);
+
+  arma::mat reorderedData(data.n_rows, data.n_cols);
+  arma::Col<size_t> reorderedOldFromNew(oldFromNew.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    reorderedData.col(i) = data.col(indices[i]);
+    reorderedOldFromNew[i] = oldFromNew[indices[i]];
+  }
+  data = reorderedData;
+  oldFromNew = reorderedOldFromNew;
+
+  return alpha;
+}
+
+// Greedily expand the tree on the points with the given indices.
+double DTree::GrowIndices(const arma::mat& data,
+                          arma::Col<size_t>& indices,
+                          const bool useVolReg,
+                          const size_t maxLeafSize,
+                          const size_t minLeafSize)
 {
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
@@ -278,7 +309,8 @@ double DTree::Grow(arma::mat& data,
   double leftG, rightG;
 
   // Compute points ratio.
-  ratio = (double) (end - start) / (double) oldFromNew.n_elem;
+  const size_t totalPoints = indices.n_elem;
+  ratio = (double) (end - start) / (double) totalPoints;
 
   // Compute the log of the volume of the node.
   logVolume = 0;
@@ -293,11 +325,12 @@ double DTree::Grow(arma::mat& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, indices, dim, splitValueTmp, leftError, rightError,
+        minLeafSize))
     {
-      // Move the data around for the children to have points in a node lie
-      // contiguously (to increase efficiency during the training).
-      const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew);
+      // Move the indices around for the children to have points in a node lie
+      // contiguously.
+      const size_t splitIndex = SplitData(data, dim, splitValueTmp, indices);
 
       // Make max and min vals for the children.
       arma::vec maxValsL(maxVals);
@@ -316,9 +349,9 @@ double DTree::Grow(arma::mat& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
+      leftG = left->GrowIndices(data, indices, useVolReg, maxLeafSize,
           minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
+      rightG = right->GrowIndices(data, indices, useVolReg, maxLeafSize,
           minLeafSize);
 
       // Store values of R(T~) and |T~|.
@@ -374,7 +407,7 @@ double DTree::Grow(arma::mat& data,
 
     if (left->SubtreeLeaves() > 1)
     {
-      const double exponent = 2 * std::log((double) data.n_cols) + logVolume +
+      const double exponent = 2 * std::log((double) totalPoints) + logVolume +
           left->AlphaUpper();
 
       // Whether or not this will overflow is highly dependent on the depth of
@@ -384,13 +417,13 @@ double DTree::Grow(arma::mat& data,
 
     if (right->SubtreeLeaves() > 1)
     {
-      const double exponent = 2 * std::log((double) data.n_cols) + logVolume +
+      const double exponent = 2 * std::log((double) totalPoints) + logVolume +
           right->AlphaUpper();
 
       tmpAlphaSum += std::exp(exponent);
     }
 
-    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) data.n_cols)
+    alphaUpper = std::log(tmpAlphaSum) - 2 * std::log((double) totalPoints)
         - logVolume;
 
     double gT;
@@ -570,6 +603,13 @@ double DTree::ComputeValue(const arma::vec& query) const
 }
 
 
+void DTree::ComputeValue(const arma::mat& queries, arma::vec& values) const
+{
+  FlatDTree flatTree(*this);
+  flatTree.ComputeValue(queries, values);
+}
+
+
 void DTree::WriteTree(FILE *fp, const size_t level) const
 {
   if (subtreeLeaves > 1)
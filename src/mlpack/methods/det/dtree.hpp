@@ -120,6 +120,27 @@ class DTree
               const size_t maxLeafSize = 10,
               const size_t minLeafSize = 5);
 
+  /**
+   * Greedily expand the tree on the points of the dataset with the given
+   * indices.  Instead of the dataset, the indices are reordered during tree
+   * growth, so that the points of each node are contiguous in the indices.
+   * The dataset is not modified, so several trees can be grown at once on
+   * different subsets of one dataset (as in cross-validation) without copying
+   * it.  The tree must have been created for indices.n_elem points, with a
+   * bounding box that holds all of them.
+   *
+   * @param data Dataset containing the points.
+   * @param indices Indices of the points to build tree on (will be reordered).
+   * @param useVolReg If true, volume regularization is used.
+   * @param maxLeafSize Maximum size of a leaf.
+   * @param minLeafSize Minimum size of a leaf.
+   */
+  double GrowIndices(const arma::mat& data,
+                     arma::Col<size_t>& indices,
+                     const bool useVolReg = false,
+                     const size_t maxLeafSize = 10,
+                     const size_t minLeafSize = 5);
+
   /**
    * Perform alpha pruning on a tree.  Returns the new value of alpha.
    *
@@ -139,6 +160,18 @@ class DTree
    */
   double ComputeValue(const arma::vec& query) const;
 
+  /**
+   * Compute the density estimates of a set of query points, one per column.
+   * This compiles the tree into a FlatDTree and evaluates the queries on that
+   * (in parallel, if OpenMP is available); if the same tree will be used for
+   * many batches of queries, it is faster to create the FlatDTree once and use
+   * it directly.
+   *
+   * @param queries Points to estimate the density of.
+   * @param values Vector to store the density estimates in.
+   */
+  void ComputeValue(const arma::mat& queries, arma::vec& values) const;
+
   /**
    * Print the tree in a depth-first manner (this function is called
    * recursively).
@@ -291,6 +324,7 @@ class DTree
    * Find the dimension to split on.
    */
   bool FindSplit(const arma::mat& data,
+                 const arma::Col<size_t>& indices,
                  size_t& splitDim,
                  double& splitValue,
                  double& leftError,
@@ -298,12 +332,14 @@ class DTree
                  const size_t minLeafSize = 5) const;
 
   /**
-   * Split the data, returning the number of points left of the split.
+   * Reorder the indices of the points in this node so the points left of the
+   * split come first, returning the index of the first point right of the
+   * split.
    */
-  size_t SplitData(arma::mat& data,
+  size_t SplitData(const arma::mat& data,
                    const size_t splitDim,
                    const double splitValue,
-                   arma::Col<size_t>& oldFromNew) const;
+                   arma::Col<size_t>& indices) const;
 
 };
 
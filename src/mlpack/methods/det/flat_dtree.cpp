@@ -0,0 +1,86 @@
+/**
+ * @file flat_dtree.cpp
+ *
+ * Implementation of the FlatDTree class.
+ */
+#include "flat_dtree.hpp"
+
+#include <queue>
+
+using namespace mlpack;
+using namespace mlpack::det;
+
+FlatDTree::FlatDTree(const DTree& tree) :
+    maxVals(tree.MaxVals()),
+    minVals(tree.MinVals())
+{
+  // Lay the nodes out in breadth-first order, so that the children of each node
+  // are next to each other, and nodes near the root are close together.
+  std::queue<const DTree*> queue;
+  queue.push(&tree);
+  nodes.reserve(2 * tree.SubtreeLeaves() - 1);
+
+  while (!queue.empty())
+  {
+    const DTree* node = queue.front();
+    queue.pop();
+
+    Node flatNode;
+    if (node->SubtreeLeaves() == 1)
+    {
+      flatNode.splitValue = 0.0;
+      flatNode.logDensity = std::log(node->Ratio()) - node->LogVolume();
+      flatNode.splitDim = 0;
+      flatNode.left = 0;
+    }
+    else
+    {
+      flatNode.splitValue = node->SplitValue();
+      flatNode.logDensity = 0.0;
+      flatNode.splitDim = node->SplitDim();
+      // The children will be placed after everything that is already in the
+      // table or in the queue.
+      flatNode.left = nodes.size() + queue.size() + 1;
+
+      queue.push(node->Left());
+      queue.push(node->Right());
+    }
+
+    nodes.push_back(flatNode);
+  }
+}
+
+double FlatDTree::ComputeValue(const arma::vec& query) const
+{
+  Log::Assert(query.n_elem == maxVals.n_elem);
+
+  return ComputeValue(query.memptr());
+}
+
+void FlatDTree::ComputeValue(const arma::mat& queries, arma::vec& values) const
+{
+  Log::Assert(queries.n_rows == maxVals.n_elem);
+
+  values.set_size(queries.n_cols);
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < queries.n_cols; ++i)
+    values[i] = ComputeValue(queries.colptr(i));
+}
+
+double FlatDTree::ComputeValue(const double* query) const
+{
+  // Check if the query is within range of the root.
+  for (size_t i = 0; i < maxVals.n_elem; ++i)
+    if ((query[i] < minVals[i]) || (query[i] > maxVals[i]))
+      return 0.0;
+
+  // The right child directly follows the left child, so the comparison selects
+  // the child without a branch.
+  size_t node = 0;
+  while (nodes[node].left != 0)
+    node = nodes[node].left +
+        (query[nodes[node].splitDim] > nodes[node].splitValue);
+
+  return std::exp(nodes[node].logDensity);
+}
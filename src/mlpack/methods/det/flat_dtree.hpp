@@ -0,0 +1,99 @@
+/**
+ * @file flat_dtree.hpp
+ *
+ * A flattened, read-only representation of a trained density estimation tree,
+ * for fast evaluation of many query points.
+ */
+#ifndef __MLPACK_METHODS_DET_FLAT_DTREE_HPP
+#define __MLPACK_METHODS_DET_FLAT_DTREE_HPP
+
+#include <mlpack/core.hpp>
+#include "dtree.hpp"
+
+namespace mlpack {
+namespace det {
+
+/**
+ * A FlatDTree is a compiled copy of a DTree, where all of the nodes are stored
+ * in one contiguous table instead of being linked by pointers.  Each entry of
+ * the table holds only what is needed to evaluate a query: the split dimension
+ * and split value (for internal nodes), the index of the left child (the right
+ * child always directly follows it), and the log-density (for leaves).  The
+ * bounding boxes of the individual nodes are not stored; only the bounding box
+ * of the root is needed to evaluate queries.
+ *
+ * The tree should be compiled after it has been grown and pruned; changes to
+ * the DTree after that are not reflected in the FlatDTree.
+ *
+ * @code
+ * extern DTree* dtree; // Trained tree.
+ * extern arma::mat queries;
+ *
+ * FlatDTree flatTree(*dtree);
+ * arma::vec densities;
+ * flatTree.ComputeValue(queries, densities);
+ * @endcode
+ */
+class FlatDTree
+{
+ public:
+  /**
+   * Compile the given density estimation tree.
+   *
+   * @param tree Tree to compile.
+   */
+  FlatDTree(const DTree& tree);
+
+  /**
+   * Compute the density estimate of a given query point.  This gives the same
+   * result as DTree::ComputeValue().
+   *
+   * @param query Point to estimate density of.
+   */
+  double ComputeValue(const arma::vec& query) const;
+
+  /**
+   * Compute the density estimates of a set of query points, one per column.
+   * If OpenMP is available, the queries are evaluated in parallel.
+   *
+   * @param queries Points to estimate the density of.
+   * @param values Vector to store the density estimates in.
+   */
+  void ComputeValue(const arma::mat& queries, arma::vec& values) const;
+
+  //! Get the number of nodes in the table.
+  size_t NumNodes() const { return nodes.size(); }
+
+ private:
+  //! One node in the table.
+  struct Node
+  {
+    //! The split value (internal nodes only).
+    double splitValue;
+    //! The log-density of the leaf (leaves only).
+    double logDensity;
+    //! The split dimension (internal nodes only).
+    size_t splitDim;
+    //! The index of the left child; 0 for leaves (the root is never a child).
+    size_t left;
+  };
+
+  //! The table of nodes; the root is at index 0.
+  std::vector<Node> nodes;
+
+  //! Upper bound of the bounding box of the root.
+  arma::vec maxVals;
+  //! Lower bound of the bounding box of the root.
+  arma::vec minVals;
+
+  /**
+   * Compute the density estimate of the point stored at the given memory
+   * location (which must have maxVals.n_elem elements).
+   */
+  double ComputeValue(const double* query) const;
+};
+
+}; // namespace det
+}; // namespace mlpack
+
+#endif // __MLPACK_METHODS_DET_FLAT_DTREE_HPP
@@ -0,0 +1,142 @@
+/**
+ * @file dendrogram.cpp
+ *
+ * Implementation of the single-linkage Dendrogram class.
+ */
+#include "dendrogram.hpp"
+
+using namespace mlpack;
+using namespace mlpack::emst;
+
+namespace {
+
+//! For sorting the MST edges by length.
+struct SortEdgesHelper
+{
+  SortEdgesHelper(const arma::mat& mst) : mst(mst) { }
+
+  bool operator()(const size_t a, const size_t b) const
+  {
+    return (mst(2, a) < mst(2, b));
+  }
+
+  const arma::mat& mst;
+};
+
+} // anonymous namespace
+
+Dendrogram::Dendrogram(const arma::mat& mst)
+{
+  if (mst.n_rows != 3)
+  {
+    Log::Fatal << "Dendrogram::Dendrogram(): MST must have 3 rows (has "
+        << mst.n_rows << ")!" << std::endl;
+  }
+
+  const size_t numPoints = mst.n_cols + 1;
+
+  // The MST from DualTreeBoruvka is already sorted, but other sources may not
+  // be.  A stable sort keeps the order of equal-length edges.
+  std::vector<size_t> order(mst.n_cols);
+  for (size_t i = 0; i < mst.n_cols; ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), SortEdgesHelper(mst));
+
+  // For each union-find root, the index of the cluster it represents and the
+  // size of that cluster.
+  UnionFind connections(numPoints);
+  arma::Col<size_t> clusterIndices(numPoints);
+  arma::Col<size_t> clusterSizes(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    clusterIndices[i] = i;
+    clusterSizes[i] = 1;
+  }
+
+  merges.set_size(4, mst.n_cols);
+  edges.set_size(2, mst.n_cols);
+  for (size_t i = 0; i < mst.n_cols; ++i)
+  {
+    const size_t a = (size_t) mst(0, order[i]);
+    const size_t b = (size_t) mst(1, order[i]);
+    if ((a >= numPoints) || (b >= numPoints))
+    {
+      Log::Fatal << "Dendrogram::Dendrogram(): edge " << order[i] << " refers "
+          << "to a point outside the tree!" << std::endl;
+    }
+
+    const size_t rootA = connections.Find(a);
+    const size_t rootB = connections.Find(b);
+    if (rootA == rootB)
+    {
+      Log::Fatal << "Dendrogram::Dendrogram(): edge " << order[i] << " creates "
+          << "a cycle; input is not a spanning tree!" << std::endl;
+    }
+
+    const size_t clusterA = clusterIndices[rootA];
+    const size_t clusterB = clusterIndices[rootB];
+    const size_t size = clusterSizes[rootA] + clusterSizes[rootB];
+
+    merges(0, i) = std::min(clusterA, clusterB);
+    merges(1, i) = std::max(clusterA, clusterB);
+    merges(2, i) = mst(2, order[i]);
+    merges(3, i) = size;
+
+    edges(0, i) = a;
+    edges(1, i) = b;
+
+    connections.Union(a, b);
+    const size_t root = connections.Find(a);
+    clusterIndices[root] = numPoints + i;
+    clusterSizes[root] = size;
+  }
+}
+
+void Dendrogram::Cut(const size_t numClusters, arma::Col<size_t>& labels) const
+{
+  if ((numClusters == 0) || (numClusters > NumPoints()))
+  {
+    Log::Fatal << "Dendrogram::Cut(): number of clusters must be between 1 and "
+        << NumPoints() << " (given " << numClusters << ")!" << std::endl;
+  }
+
+  Labels(NumPoints() - numClusters, labels);
+}
+
+size_t Dendrogram::CutAtDistance(const double distance,
+                                 arma::Col<size_t>& labels) const
+{
+  // The merges are sorted by height, so we apply all merges up to the first
+  // one that is higher than the given distance.
+  size_t numMerges = 0;
+  while ((numMerges < merges.n_cols) && (merges(2, numMerges) <= distance))
+    ++numMerges;
+
+  Labels(numMerges, labels);
+
+  return NumPoints() - numMerges;
+}
+
+void Dendrogram::Labels(const size_t numMerges, arma::Col<size_t>& labels) const
+{
+  const size_t numPoints = NumPoints();
+
+  UnionFind connections(numPoints);
+  for (size_t i = 0; i < numMerges; ++i)
+    connections.Union(edges(0, i), edges(1, i));
+
+  // Number the clusters in the order they are first seen.
+  arma::Col<size_t> rootLabels(numPoints);
+  rootLabels.fill(size_t(-1));
+  size_t numLabels = 0;
+
+  labels.set_size(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    const size_t root = connections.Find(i);
+    if (rootLabels[root] == size_t(-1))
+      rootLabels[root] = numLabels++;
+
+    labels[i] = rootLabels[root];
+  }
+}
@@ -0,0 +1,105 @@
+/**
+ * @file dendrogram.hpp
+ *
+ * Build a single-linkage hierarchical clustering (dendrogram) from the edges of
+ * a Euclidean minimum spanning tree, as computed by DualTreeBoruvka.
+ */
+#ifndef __MLPACK_METHODS_EMST_DENDROGRAM_HPP
+#define __MLPACK_METHODS_EMST_DENDROGRAM_HPP
+
+#include <mlpack/core.hpp>
+
+#include "union_find.hpp"
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * The single-linkage dendrogram of a dataset.  Single-linkage clustering merges
+ * clusters in the same order that Kruskal's algorithm adds edges to the
+ * minimum spanning tree, so the dendrogram can be built in O(N) time (plus a
+ * sort, if the edges are not already sorted) from the output of
+ * DualTreeBoruvka::ComputeMST().
+ *
+ * Clusters are numbered as follows: the points themselves are clusters 0
+ * through N - 1, and the cluster created by the i'th merge is cluster N + i.
+ * The merges are stored in a 4 x (N - 1) matrix, where each column represents
+ * one merge: the first two rows are the (lesser and greater) indices of the two
+ * clusters being merged, the third row is the height of the merge (the length
+ * of the MST edge), and the fourth row is the number of points in the new
+ * cluster.  This is the same layout that many other hierarchical clustering
+ * packages use (transposed).
+ *
+ * @code
+ * extern arma::mat data;
+ * DualTreeBoruvka<> dtb(data);
+ * arma::mat mst;
+ * dtb.ComputeMST(mst);
+ *
+ * Dendrogram dendrogram(mst);
+ * arma::Col<size_t> labels;
+ * dendrogram.Cut(5, labels); // Cut the dendrogram into 5 clusters.
+ * @endcode
+ */
+class Dendrogram
+{
+ public:
+  /**
+   * Build the dendrogram from the edges of a minimum spanning tree, in the
+   * format returned by DualTreeBoruvka::ComputeMST() (a 3 x (N - 1) matrix,
+   * where the first two rows hold the indices of the endpoints and the third
+   * row holds the length of the edge).  The edges are sorted by length if they
+   * are not sorted already.
+   *
+   * @param mst Edges of the minimum spanning tree.
+   */
+  Dendrogram(const arma::mat& mst);
+
+  /**
+   * Compute flat cluster labels for each point by cutting the dendrogram so
+   * that there are the given number of clusters.  Labels are numbered from 0
+   * in the order that clusters are first seen in the dataset.
+   *
+   * @param numClusters Number of clusters to cut the dendrogram into.
+   * @param labels Vector to store the cluster label of each point in.
+   */
+  void Cut(const size_t numClusters, arma::Col<size_t>& labels) const;
+
+  /**
+   * Compute flat cluster labels for each point by cutting the dendrogram at the
+   * given height: two points are in the same cluster if they are connected by a
+   * path in the minimum spanning tree whose edges are all no longer than the
+   * given distance.  Labels are numbered from 0 in the order that clusters are
+   * first seen in the dataset.
+   *
+   * @param distance Height to cut the dendrogram at.
+   * @param labels Vector to store the cluster label of each point in.
+   * @return The number of clusters.
+   */
+  size_t CutAtDistance(const double distance, arma::Col<size_t>& labels) const;
+
+  //! Get the number of points in the dataset.
+  size_t NumPoints() const { return merges.n_cols + 1; }
+
+  //! Get the merges (a 4 x (N - 1) matrix; see the class documentation).
+  const arma::mat& Merges() const { return merges; }
+
+ private:
+  //! The merges, one per column.
+  arma::mat merges;
+
+  //! The lesser and greater point index of the MST edge for each merge (in
+  //! merge order).
+  arma::Mat<size_t> edges;
+
+  /**
+   * Apply the first numMerges merges to a fresh union-find structure and
+   * compute the labels of each point from that.
+   */
+  void Labels(const size_t numMerges, arma::Col<size_t>& labels) const;
+};
+
+}; // namespace emst
+}; // namespace mlpack
+
+#endif // __MLPACK_METHODS_EMST_DENDROGRAM_HPP
@@ -22,6 +22,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "dtb_rules.hpp"
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -63,6 +64,15 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * The only pruning information kept from one Boruvka iteration to the next is
+ * whether all of the points of a node are in one component: components only
+ * ever merge, so that stays true, and any pair of nodes in the same component
+ * is pruned in O(1) in every later iteration.  Pruning by distance is not
+ * carried over between iterations.  Every component is merged with another in
+ * each iteration, so the nearest-neighbor bound of every component changes,
+ * and no pair of nodes pruned by distance in one iteration can be proven to
+ * stay prunable in the next.
+ *
  * @tparam MetricType The metric to use.  IMPORTANT: this hasn't really been
  * tested with anything other than the L2 metric, so user beware. Note that the
  * tree type needs to compute bounds using the same metric as the type
@@ -94,6 +104,9 @@ class DualTreeBoruvka
 
   //! Connections.
   UnionFind connections;
+  //! The component of each point, refreshed from the UnionFind at the end of
+  //! each iteration; the rules only read from this during traversal.
+  arma::Col<size_t> pointComponents;
 
   //! Permutations of points during tree building.
   std::vector<size_t> oldFromNew;
@@ -180,6 +193,18 @@ class DualTreeBoruvka
    */
   void AddEdge(const size_t e1, const size_t e2, const double distance);
 
+  /**
+   * Perform one dual-tree traversal of the tree with itself.  If OpenMP is
+   * available and the tree does not have self-children, the query tree is
+   * split into a set of disjoint subtrees which are each traversed against the
+   * whole reference tree in parallel.  Each thread keeps its own candidate
+   * edges, which are then merged into the candidate edge lists.
+   *
+   * @param rules Rules object to use for a serial traversal; also used to
+   *     accumulate base case and score counts.
+   */
+  void TraverseTree(DTBRules<MetricType, TreeType>& rules);
+
   /**
    * Adds all the edges found in one iteration to the list of neighbors.
    */
@@ -192,7 +217,10 @@ class DualTreeBoruvka
 
   /**
    * This function resets the values in the nodes of the tree nearest neighbor
-   * distance, and checks for fully connected nodes.
+   * distance, and checks for fully connected nodes.  Because components only
+   * ever merge, a node that was fully connected in a previous iteration is
+   * still fully connected, so its points do not need to be checked again; only
+   * the index of its component is updated.
    */
   void CleanupHelper(TreeType* tree);
 
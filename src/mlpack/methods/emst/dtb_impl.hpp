@@ -72,6 +72,11 @@ DualTreeBoruvka<MetricType, TreeType>::DualTreeBoruvka(
   neighborsOutComponent.set_size(data.n_cols);
   neighborsDistances.set_size(data.n_cols);
   neighborsDistances.fill(DBL_MAX);
+
+  // Each point starts in its own component.
+  pointComponents.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    pointComponents[i] = i;
 } // Constructor
 
 template<typename MetricType, typename TreeType>
@@ -93,6 +98,11 @@ DualTreeBoruvka<MetricType, TreeType>::DualTreeBoruvka(
   neighborsOutComponent.set_size(data.n_cols);
   neighborsDistances.set_size(data.n_cols);
   neighborsDistances.fill(DBL_MAX);
+
+  // Each point starts in its own component.
+  pointComponents.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    pointComponents[i] = i;
 }
 
 template<typename MetricType, typename TreeType>
@@ -114,8 +124,8 @@ void DualTreeBoruvka<MetricType, TreeType>::ComputeMST(arma::mat& results)
   totalDist = 0; // Reset distance.
 
   typedef DTBRules<MetricType, TreeType> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+  RuleType rules(data, pointComponents, neighborsDistances,
+                 neighborsInComponent, neighborsOutComponent, metric);
   while (edges.size() < (data.n_cols - 1))
   {
     if (naive)
@@ -127,8 +137,7 @@ void DualTreeBoruvka<MetricType, TreeType>::ComputeMST(arma::mat& results)
     }
     else
     {
-      typename TreeType::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      TraverseTree(rules);
     }
 
     AddAllEdges();
@@ -168,6 +177,103 @@ void DualTreeBoruvka<MetricType, TreeType>::AddEdge(const size_t e1,
     edges.push_back(EdgePair(e2, e1, distance));
 } // AddEdge
 
+/**
+ * Perform one dual-tree traversal, in parallel if possible.
+ */
+template<typename MetricType, typename TreeType>
+void DualTreeBoruvka<MetricType, TreeType>::TraverseTree(
+    DTBRules<MetricType, TreeType>& rules)
+{
+  typedef DTBRules<MetricType, TreeType> RuleType;
+
+#ifdef _OPENMP
+  const size_t numThreads = omp_get_max_threads();
+#else
+  const size_t numThreads = 1;
+#endif
+
+  // Trees with self-children (like the cover tree) cannot be split into
+  // disjoint query subtrees, so those are always traversed serially.
+  if ((numThreads == 1) || tree::TreeTraits<TreeType>::HasSelfChildren)
+  {
+    typename TreeType::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*tree, *tree);
+    return;
+  }
+
+  // Split the query tree into enough disjoint subtrees to keep all of the
+  // threads busy.
+  std::vector<TreeType*> queryNodes(1, tree);
+  bool splitAny = true;
+  while (splitAny && (queryNodes.size() < 4 * numThreads))
+  {
+    splitAny = false;
+    std::vector<TreeType*> nextQueryNodes;
+    for (size_t i = 0; i < queryNodes.size(); ++i)
+    {
+      if (queryNodes[i]->NumChildren() == 0)
+      {
+        nextQueryNodes.push_back(queryNodes[i]);
+        continue;
+      }
+
+      splitAny = true;
+      for (size_t j = 0; j < queryNodes[i]->NumChildren(); ++j)
+        nextQueryNodes.push_back(&queryNodes[i]->Child(j));
+    }
+
+    queryNodes.swap(nextQueryNodes);
+  }
+
+  #pragma omp parallel
+  {
+    // Each thread keeps its own candidate edges, so that no locking is needed
+    // during the traversal.  The statistics of the query nodes are not shared
+    // between threads because the query subtrees are disjoint.
+    arma::vec localDistances(data.n_cols);
+    localDistances.fill(DBL_MAX);
+    arma::Col<size_t> localInComponent(data.n_cols);
+    arma::Col<size_t> localOutComponent(data.n_cols);
+    MetricType localMetric(metric);
+
+    RuleType localRules(data, pointComponents, localDistances,
+        localInComponent, localOutComponent, localMetric);
+
+    #pragma omp for schedule(dynamic)
+    for (size_t i = 0; i < queryNodes.size(); ++i)
+    {
+      typename TreeType::template DualTreeTraverser<RuleType>
+          traverser(localRules);
+      traverser.Traverse(*queryNodes[i], *tree);
+    }
+
+    // Merge the candidate edges.  Ties are broken by point index so that the
+    // result does not depend on the order the threads finish in.
+    #pragma omp critical
+    {
+      for (size_t i = 0; i < data.n_cols; ++i)
+      {
+        if (localDistances[i] == DBL_MAX)
+          continue;
+
+        if ((localDistances[i] < neighborsDistances[i]) ||
+            ((localDistances[i] == neighborsDistances[i]) &&
+             ((localInComponent[i] < neighborsInComponent[i]) ||
+              ((localInComponent[i] == neighborsInComponent[i]) &&
+               (localOutComponent[i] < neighborsOutComponent[i])))))
+        {
+          neighborsDistances[i] = localDistances[i];
+          neighborsInComponent[i] = localInComponent[i];
+          neighborsOutComponent[i] = localOutComponent[i];
+        }
+      }
+
+      rules.BaseCases() += localRules.BaseCases();
+      rules.Scores() += localRules.Scores();
+    }
+  }
+}
+
 /**
  * Adds all the edges found in one iteration to the list of neighbors.
  */
@@ -255,11 +361,22 @@ void DualTreeBoruvka<MetricType, TreeType>::CleanupHelper(TreeType* tree)
   for (size_t i = 0; i < tree->NumChildren(); ++i)
     CleanupHelper(&tree->Child(i));
 
+  // If all points in this node were in the same component during a previous
+  // iteration, they still are, since components are only ever merged.  So we
+  // only need to find the new index of the component, instead of checking
+  // every point again.
+  if (tree->Stat().ComponentMembership() >= 0)
+  {
+    tree->Stat().ComponentMembership() =
+        pointComponents[tree->Stat().ComponentMembership()];
+    return;
+  }
+
   // Get the component of the first child or point.  Then we will check to see
   // if all other components of children and points are the same.
   const int component = (tree->NumChildren() != 0) ?
       tree->Child(0).Stat().ComponentMembership() :
-      connections.Find(tree->Point(0));
+      pointComponents[tree->Point(0)];
 
   // Check components of children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
@@ -268,7 +385,7 @@ void DualTreeBoruvka<MetricType, TreeType>::CleanupHelper(TreeType* tree)
 
   // Check components of points.
   for (size_t i = 0; i < tree->NumPoints(); ++i)
-    if (connections.Find(tree->Point(i)) != size_t(component))
+    if (pointComponents[tree->Point(i)] != size_t(component))
       return;
 
   // If we made it this far, all components are the same.
@@ -284,6 +401,11 @@ void DualTreeBoruvka<MetricType, TreeType>::Cleanup()
   for (size_t i = 0; i < data.n_cols; i++)
     neighborsDistances[i] = DBL_MAX;
 
+  // Flatten the union-find structure, so that the rules can look up the
+  // component of a point without modifying anything.
+  for (size_t i = 0; i < data.n_cols; ++i)
+    pointComponents[i] = connections.Find(i);
+
   if (!naive)
     CleanupHelper(tree);
 }
@@ -19,7 +19,7 @@ class DTBRules
 {
  public:
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
+           const arma::Col<size_t>& pointComponents,
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
@@ -124,8 +124,10 @@ class DTBRules
   //! The data points.
   const arma::mat& dataSet;
 
-  //! Stores the tree structure so far
-  UnionFind& connections;
+  //! The component each point belongs to, as of the start of this iteration.
+  //! This is a flattened copy of the UnionFind structure, so it is safe to
+  //! read from several threads at once.
+  const arma::Col<size_t>& pointComponents;
 
   //! The distance to the candidate nearest neighbor for each component.
   arma::vec& neighborsDistances;
@@ -13,14 +13,14 @@ namespace emst {
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
+         const arma::Col<size_t>& pointComponents,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
          MetricType& metric)
 :
   dataSet(dataSet),
-  connections(connections),
+  pointComponents(pointComponents),
   neighborsDistances(neighborsDistances),
   neighborsInComponent(neighborsInComponent),
   neighborsOutComponent(neighborsOutComponent),
@@ -42,9 +42,9 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
   double newUpperBound = -1.0;
 
   // Find the index of the component the query is in.
-  size_t queryComponentIndex = connections.Find(queryIndex);
+  size_t queryComponentIndex = pointComponents[queryIndex];
 
-  size_t referenceComponentIndex = connections.Find(referenceIndex);
+  size_t referenceComponentIndex = pointComponents[referenceIndex];
 
   if (queryComponentIndex != referenceComponentIndex)
   {
@@ -74,7 +74,7 @@ template<typename MetricType, typename TreeType>
 double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
                                              TreeType& referenceNode)
 {
-  size_t queryComponentIndex = connections.Find(queryIndex);
+  size_t queryComponentIndex = pointComponents[queryIndex];
 
   // If the query belongs to the same component as all of the references,
   // then prune.  The cast is to stop a warning about comparing unsigned to
@@ -100,7 +100,7 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
   // I don't really understand the last argument here
   // It just gets passed in the distance call, otherwise this function
   // is the same as the one above.
-  size_t queryComponentIndex = connections.Find(queryIndex);
+  size_t queryComponentIndex = pointComponents[queryIndex];
 
   // If the query belongs to the same component as all of the references,
   // then prune.
@@ -124,7 +124,7 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
+  return (oldScore > neighborsDistances[pointComponents[queryIndex]])
       ? DBL_MAX : oldScore;
 }
 
@@ -193,7 +193,7 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   // Now, find the best and worst point bounds.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const size_t pointComponent = connections.Find(queryNode.Point(i));
+    const size_t pointComponent = pointComponents[queryNode.Point(i)];
     const double bound = neighborsDistances[pointComponent];
 
     if (bound > worstPointBound)
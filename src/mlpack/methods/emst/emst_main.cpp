@@ -21,6 +21,7 @@
  */
 
 #include "dtb.hpp"
+#include "dendrogram.hpp"
 
 #include <mlpack/core.hpp>
 
@@ -31,12 +32,31 @@ PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree", "This program can compute "
     "The output is saved in a three-column matrix, where each row indicates an "
     "edge.  The first column corresponds to the lesser index of the edge; the "
     "second column corresponds to the greater index of the edge; and the third "
-    "column corresponds to the distance between the two points.");
+    "column corresponds to the distance between the two points."
+    "\n\n"
+    "The single-linkage hierarchical clustering of the points can also be saved "
+    "with the --dendrogram_file (-d) option.  Each row of this file is one "
+    "merge: the first two columns are the indices of the two clusters that are "
+    "merged (points are clusters 0 to N - 1, and the cluster created by the "
+    "i'th merge is cluster N + i), the third column is the distance at which "
+    "they are merged, and the fourth column is the size of the new cluster."
+    "\n\n"
+    "Flat cluster labels can be saved with the --labels_file (-L) option; the "
+    "dendrogram is then cut into the number of clusters given by --clusters "
+    "(-k), or, if that is not given, at the distance given by --cut_distance "
+    "(-c).");
 
 PARAM_STRING_REQ("input_file", "Data input file.", "i");
 PARAM_STRING("output_file", "Data output file.  Stored as an edge list.", "o",
     "emst_output.csv");
 PARAM_FLAG("naive", "Compute the MST using O(n^2) naive algorithm.", "n");
+PARAM_STRING("dendrogram_file", "File to save the single-linkage dendrogram "
+    "to.", "d", "");
+PARAM_STRING("labels_file", "File to save flat cluster labels to.", "L", "");
+PARAM_INT("clusters", "Number of clusters to cut the dendrogram into when "
+    "computing cluster labels.", "k", 0);
+PARAM_DOUBLE("cut_distance", "If --clusters is not given, cut the dendrogram "
+    "at this distance when computing cluster labels.", "c", 0.0);
 PARAM_INT("leaf_size", "Leaf size in the kd-tree.  One-element leaves give the "
     "empirically best performance, but at the cost of greater memory "
     "requirements.", "l", 1);
@@ -55,6 +75,22 @@ int main(int argc, char* argv[])
   arma::mat dataPoints;
   data::Load(dataFilename, dataPoints, true);
 
+  const string labelsFilename = CLI::GetParam<string>("labels_file");
+  if (CLI::HasParam("clusters") && CLI::GetParam<int>("clusters") <= 0)
+  {
+    Log::Fatal << "Invalid number of clusters (" << CLI::GetParam<int>(
+        "clusters") << ")!  Must be greater than or equal to 1." << std::endl;
+  }
+  if (labelsFilename != "" && !CLI::HasParam("clusters") &&
+      !CLI::HasParam("cut_distance"))
+  {
+    Log::Warn << "Neither --clusters nor --cut_distance specified; cluster "
+        << "labels will be computed with a cut distance of 0." << std::endl;
+  }
+
+  // This will hold the MST, in terms of the original point indices.
+  arma::mat mst;
+
   // Do naive computation if necessary.
   if (CLI::GetParam<bool>("naive"))
   {
@@ -62,12 +98,7 @@ int main(int argc, char* argv[])
 
     DualTreeBoruvka<> naive(dataPoints, true);
 
-    arma::mat naiveResults;
-    naive.ComputeMST(naiveResults);
-
-    const string outputFilename = CLI::GetParam<string>("output_file");
-
-    data::Save(outputFilename, naiveResults, true);
+    naive.ComputeMST(mst);
   }
   else
   {
@@ -99,7 +130,8 @@ int main(int argc, char* argv[])
     dtb.ComputeMST(results);
 
     // Unmap the results.
-    arma::mat unmappedResults(results.n_rows, results.n_cols);
+    arma::mat& unmappedResults = mst;
+    unmappedResults.set_size(results.n_rows, results.n_cols);
     for (size_t i = 0; i < results.n_cols; ++i)
     {
       const size_t indexA = oldFromNew[size_t(results(0, i))];
@@ -118,10 +150,41 @@ int main(int argc, char* argv[])
 
       unmappedResults(2, i) = results(2, i);
     }
+  }
+
+  // Output the results.
+  const string outputFilename = CLI::GetParam<string>("output_file");
 
-    // Output the results.
-    const string outputFilename = CLI::GetParam<string>("output_file");
+  data::Save(outputFilename, mst, true);
 
-    data::Save(outputFilename, unmappedResults, true);
+  // Compute the single-linkage clustering, if requested.
+  const string dendrogramFilename = CLI::GetParam<string>("dendrogram_file");
+  if (dendrogramFilename != "" || labelsFilename != "")
+  {
+    Timer::Start("dendrogram");
+    Dendrogram dendrogram(mst);
+    Timer::Stop("dendrogram");
+
+    if (dendrogramFilename != "")
+      data::Save(dendrogramFilename, dendrogram.Merges(), true);
+
+    if (labelsFilename != "")
+    {
+      arma::Col<size_t> labels;
+      if (CLI::HasParam("clusters"))
+      {
+        dendrogram.Cut((size_t) CLI::GetParam<int>("clusters"), labels);
+      }
+      else
+      {
+        const size_t numClusters = dendrogram.CutAtDistance(
+            CLI::GetParam<double>("cut_distance"), labels);
+        Log::Info << numClusters << " clusters at distance "
+            << CLI::GetParam<double>("cut_distance") << "." << endl;
+      }
+
+      // Don't transpose: one label per line.
+      data::Save(labelsFilename, labels, true, false);
+    }
   }
 }
@@ -0,0 +1,130 @@
+/**
+ * @file covariance_update.hpp
+ *
+ * Helpers shared by the GMM fitters (EMFit and OnlineEMFit) to set the
+ * covariance of each component after the constraint is applied.
+ */
+#ifndef __MLPACK_METHODS_GMM_COVARIANCE_UPDATE_HPP
+#define __MLPACK_METHODS_GMM_COVARIANCE_UPDATE_HPP
+
+#include <mlpack/core.hpp>
+
+#include "diagonal_constraint.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * Whether or not the covariances of a GMM fitted with the given constraint and
+ * distribution type are diagonal, either because of the constraint or because
+ * of the type of the Gaussians.  If they are, the fitters only compute the
+ * variance of each dimension.
+ */
+template<typename CovarianceConstraintPolicy, typename Distribution>
+struct DiagonalCovariances
+{
+  static const bool value =
+      boost::is_same<CovarianceConstraintPolicy, DiagonalConstraint>::value ||
+      boost::is_same<Distribution,
+          distribution::DiagonalGaussianDistribution>::value;
+};
+
+/**
+ * Apply the covariance constraint to the given covariance of a Gaussian, in
+ * place.  If the covariance has one column, it is the diagonal of the
+ * covariance matrix, and it is expanded to the full matrix first.
+ *
+ * The constraint may write to the log, which is not thread-safe, so this
+ * should not be called from several threads at once.
+ *
+ * @param constraint Constraint to apply.
+ * @param dist Gaussian the covariance is for (only its type is used).
+ * @param covariance Covariance (or its diagonal) to constrain.
+ */
+template<typename CovarianceConstraintPolicy>
+void ConstrainCovariance(const CovarianceConstraintPolicy& constraint,
+                         const distribution::GaussianDistribution& /* dist */,
+                         arma::mat& covariance)
+{
+  // A diagonal covariance has to be expanded to the full matrix.
+  if (covariance.n_cols == 1)
+  {
+    const arma::mat fullCovariance = arma::diagmat(covariance.col(0));
+    covariance = fullCovariance;
+  }
+
+  constraint.ApplyConstraint(covariance);
+}
+
+/**
+ * Apply the covariance constraint to the given variances of a diagonal
+ * Gaussian, in place.
+ *
+ * The constraint may write to the log, which is not thread-safe, so this
+ * should not be called from several threads at once.
+ *
+ * @param constraint Constraint to apply.
+ * @param dist Gaussian the variances are for (only its type is used).
+ * @param covariance Variances to constrain, as a matrix with one column.
+ */
+template<typename CovarianceConstraintPolicy>
+void ConstrainCovariance(
+    const CovarianceConstraintPolicy& constraint,
+    const distribution::DiagonalGaussianDistribution& /* dist */,
+    arma::mat& covariance)
+{
+  arma::vec variances = covariance.col(0);
+  constraint.ApplyConstraint(variances);
+  covariance = variances;
+}
+
+/**
+ * Set the (already constrained) covariance of the given Gaussian.  This
+ * updates the factorization of the covariance, and can be called for
+ * different Gaussians from several threads at once.
+ *
+ * @param dist Gaussian to set the covariance of.
+ * @param covariance New covariance.
+ */
+inline void SetCovariance(distribution::GaussianDistribution& dist,
+                          const arma::mat& covariance)
+{
+  dist.Covariance(covariance);
+}
+
+/**
+ * Set the (already constrained) variances of the given diagonal Gaussian.
+ *
+ * @param dist Gaussian to set the variances of.
+ * @param covariance New variances, as a matrix with one column.
+ */
+inline void SetCovariance(distribution::DiagonalGaussianDistribution& dist,
+                          const arma::mat& covariance)
+{
+  dist.Variances(covariance.col(0));
+}
+
+/**
+ * Apply the covariance constraint to the given covariance, and set it as the
+ * covariance of the given Gaussian.  If the covariance has one column, it is
+ * the diagonal of the covariance matrix (or the variances, for a diagonal
+ * Gaussian).
+ *
+ * @param constraint Constraint to apply.
+ * @param dist Gaussian to set the covariance of.
+ * @param covariance New covariance (or its diagonal).
+ */
+template<typename CovarianceConstraintPolicy, typename Distribution>
+void SetCovariance(const CovarianceConstraintPolicy& constraint,
+                   Distribution& dist,
+                   const arma::mat& covariance)
+{
+  arma::mat constrainedCovariance(covariance);
+  ConstrainCovariance(constraint, dist, constrainedCovariance);
+  SetCovariance(dist, constrainedCovariance);
+}
+
+}; // namespace gmm
+}; // namespace mlpack
+
+#endif
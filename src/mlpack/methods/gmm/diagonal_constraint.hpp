@@ -25,6 +25,9 @@ class DiagonalConstraint
     arma::vec diagonal = covariance.diag();
     covariance = arma::diagmat(diagonal);
   }
+
+  //! A covariance stored as its vector of variances is already diagonal.
+  static void ApplyConstraint(arma::vec& /* variances */) { }
 };
 
 }; // namespace gmm
@@ -69,6 +69,20 @@ class EigenvalueRatioConstraint
     covariance = eigenvectors * arma::diagmat(eigenvalues) * eigenvectors.t();
   }
 
+  /**
+   * Apply the eigenvalue ratio constraint to the given diagonal covariance
+   * matrix, stored as the vector of its variances.  The variances are the
+   * eigenvalues, so no eigendecomposition is needed; they are changed in the
+   * same (ascending) order that ApplyConstraint(arma::mat&) uses.
+   */
+  void ApplyConstraint(arma::vec& variances) const
+  {
+    const arma::uvec order = arma::sort_index(variances);
+    const double smallest = variances[order[0]];
+    for (size_t i = 0; i < order.n_elem; ++i)
+      variances[order[i]] = smallest * ratios[i];
+  }
+
  private:
   //! Ratios for eigenvalues.
   const arma::vec& ratios;
@@ -15,6 +15,8 @@
 #include <mlpack/methods/kmeans/kmeans.hpp>
 // Default covariance matrix constraint.
 #include "positive_definite_constraint.hpp"
+#include "diagonal_constraint.hpp"
+#include "covariance_update.hpp"
 
 namespace mlpack {
 namespace gmm {
@@ -31,12 +33,24 @@ namespace gmm {
  *
  * This method should create 'clusters' clusters, and return the assignment of
  * each point to a cluster.
+ *
+ * The components of the mixture are of type Distribution, which may be either
+ * GaussianDistribution (the default) or DiagonalGaussianDistribution.  With
+ * DiagonalGaussianDistribution, only the variance of each dimension is
+ * estimated, so each EM iteration takes time and memory linear in the
+ * dimensionality (instead of quadratic); this is much faster for
+ * high-dimensional data.  The covariance constraint policy is then applied to
+ * the vector of variances.
  */
 template<typename InitialClusteringType = kmeans::KMeans<>,
-         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
 class EMFit
 {
  public:
+  //! The type of the components of the mixture.
+  typedef Distribution DistributionType;
+
   /**
    * Construct the EMFit object, optionally passing an InitialClusteringType
    * object (just in case it needs to store state).  Setting the maximum number
@@ -75,7 +89,7 @@ class EMFit
    *      clustering.
    */
   void Estimate(const arma::mat& observations,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<Distribution>& dists,
                 arma::vec& weights,
                 const bool useInitialModel = false);
 
@@ -98,7 +112,7 @@ class EMFit
    */
   void Estimate(const arma::mat& observations,
                 const arma::vec& probabilities,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<Distribution>& dists,
                 arma::vec& weights,
                 const bool useInitialModel = false);
 
@@ -134,23 +148,43 @@ class EMFit
    * @param weights Vector to store a priori weights in.
    */
   void InitialClustering(const arma::mat& observations,
-                         std::vector<distribution::GaussianDistribution>& dists,
+                         std::vector<Distribution>& dists,
                          arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Perform the E-step of the EM algorithm: compute the conditional probability
+   * of each Gaussian for each observation under the given model, and return
+   * the log-likelihood of the model.  The probabilities are computed in log
+   * space, and blocks of observations are handled in parallel.
+   *
+   * @param observations List of observations.
+   * @param dists Gaussians of the model.
+   * @param weights A priori weights of the model.
+   * @param condProb Matrix to store the conditional probabilities in; it has
+   *     one row for each Gaussian and one column for each observation.
+   * @return The log-likelihood of the model.
+   */
+  double EStep(const arma::mat& observations,
+               const std::vector<Distribution>& dists,
+               const arma::vec& weights,
+               arma::mat& condProb) const;
+
+  /**
+   * Perform the M-step of the EM algorithm: update the means and covariances
+   * of the Gaussians from the given (possibly weighted) conditional
+   * probabilities.  The sums are accumulated over blocks of observations in
+   * parallel.  The weights are set to the sum of the conditional probabilities
+   * of each Gaussian, and must be normalized by the caller.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param covariances Vector of covariance matrices.
-   * @param weights Vector of a priori weights.
+   * @param observations List of observations.
+   * @param condProb Conditional probabilities, as computed by EStep().
+   * @param dists Gaussians to update.
+   * @param weights Vector to store the unnormalized weights in.
    */
-  double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
-                       const arma::vec& weights) const;
+  void MStep(const arma::mat& observations,
+             const arma::mat& condProb,
+             std::vector<Distribution>& dists,
+             arma::vec& weights);
 
   //! Maximum iterations of EM algorithm.
   size_t maxIterations;
@@ -15,36 +15,41 @@ namespace mlpack {
 namespace gmm {
 
 //! Constructor.
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EMFit(
-    const size_t maxIterations,
-    const double tolerance,
-    InitialClusteringType clusterer,
-    CovarianceConstraintPolicy constraint) :
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+EMFit(const size_t maxIterations,
+      const double tolerance,
+      InitialClusteringType clusterer,
+      CovarianceConstraintPolicy constraint) :
     maxIterations(maxIterations),
     tolerance(tolerance),
     clusterer(clusterer),
     constraint(constraint)
 { /* Nothing to do. */ }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
-    const arma::mat& observations,
-    std::vector<distribution::GaussianDistribution>& dists,
-    arma::vec& weights,
-    const bool useInitialModel)
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Estimate(const arma::mat& observations,
+         std::vector<Distribution>& dists,
+         arma::vec& weights,
+         const bool useInitialModel)
 {
   // Only perform initial clustering if the user wanted it.
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The E-step gives the log-likelihood of the model for free.
+  arma::mat condProb;
+  double l = EStep(observations, dists, weights, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -53,155 +58,65 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
+    // Update the model with the conditional probabilities from the last E-step.
+    MStep(observations, condProb, dists, weights);
+    weights /= observations.n_cols;
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0)
-        dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0.0)
-        dists[i].Covariance() = (tmp * trans(tmpB)) / probRowSums[i];
-
-      // Apply covariance constraint.
-      constraint.ApplyConstraint(dists[i].Covariance());
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = probRowSums / observations.n_cols;
-
-    // Update values of l; calculate new log-likelihood.
+    // Calculate the new conditional probabilities and log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = EStep(observations, dists, weights, condProb);
 
     iteration++;
   }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
-    const arma::mat& observations,
-    const arma::vec& probabilities,
-    std::vector<distribution::GaussianDistribution>& dists,
-    arma::vec& weights,
-    const bool useInitialModel)
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Estimate(const arma::mat& observations,
+         const arma::vec& probabilities,
+         std::vector<Distribution>& dists,
+         arma::vec& weights,
+         const bool useInitialModel)
 {
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  arma::mat condProb;
+  double l = EStep(observations, dists, weights, condProb);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
+  const double probabilitySum = accu(probabilities);
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
+    // The conditional probability of each point being from Gaussian i is
+    // multiplied by the probability of the point being from this mixture model.
+    condProb %= arma::ones<arma::vec>(condProb.n_rows) * trans(probabilities);
 
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
+    MStep(observations, condProb, dists, weights);
+    weights /= probabilitySum;
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      probRowSums[i] = accu(condProb.col(i) % probabilities);
-
-      dists[i].Mean() = (observations * (condProb.col(i) % probabilities)) /
-        probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      dists[i].Covariance() = (tmp * trans(tmpB)) / probRowSums[i];
-
-      // Apply covariance constraint.
-      constraint.ApplyConstraint(dists[i].Covariance());
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = probRowSums / accu(probabilities);
-
-    // Update values of l; calculate new log-likelihood.
+    // Calculate the new conditional probabilities and log-likelihood.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = EStep(observations, dists, weights, condProb);
 
     iteration++;
   }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
 InitialClustering(const arma::mat& observations,
-                  std::vector<distribution::GaussianDistribution>& dists,
+                  std::vector<Distribution>& dists,
                   arma::vec& weights)
 {
   // Assignments from clustering.
@@ -210,12 +125,18 @@ InitialClustering(const arma::mat& observations,
   // Run clustering algorithm.
   clusterer.Cluster(observations, dists.size(), assignments);
 
-  // Now calculate the means, covariances, and weights.
+  // Now calculate the means, covariances, and weights.  The covariances are
+  // accumulated separately and set at the end; if they are diagonal, only the
+  // variances are accumulated.
+  const bool diagonal = DiagonalCovariances<CovarianceConstraintPolicy,
+      Distribution>::value;
   weights.zeros();
+  std::vector<arma::mat> covariances(dists.size());
   for (size_t i = 0; i < dists.size(); ++i)
   {
     dists[i].Mean().zeros();
-    dists[i].Covariance().zeros();
+    covariances[i].zeros(observations.n_rows,
+        diagonal ? 1 : observations.n_rows);
   }
 
   // From the assignments, generate our means, covariances, and weights.
@@ -227,8 +148,10 @@ InitialClustering(const arma::mat& observations,
     dists[cluster].Mean() += observations.col(i);
 
     // Add this to the relevant covariance.
-    dists[cluster].Covariance() += observations.col(i) *
-        trans(observations.col(i));
+    if (diagonal)
+      covariances[cluster] += observations.col(i) % observations.col(i);
+    else
+      covariances[cluster] += observations.col(i) * trans(observations.col(i));
 
     // Now add one to the weights (we will normalize).
     weights[cluster]++;
@@ -244,47 +167,173 @@ InitialClustering(const arma::mat& observations,
   {
     const size_t cluster = assignments[i];
     const arma::vec normObs = observations.col(i) - dists[cluster].Mean();
-    dists[cluster].Covariance() += normObs * normObs.t();
+    if (diagonal)
+      covariances[cluster] += normObs % normObs;
+    else
+      covariances[cluster] += normObs * normObs.t();
   }
 
   for (size_t i = 0; i < dists.size(); ++i)
   {
-    dists[i].Covariance() /= (weights[i] > 1) ? weights[i] : 1;
+    covariances[i] /= (weights[i] > 1) ? weights[i] : 1;
 
     // Apply constraints to covariance matrix.
-    constraint.ApplyConstraint(dists[i].Covariance());
+    SetCovariance(constraint, dists[i], covariances[i]);
   }
 
   // Finally, normalize weights.
   weights /= accu(weights);
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
-    const arma::mat& observations,
-    const std::vector<distribution::GaussianDistribution>& dists,
-    const arma::vec& weights) const
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+EStep(const arma::mat& observations,
+      const std::vector<Distribution>& dists,
+      const arma::vec& weights,
+      arma::mat& condProb) const
 {
-  double logLikelihood = 0;
+  condProb.set_size(dists.size(), observations.n_cols);
+  const arma::vec logWeights = log(weights);
+
+  // Each block of observations is independent.  We work with log
+  // probabilities, and normalize each column with the log-sum-exp trick, so
+  // that points far from every Gaussian (which is common in high dimensions)
+  // don't underflow to a probability of 0 for every Gaussian.  The
+  // log-likelihood of each point is the log of its normalizing constant.
+  double logLikelihood;
+  math::ParallelColumnReduce(0, observations.n_cols, [&](const size_t begin,
+      const size_t end, double& blockLogLikelihood)
+  {
+    blockLogLikelihood = 0;
+    if (begin == end)
+      return;
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
-  
+    const arma::mat block = observations.cols(begin, end - 1);
+    arma::vec logPhis;
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(block, logPhis);
+      condProb.submat(i, begin, i, end - 1) = logWeights[i] + trans(logPhis);
+    }
+
+    for (size_t j = begin; j < end; ++j)
+    {
+      const double maxLogProb = condProb.col(j).max();
+
+      // If the probability for everything is 0, we don't want to make it NaN.
+      if (maxLogProb == -std::numeric_limits<double>::infinity())
+      {
+        condProb.col(j).zeros();
+        blockLogLikelihood += maxLogProb;
+        continue;
+      }
+
+      const double logSum = maxLogProb + log(accu(exp(condProb.col(j) -
+          maxLogProb)));
+      condProb.col(j) = exp(condProb.col(j) - logSum);
+      blockLogLikelihood += logSum;
+    }
+  }, logLikelihood, 256);
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+MStep(const arma::mat& observations,
+      const arma::mat& condProb,
+      std::vector<Distribution>& dists,
+      arma::vec& weights)
+{
+  const size_t dimensionality = observations.n_rows;
+
+  // Store the sum of the probability of each Gaussian over all the
+  // observations, and the weighted sum of the observations for each Gaussian.
+  // Both are summed over blocks of observations in parallel.
+  arma::vec probRowSums;
+  arma::mat weightedSums;
+  math::ParallelColumnReduce(0, observations.n_cols, [&](const size_t begin,
+      const size_t end, arma::vec& blockProbSums, arma::mat& blockSums)
+  {
+    blockProbSums.zeros(dists.size());
+    blockSums.zeros(dimensionality, dists.size());
+    if (begin == end)
+      return;
+
+    blockProbSums = trans(arma::sum(condProb.cols(begin, end - 1), 1));
+    blockSums = observations.cols(begin, end - 1) *
+        trans(condProb.cols(begin, end - 1));
+  }, probRowSums, weightedSums, 256);
+
+  // Calculate the new value of the means.  Don't update if there's no
+  // probability of the Gaussian having points.
   for (size_t i = 0; i < dists.size(); ++i)
+    if (probRowSums[i] != 0.0)
+      dists[i].Mean() = weightedSums.col(i) / probRowSums[i];
+
+  // Calculate the new value of the covariances using the updated conditional
+  // probabilities and the updated means.  If the covariances are diagonal, we
+  // only need the weighted variance of each dimension, which is much cheaper
+  // than the full covariance.
+  const bool diagonal = DiagonalCovariances<CovarianceConstraintPolicy,
+      Distribution>::value;
+  arma::cube covariances;
+  math::ParallelColumnReduce(0, observations.n_cols, [&](const size_t begin,
+      const size_t end, arma::cube& blockCovariances)
   {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
+    blockCovariances.zeros(dimensionality, diagonal ? 1 : dimensionality,
+        dists.size());
+    if (begin == end)
+      return;
+
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      const arma::mat diffs = observations.cols(begin, end - 1) -
+          (dists[i].Mean() * arma::ones<arma::rowvec>(end - begin));
+      const arma::rowvec probs = condProb(arma::span(i),
+          arma::span(begin, end - 1));
+
+      if (diagonal)
+      {
+        blockCovariances.slice(i) = (diffs % diffs) * trans(probs);
+      }
+      else
+      {
+        const arma::mat weightedDiffs = diffs % (arma::ones<arma::vec>(
+            dimensionality) * probs);
+        blockCovariances.slice(i) = diffs * trans(weightedDiffs);
+      }
+    }
+  }, covariances, 256);
+
+  // Apply the covariance constraints first.  They may write to the log, which
+  // is not thread-safe, so this is done serially.
+  std::vector<arma::mat> newCovariances(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probRowSums[i] != 0.0)
+    {
+      newCovariances[i] = covariances.slice(i) / probRowSums[i];
+      ConstrainCovariance(constraint, dists[i], newCovariances[i]);
+    }
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  // Then set each covariance, so that its factorization is updated.  The
+  // Gaussians are independent, so this is done in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < dists.size(); ++i)
   {
-    if (accu(likelihoods.col(j)) == 0)
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
+    if (probRowSums[i] != 0.0)
+      SetCovariance(dists[i], newCovariances[i]);
   }
-  
-  return logLikelihood;
+
+  // The new weights are the sums of probabilities; the caller normalizes them.
+  weights = probRowSums;
 }
 
 }; // namespace gmm
@@ -25,16 +25,19 @@ namespace gmm /** Gaussian Mixture Models. */ {
  * from this GMM (see GMM::Estimate() for more information).
  *
  * The FittingType template class must provide a way for the GMM to train on
- * data.  It must provide the following two functions:
+ * data.  It must provide a typedef DistributionType, which is the type of the
+ * components of the mixture (usually GaussianDistribution, or
+ * DiagonalGaussianDistribution for Gaussians with diagonal covariance), and the
+ * following two functions:
  *
  * @code
  * void Estimate(const arma::mat& observations,
- *               std::vector<distribution::GaussianDistribution>& dists,
+ *               std::vector<DistributionType>& dists,
  *               arma::vec& weights);
  *
  * void Estimate(const arma::mat& observations,
  *               const arma::vec& probabilities,
- *               std::vector<distribution::GaussianDistribution>& dists,
+ *               std::vector<DistributionType>& dists,
  *               arma::vec& weights);
  * @endcode
  *
@@ -72,6 +75,10 @@ namespace gmm /** Gaussian Mixture Models. */ {
 template<typename FittingType = EMFit<> >
 class GMM
 {
+ public:
+  //! The type of the components of the mixture, given by the fitter.
+  typedef typename FittingType::DistributionType DistributionType;
+
  private:
   //! The number of Gaussians in the model.
   size_t gaussians;
@@ -79,7 +86,7 @@ class GMM
   size_t dimensionality;
 
   //! Vector of Gaussians
-  std::vector<distribution::GaussianDistribution> dists;
+  std::vector<DistributionType> dists;
 
   //! Legacy member data, not used.
   std::vector<arma::vec> means;
@@ -134,7 +141,7 @@ class GMM
    * @param dists Distributions of the model.
    * @param weights Weights of the model.
    */
-  GMM(const std::vector<distribution::GaussianDistribution> & dists,
+  GMM(const std::vector<DistributionType> & dists,
       const arma::vec& weights) :
       gaussians(dists.size()),
       dimensionality((!dists.empty()) ? dists[0].Mean().n_elem : 0),
@@ -152,7 +159,7 @@ class GMM
    * @param covariances Covariances of the model.
    * @param weights Weights of the model.
    */
-  GMM(const std::vector<distribution::GaussianDistribution> & dists,
+  GMM(const std::vector<DistributionType> & dists,
       const arma::vec& weights,
       FittingType& fitter) :
       gaussians(dists.size()),
@@ -232,14 +239,14 @@ class GMM
    *
    * @param i index of component.
    */
-  const distribution::GaussianDistribution& Component(size_t i) const {
+  const DistributionType& Component(size_t i) const {
       return dists[i]; }
   /**
    * Return a reference to a component distribution.
    *
    * @param i index of component.
    */
-  distribution::GaussianDistribution& Component(size_t i) { return dists[i]; }
+  DistributionType& Component(size_t i) { return dists[i]; }
 
   //! Functions from earlier releases give errors
   const std::vector<arma::vec>& Means() const
@@ -296,6 +303,25 @@ class GMM
   double Probability(const arma::vec& observation,
                      const size_t component) const;
 
+  /**
+   * Return the log probability that the given observation came from this
+   * distribution.
+   *
+   * @param observation Observation to evaluate the log probability of.
+   */
+  double LogProbability(const arma::vec& observation) const;
+
+  /**
+   * Compute the log probability of each observation (column) in the given
+   * matrix.  The components are combined with the log-sum-exp trick, so this
+   * does not underflow for observations far from every component.
+   *
+   * @param observations Observations to evaluate the log probabilities of.
+   * @param logProbabilities Output log probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -317,6 +343,13 @@ class GMM
    * is deterministic after the initial position is given, then 'trials' should
    * be set to 1.
    *
+   * If OpenMP is available, the trials are run concurrently, each on its own
+   * copy of the fitter and with its own stream of random numbers.  The streams
+   * are seeded from mlpack's random number generator, so the result does not
+   * depend on the number of threads.  Log output is not thread-safe, so the
+   * fitter's own output (Log::Info, Log::Warn, and Log::Debug) is not shown
+   * while the trials run; the log-likelihood of each trial is still reported.
+   *
    * @tparam FittingType The type of fitting method which should be used
    *     (EMFit<> is suggested).
    * @param observations Observations of the model.
@@ -345,6 +378,13 @@ class GMM
    * is deterministic after the initial position is given, then 'trials' should
    * be set to 1.
    *
+   * If OpenMP is available, the trials are run concurrently, each on its own
+   * copy of the fitter and with its own stream of random numbers.  The streams
+   * are seeded from mlpack's random number generator, so the result does not
+   * depend on the number of threads.  Log output is not thread-safe, so the
+   * fitter's own output (Log::Info, Log::Warn, and Log::Debug) is not shown
+   * while the trials run; the log-likelihood of each trial is still reported.
+   *
    * @param observations Observations of the model.
    * @param probabilities Probability of each observation being from this
    *     distribution.
@@ -399,9 +439,30 @@ class GMM
    * @param weights Weights of the given mixture model.
    */
   double LogLikelihood(const arma::mat& dataPoints,
-                       const std::vector<distribution::GaussianDistribution>& distsL,
+                       const std::vector<DistributionType>& distsL,
                        const arma::vec& weights) const;
 
+  /**
+   * Perform the given number of trials of the given estimation function, and
+   * keep the model with the greatest log-likelihood.  This is used by both
+   * overloads of Estimate().  The estimation function is called as
+   *
+   * @code
+   * estimateTrial(trialFitter, trialDists, trialWeights);
+   * @endcode
+   *
+   * and must fit the given model with the given fitter.
+   *
+   * @param observations Observations to calculate the likelihood for.
+   * @param trials Number of trials to perform.
+   * @param estimateTrial Function that fits one trial.
+   * @return The log-likelihood of the best fit.
+   */
+  template<typename TrialFunctionType>
+  double EstimateTrials(const arma::mat& observations,
+                        const size_t trials,
+                        const TrialFunctionType& estimateTrial);
+
   //! Locally-stored fitting object; in case the user did not pass one.
   FittingType localFitter;
 
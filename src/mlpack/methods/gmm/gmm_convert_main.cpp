@@ -52,7 +52,11 @@ int main(int argc, char* argv[])
     string covName = "covariance" + o.str();
 
     load.LoadParameter(gmm.Component(i).Mean(), meanName);
-    load.LoadParameter(gmm.Component(i).Covariance(), covName);
+
+    // Use the setter so that the factorization of the covariance is cached.
+    arma::mat covariance;
+    load.LoadParameter(covariance, covName);
+    gmm.Component(i).Covariance(covariance);
   }
 
   gmm.Save(CLI::GetParam<string>("output_file"));
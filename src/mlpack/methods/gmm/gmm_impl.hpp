@@ -28,7 +28,7 @@ template<typename FittingType>
 GMM<FittingType>::GMM(const size_t gaussians, const size_t dimensionality) :
     gaussians(gaussians),
     dimensionality(dimensionality),
-    dists(gaussians, distribution::GaussianDistribution(dimensionality)),
+    dists(gaussians, DistributionType(dimensionality)),
     weights(gaussians),
     localFitter(FittingType()),
     fitter(localFitter)
@@ -53,7 +53,7 @@ GMM<FittingType>::GMM(const size_t gaussians,
                       FittingType& fitter) :
     gaussians(gaussians),
     dimensionality(dimensionality),
-    dists(gaussians, distribution::GaussianDistribution(dimensionality)),
+    dists(gaussians, DistributionType(dimensionality)),
     weights(gaussians),
     fitter(fitter)
 {
@@ -208,6 +208,49 @@ double GMM<FittingType>::Probability(const arma::vec& observation,
   return weights[component] * dists[component].Probability(observation);
 }
 
+/**
+ * Return the log probability of the given observation being from this GMM.
+ */
+template<typename FittingType>
+double GMM<FittingType>::LogProbability(const arma::vec& observation) const
+{
+  arma::vec logProbabilities;
+  LogProbability(arma::mat(observation), logProbabilities);
+
+  return logProbabilities[0];
+}
+
+/**
+ * Compute the log probability of each of the given observations being from
+ * this GMM.
+ */
+template<typename FittingType>
+void GMM<FittingType>::LogProbability(const arma::mat& observations,
+                                      arma::vec& logProbabilities) const
+{
+  // Row i holds the log of the weighted probability of each observation under
+  // component i.
+  arma::vec logPhis;
+  arma::mat logComponentProbs(gaussians, observations.n_cols);
+  for (size_t i = 0; i < gaussians; i++)
+  {
+    dists[i].LogProbability(observations, logPhis);
+    logComponentProbs.row(i) = log(weights[i]) + trans(logPhis);
+  }
+
+  // Now sum over the components, with the log-sum-exp trick.
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t j = 0; j < observations.n_cols; j++)
+  {
+    const double maxLogProb = logComponentProbs.col(j).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+      logProbabilities[j] = maxLogProb;
+    else
+      logProbabilities[j] = maxLogProb + log(accu(exp(
+          logComponentProbs.col(j) - maxLogProb)));
+  }
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -230,8 +273,8 @@ arma::vec GMM<FittingType>::Random() const
     }
   }
 
-  return trans(chol(dists[gaussian].Covariance())) *
-      arma::randn<arma::vec>(dimensionality) + dists[gaussian].Mean();
+  // The Gaussian uses its cached Cholesky factor.
+  return dists[gaussian].Random();
 }
 
 /**
@@ -242,78 +285,14 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
                                   const size_t trials,
                                   const bool useExistingModel)
 {
-  double bestLikelihood; // This will be reported later.
-
-  // We don't need to store temporary models if we are only doing one trial.
-  if (trials == 1)
-  {
-    // Train the model.  The user will have been warned earlier if the GMM was
-    // initialized with no parameters (0 gaussians, dimensionality of 0).
-    fitter.Estimate(observations, dists, weights,
-        useExistingModel);
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-  }
-  else
-  {
-    if (trials == 0)
-      return -DBL_MAX; // It's what they asked for...
-
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
-    {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
-
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, dists, weights,
-        useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Info << "GMM::Estimate(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
-    {
-      if (useExistingModel)
+  return EstimateTrials(observations, trials,
+      [&](FittingType& trialFitter,
+          std::vector<DistributionType>& trialDists,
+          arma::vec& trialWeights)
       {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
-      }
-
-      fitter.Estimate(observations, distsTrial, weightsTrial, useExistingModel);
-
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
-
-      Log::Info << "GMM::Estimate(): Log-likelihood of trial " << trial
-          << " is " << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
-      {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
-
-        dists = distsTrial;
-        weights = weightsTrial;
-      }
-    }
-  }
-
-  // Report final log-likelihood and return it.
-  Log::Info << "GMM::Estimate(): log-likelihood of trained GMM is "
-      << bestLikelihood << "." << std::endl;
-  return bestLikelihood;
+        trialFitter.Estimate(observations, trialDists, trialWeights,
+            useExistingModel);
+      });
 }
 
 /**
@@ -325,6 +304,26 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
                                   const arma::vec& probabilities,
                                   const size_t trials,
                                   const bool useExistingModel)
+{
+  return EstimateTrials(observations, trials,
+      [&](FittingType& trialFitter,
+          std::vector<DistributionType>& trialDists,
+          arma::vec& trialWeights)
+      {
+        trialFitter.Estimate(observations, probabilities, trialDists,
+            trialWeights, useExistingModel);
+      });
+}
+
+/**
+ * Run the given number of trials of the estimation function, and keep the model
+ * with the greatest log-likelihood.
+ */
+template<typename FittingType>
+template<typename TrialFunctionType>
+double GMM<FittingType>::EstimateTrials(const arma::mat& observations,
+                                        const size_t trials,
+                                        const TrialFunctionType& estimateTrial)
 {
   double bestLikelihood; // This will be reported later.
 
@@ -333,8 +332,7 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
   {
     // Train the model.  The user will have been warned earlier if the GMM was
     // initialized with no parameters (0 gaussians, dimensionality of 0).
-    fitter.Estimate(observations, probabilities, dists, weights,
-        useExistingModel);
+    estimateTrial(fitter, dists, weights);
     bestLikelihood = LogLikelihood(observations, dists, weights);
   }
   else
@@ -342,57 +340,63 @@ double GMM<FittingType>::Estimate(const arma::mat& observations,
     if (trials == 0)
       return -DBL_MAX; // It's what they asked for...
 
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
-    {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
-
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, probabilities, dists, weights,
-        useExistingModel);
+    // Each trial is trained on its own copy of the model, which starts from the
+    // existing model (if the fitter is asked to use it, each trial must start
+    // from the same initial location).
+    std::vector<std::vector<DistributionType> >
+        trialDists(trials, dists);
+    std::vector<arma::vec> trialWeights(trials, weights);
+    arma::vec likelihoods(trials);
+
+    // The trials are run concurrently, so each one gets its own stream of
+    // random numbers.  The seeds are drawn in order from the generator of the
+    // calling thread, so the result depends on its seed but not on the number
+    // of threads or the order in which the trials are run.
+    std::vector<size_t> seeds(trials);
+    for (size_t trial = 0; trial < trials; ++trial)
+      seeds[trial] = (size_t) math::RandInt(std::numeric_limits<int>::max());
+
+    // The calling thread runs some of the trials too, so save its generator.
+    const auto oldRandGen = math::randGen;
 
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Debug << "GMM::Estimate(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
     {
-      if (useExistingModel)
+      // The log streams are not thread-safe (and the output of concurrent
+      // trials would be interleaved anyway), so they are silenced while the
+      // trials run.
+      util::LogSilencer silencer;
+
+      #pragma omp parallel for schedule(dynamic)
+      for (size_t trial = 0; trial < trials; ++trial)
       {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
-      }
+        math::ThreadRandomSeed(seeds[trial]);
 
-      fitter.Estimate(observations, distsTrial, weightsTrial,
-          useExistingModel);
+        // Fitters may keep state between calls, so each trial gets a copy.
+        FittingType trialFitter(fitter);
+        estimateTrial(trialFitter, trialDists[trial], trialWeights[trial]);
 
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
+        likelihoods[trial] = LogLikelihood(observations, trialDists[trial],
+            trialWeights[trial]);
+      }
+    }
 
-      Log::Debug << "GMM::Estimate(): Log-likelihood of trial " << trial
-          << " is " << newLikelihood << "." << std::endl;
+    math::randGen = oldRandGen;
+    math::randUniformDist.reset();
+    math::randNormalDist.reset();
 
-      if (newLikelihood > bestLikelihood)
-      {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
+    // Keep the best model; if there are ties, the earliest trial wins.
+    size_t bestTrial = 0;
+    for (size_t trial = 0; trial < trials; ++trial)
+    {
+      Log::Info << "GMM::Estimate(): Log-likelihood of trial " << trial
+          << " is " << likelihoods[trial] << "." << std::endl;
 
-        dists = distsTrial;
-        weights = weightsTrial;
-      }
+      if (likelihoods[trial] > likelihoods[bestTrial])
+        bestTrial = trial;
     }
+
+    bestLikelihood = likelihoods[bestTrial];
+    dists = trialDists[bestTrial];
+    weights = trialWeights[bestTrial];
   }
 
   // Report final log-likelihood and return it.
@@ -436,22 +440,31 @@ void GMM<FittingType>::Classify(const arma::mat& observations,
 template<typename FittingType>
 double GMM<FittingType>::LogLikelihood(
     const arma::mat& data,
-    const std::vector<distribution::GaussianDistribution>& distsL,
+    const std::vector<DistributionType>& distsL,
     const arma::vec& weightsL) const
 {
   double loglikelihood = 0;
-  arma::vec phis;
-  arma::mat likelihoods(gaussians, data.n_cols);
+  arma::vec logPhis;
+  arma::mat logLikelihoods(gaussians, data.n_cols);
 
   for (size_t i = 0; i < gaussians; i++)
   {
-    distsL[i].Probability(data, phis);
-    likelihoods.row(i) = weightsL(i) * trans(phis);
+    distsL[i].LogProbability(data, logPhis);
+    logLikelihoods.row(i) = log(weightsL(i)) + trans(logPhis);
   }
 
-  // Now sum over every point.
+  // Now sum over every point.  The probabilities are summed with the
+  // log-sum-exp trick, because in high dimensions the probability of a point
+  // can underflow for every component.
   for (size_t j = 0; j < data.n_cols; j++)
-    loglikelihood += log(accu(likelihoods.col(j)));
+  {
+    const double maxLogLikelihood = logLikelihoods.col(j).max();
+    if (maxLogLikelihood == -std::numeric_limits<double>::infinity())
+      loglikelihood += maxLogLikelihood;
+    else
+      loglikelihood += maxLogLikelihood + log(accu(exp(logLikelihoods.col(j) -
+          maxLogLikelihood)));
+  }
   return loglikelihood;
 }
 
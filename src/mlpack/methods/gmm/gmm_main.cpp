@@ -34,7 +34,11 @@ PROGRAM_INFO("Gaussian Mixture Model (GMM) Training",
     "iteration of the EM algorithm which ensure that the covariance matrices "
     "are positive definite.  Specifying the flag can cause faster runtime, "
     "but may also cause non-positive definite covariance matrices, which will "
-    "cause the program to crash.");
+    "cause the program to crash."
+    "\n\n"
+    "The trials are run concurrently, and the number of threads can be set "
+    "with --threads.  For a given --seed, the result does not depend on the "
+    "number of threads.");
 
 PARAM_STRING_REQ("input_file", "File containing the data on which the model "
     "will be fit.", "i");
@@ -43,6 +47,7 @@ PARAM_STRING("output_file", "The file to write the trained GMM parameters into "
     "(as XML).", "o", "gmm.xml");
 PARAM_INT("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 PARAM_INT("trials", "Number of trials to perform in training GMM.", "t", 10);
+PARAM_THREADS();
 
 // Parameters for EM algorithm.
 PARAM_DOUBLE("tolerance", "Tolerance for convergence of EM.", "T", 1e-10);
@@ -74,6 +79,8 @@ int main(int argc, char* argv[])
   else
     math::RandomSeed((size_t) std::time(NULL));
 
+  CLI::SetNumThreads("threads");
+
   arma::mat dataPoints;
   data::Load(CLI::GetParam<string>("input_file"), dataPoints,
       true);
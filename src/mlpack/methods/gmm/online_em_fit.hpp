@@ -0,0 +1,253 @@
+/**
+ * @file online_em_fit.hpp
+ *
+ * Utility class to fit a GMM to a stream of observations with online
+ * (stepwise) EM.  Used by GMM::Estimate<>().
+ */
+#ifndef __MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define __MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/core.hpp>
+
+// The initial model is found with the regular EM fitter.
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM with online (stepwise) EM.  Instead of iterating over
+ * the whole dataset, the observations are visited in mini-batches, and each
+ * mini-batch takes one step: the expected sufficient statistics of the model
+ * (the sum of the conditional probabilities of each Gaussian, and the weighted
+ * first and second moments of the observations) are computed on the batch, and
+ * the statistics of the model are moved towards them by a step size that
+ * decreases with the number of steps taken.  The parameters of the model are
+ * then computed from the statistics.  For more information, see
+ *
+ * @code
+ * @inproceedings{liang2009online,
+ *   title={Online EM for unsupervised models},
+ *   author={Liang, Percy and Klein, Dan},
+ *   booktitle={Proceedings of Human Language Technologies: The 2009 Annual
+ *       Conference of the North American Chapter of the Association for
+ *       Computational Linguistics},
+ *   pages={611--619},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * The statistics are kept in this object between calls to Estimate(), so a
+ * model can be kept up to date with an unbounded stream of observations while
+ * only holding one batch of them in memory:
+ *
+ * @code
+ * GMM<OnlineEMFit<> > gmm(gaussians, dimensionality);
+ *
+ * // The first batch is clustered to find the initial model.
+ * gmm.Estimate(firstBatch);
+ *
+ * // Each following batch updates the model.
+ * while (ReadBatch(batch))
+ *   gmm.Estimate(batch, 1, true);
+ * @endcode
+ *
+ * When Estimate() is called with useInitialModel set to false, the initial
+ * model is found from the given observations as EMFit does (with the
+ * InitialClusteringType), and the statistics and the number of steps are reset.
+ * The step size for step t is max(minStepSize, (t + 2)^(-stepSizeExponent)),
+ * where the exponent must be in (0.5, 1] for the model to converge on a
+ * stationary stream; a positive minimum step size makes the model keep
+ * adapting, forgetting old observations at an exponential rate.  If the model
+ * passed to Estimate() was not produced by the last call (for instance, if it
+ * was loaded, or trained with several trials), the statistics are first
+ * computed from the model itself.
+ *
+ * The template parameters have the same meaning as for EMFit.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class OnlineEMFit
+{
+ public:
+  //! The type of the components of the mixture.
+  typedef Distribution DistributionType;
+
+  /**
+   * Construct the OnlineEMFit object.
+   *
+   * @param batchSize Number of observations in each mini-batch.
+   * @param stepSizeExponent Exponent of the decay of the step size.
+   * @param minStepSize Smallest step size to take.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Object which applies constraints to the covariances.
+   */
+  OnlineEMFit(const size_t batchSize = 100,
+              const double stepSizeExponent = 0.7,
+              const double minStepSize = 0.0,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Update the model with the given observations, taking one step of online
+   * EM for each mini-batch.  If useInitialModel is false, the initial model is
+   * first found from the observations, and the statistics are reset.
+   *
+   * @param observations Observations to update the model with.
+   * @param dists Gaussians of the model.
+   * @param weights A priori weights of the model.
+   * @param useInitialModel If true, the given model is updated; otherwise, a
+   *     new model is found.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Update the model with the given observations, taking into account the
+   * probability of each observation being from this mixture.  Otherwise this
+   * is the same as the other overload of Estimate().
+   *
+   * @param observations Observations to update the model with.
+   * @param probabilities Probability of each observation being from this
+   *     mixture.
+   * @param dists Gaussians of the model.
+   * @param weights A priori weights of the model.
+   * @param useInitialModel If true, the given model is updated; otherwise, a
+   *     new model is found.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Get the number of observations in each mini-batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of observations in each mini-batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the exponent of the decay of the step size.
+  double StepSizeExponent() const { return stepSizeExponent; }
+  //! Modify the exponent of the decay of the step size.
+  double& StepSizeExponent() { return stepSizeExponent; }
+
+  //! Get the smallest step size.
+  double MinStepSize() const { return minStepSize; }
+  //! Modify the smallest step size.
+  double& MinStepSize() { return minStepSize; }
+
+  //! Get the number of steps taken since the statistics were reset.
+  size_t Steps() const { return steps; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+ private:
+  /**
+   * Update the model with the given (weighted) observations.  This is the
+   * implementation of both overloads of Estimate().
+   *
+   * @param observations Observations to update the model with.
+   * @param probabilities Probability of each observation, or an empty vector
+   *     if the observations are not weighted.
+   * @param dists Gaussians of the model.
+   * @param weights A priori weights of the model.
+   * @param useInitialModel If true, the given model is updated.
+   */
+  void Update(const arma::mat& observations,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights,
+              const bool useInitialModel);
+
+  /**
+   * Set the statistics to those of the given model.  This is done when the
+   * model was not produced by the last call to Estimate().
+   *
+   * @param dists Gaussians of the model.
+   * @param weights A priori weights of the model.
+   */
+  void InitializeStatistics(const std::vector<Distribution>& dists,
+                            const arma::vec& weights);
+
+  /**
+   * Return whether or not the given model is the one given by the statistics.
+   *
+   * @param dists Gaussians of the model.
+   * @param weights A priori weights of the model.
+   */
+  bool StatisticsMatch(const std::vector<Distribution>& dists,
+                       const arma::vec& weights) const;
+
+  /**
+   * Take one step of online EM with the given batch of observations.
+   *
+   * @param batch Observations in the batch.
+   * @param batchProbabilities Probability of each observation, or an empty
+   *     vector if the observations are not weighted.
+   * @param dists Gaussians of the model.
+   * @param weights A priori weights of the model.
+   */
+  void Step(const arma::mat& batch,
+            const arma::vec& batchProbabilities,
+            const std::vector<Distribution>& dists,
+            const arma::vec& weights);
+
+  /**
+   * Compute the parameters of the model from the statistics.
+   *
+   * @param dists Gaussians to set.
+   * @param weights Vector to store the a priori weights in.
+   */
+  void UpdateModel(std::vector<Distribution>& dists, arma::vec& weights);
+
+  //! Get the covariance of a Gaussian, or only its diagonal if the covariances
+  //! are diagonal.
+  static arma::mat Covariance(const distribution::GaussianDistribution& dist);
+
+  //! Get the variances of a diagonal Gaussian.
+  static arma::mat Covariance(
+      const distribution::DiagonalGaussianDistribution& dist);
+
+  //! Number of observations in each mini-batch.
+  size_t batchSize;
+  //! Exponent of the decay of the step size.
+  double stepSizeExponent;
+  //! Smallest step size.
+  double minStepSize;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! Number of steps taken since the statistics were reset.
+  size_t steps;
+  //! Expected probability of each Gaussian.
+  arma::vec probabilitySums;
+  //! Expected weighted sum of the observations, for each Gaussian (one column
+  //! for each Gaussian).
+  arma::mat firstMoments;
+  //! Expected weighted second moment of the observations, for each Gaussian
+  //! (one slice for each Gaussian).  If the covariances are diagonal, each
+  //! slice has only one column.
+  arma::cube secondMoments;
+};
+
+}; // namespace gmm
+}; // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
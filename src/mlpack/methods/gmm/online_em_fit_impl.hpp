@@ -0,0 +1,324 @@
+/**
+ * @file online_em_fit_impl.hpp
+ *
+ * Implementation of online (stepwise) EM for fitting GMMs.
+ */
+#ifndef __MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define __MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+OnlineEMFit(const size_t batchSize,
+            const double stepSizeExponent,
+            const double minStepSize,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    stepSizeExponent(stepSizeExponent),
+    minStepSize(minStepSize),
+    clusterer(clusterer),
+    constraint(constraint),
+    steps(0)
+{
+  if (stepSizeExponent <= 0.5 || stepSizeExponent > 1.0)
+    Log::Warn << "OnlineEMFit::OnlineEMFit(): step size exponent "
+        << stepSizeExponent << " is not in (0.5, 1]; the model may not "
+        << "converge." << std::endl;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  Update(observations, arma::vec(), dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  Update(observations, probabilities, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& observations,
+                          const arma::vec& probabilities,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights,
+                          const bool useInitialModel)
+{
+  if (batchSize == 0)
+  {
+    Log::Fatal << "OnlineEMFit::Estimate(): batch size must be greater than 0!"
+        << std::endl;
+  }
+
+  if (!useInitialModel)
+  {
+    // Find the initial model the same way EMFit does.  With a maximum of one
+    // iteration, EMFit does nothing but the initial clustering.
+    EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+        initialFit(1, 0.0, clusterer, constraint);
+    initialFit.Estimate(observations, dists, weights);
+
+    steps = 0;
+    InitializeStatistics(dists, weights);
+  }
+  else if (!StatisticsMatch(dists, weights))
+  {
+    // The model was not produced by this object (or was changed since), so
+    // continue from the model itself.
+    Log::Debug << "OnlineEMFit::Estimate(): model does not match the "
+        << "statistics; recomputing them from the model." << std::endl;
+    InitializeStatistics(dists, weights);
+  }
+
+  // Take one step for each mini-batch, in order.
+  for (size_t begin = 0; begin < observations.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize,
+        (size_t) observations.n_cols);
+
+    arma::vec batchProbabilities;
+    if (probabilities.n_elem > 0)
+      batchProbabilities = probabilities.subvec(begin, end - 1);
+
+    Step(observations.cols(begin, end - 1), batchProbabilities, dists,
+        weights);
+    UpdateModel(dists, weights);
+  }
+
+  Log::Info << "OnlineEMFit::Estimate(): " << steps << " steps taken."
+      << std::endl;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitializeStatistics(const std::vector<Distribution>& dists,
+                                        const arma::vec& weights)
+{
+  const bool diagonal = DiagonalCovariances<CovarianceConstraintPolicy,
+      Distribution>::value;
+  const size_t dimensionality = dists.empty() ? 0 : dists[0].Mean().n_elem;
+
+  // The statistics of a model are its weights, and the weighted first and
+  // second (uncentered) moments of each Gaussian.
+  probabilitySums = weights;
+  firstMoments.set_size(dimensionality, dists.size());
+  secondMoments.set_size(dimensionality, diagonal ? 1 : dimensionality,
+      dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::vec& mean = dists[i].Mean();
+    firstMoments.col(i) = weights[i] * mean;
+    if (diagonal)
+      secondMoments.slice(i) = weights[i] * (Covariance(dists[i]) +
+          mean % mean);
+    else
+      secondMoments.slice(i) = weights[i] * (Covariance(dists[i]) +
+          mean * trans(mean));
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+bool OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::StatisticsMatch(const std::vector<Distribution>& dists,
+                                   const arma::vec& weights) const
+{
+  if (probabilitySums.n_elem != dists.size() ||
+      weights.n_elem != dists.size() ||
+      firstMoments.n_rows != (dists.empty() ? 0 : dists[0].Mean().n_elem))
+    return false;
+
+  // The model is computed from the statistics by UpdateModel(), which gives
+  // exactly the same weights and means each time.
+  const arma::vec expectedWeights = probabilitySums / accu(probabilitySums);
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (weights[i] != expectedWeights[i])
+      return false;
+
+    if (probabilitySums[i] != 0.0 && arma::accu(dists[i].Mean() !=
+        firstMoments.col(i) / probabilitySums[i]) != 0)
+      return false;
+  }
+
+  return true;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& batch,
+                        const arma::vec& batchProbabilities,
+                        const std::vector<Distribution>& dists,
+                        const arma::vec& weights)
+{
+  const bool diagonal = DiagonalCovariances<CovarianceConstraintPolicy,
+      Distribution>::value;
+
+  // Compute the conditional probability of each Gaussian for each observation
+  // in log space, normalizing with the log-sum-exp trick (as EMFit does).
+  arma::mat condProb(dists.size(), batch.n_cols);
+  arma::vec logPhis;
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].LogProbability(batch, logPhis);
+    condProb.row(i) = log(weights[i]) + trans(logPhis);
+  }
+
+  for (size_t j = 0; j < batch.n_cols; ++j)
+  {
+    const double maxLogProb = condProb.col(j).max();
+
+    // If the probability for everything is 0, we don't want to make it NaN.
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      condProb.col(j).zeros();
+      continue;
+    }
+
+    condProb.col(j) = exp(condProb.col(j) - (maxLogProb +
+        log(accu(exp(condProb.col(j) - maxLogProb)))));
+  }
+
+  double batchWeight = batch.n_cols;
+  if (batchProbabilities.n_elem > 0)
+  {
+    condProb %= arma::ones<arma::vec>(condProb.n_rows) *
+        trans(batchProbabilities);
+    batchWeight = accu(batchProbabilities);
+  }
+
+  // A batch with no weight doesn't tell us anything.
+  if (batchWeight == 0.0)
+    return;
+
+  // Move the statistics towards the statistics of the batch (normalized to
+  // the weight of one observation, like the statistics of the model).
+  const double stepSize = std::max(minStepSize,
+      std::pow((double) steps + 2.0, -stepSizeExponent));
+  ++steps;
+
+  probabilitySums = (1.0 - stepSize) * probabilitySums +
+      (stepSize / batchWeight) * arma::sum(condProb, 1);
+  firstMoments = (1.0 - stepSize) * firstMoments +
+      (stepSize / batchWeight) * (batch * trans(condProb));
+
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (diagonal)
+    {
+      secondMoments.slice(i) = (1.0 - stepSize) * secondMoments.slice(i) +
+          (stepSize / batchWeight) * ((batch % batch) * trans(condProb.row(i)));
+    }
+    else
+    {
+      const arma::mat weightedBatch = batch % (arma::ones<arma::vec>(
+          batch.n_rows) * condProb.row(i));
+      secondMoments.slice(i) = (1.0 - stepSize) * secondMoments.slice(i) +
+          (stepSize / batchWeight) * (batch * trans(weightedBatch));
+    }
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::UpdateModel(std::vector<Distribution>& dists,
+                               arma::vec& weights)
+{
+  const bool diagonal = DiagonalCovariances<CovarianceConstraintPolicy,
+      Distribution>::value;
+
+  weights = probabilitySums / accu(probabilitySums);
+
+  // Compute the new covariances and apply the covariance constraints first.
+  // The constraints may write to the log, which is not thread-safe, so this is
+  // done serially.
+  std::vector<arma::mat> covariances(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (probabilitySums[i] == 0.0)
+      continue;
+
+    const arma::vec mean = firstMoments.col(i) / probabilitySums[i];
+    dists[i].Mean() = mean;
+
+    if (diagonal)
+      covariances[i] = secondMoments.slice(i) / probabilitySums[i] -
+          mean % mean;
+    else
+      covariances[i] = secondMoments.slice(i) / probabilitySums[i] -
+          mean * trans(mean);
+
+    ConstrainCovariance(constraint, dists[i], covariances[i]);
+  }
+
+  // Then set each covariance, so that its factorization is updated.  Each
+  // Gaussian is independent, so this is done in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (probabilitySums[i] != 0.0)
+      SetCovariance(dists[i], covariances[i]);
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+arma::mat OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Covariance(const distribution::GaussianDistribution& dist)
+{
+  if (DiagonalCovariances<CovarianceConstraintPolicy,
+      Distribution>::value)
+    return arma::mat(dist.Covariance().diag());
+  else
+    return dist.Covariance();
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+arma::mat OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Covariance(
+    const distribution::DiagonalGaussianDistribution& dist)
+{
+  return dist.Variances();
+}
+
+}; // namespace gmm
+}; // namespace mlpack
+
+#endif
@@ -39,6 +39,26 @@ class PositiveDefiniteConstraint
       }
     }
   }
+
+  /**
+   * Apply the positive definiteness constraint to the given diagonal
+   * covariance matrix, stored as the vector of its variances.  This only needs
+   * each variance to be positive.
+   *
+   * @param variances Diagonal of the covariance matrix.
+   */
+  static void ApplyConstraint(arma::vec& variances)
+  {
+    for (size_t i = 0; i < variances.n_elem; ++i)
+    {
+      if (variances[i] <= 1e-50)
+      {
+        Log::Debug << "Variance " << i << " is not positive.  Adding "
+            << "perturbation." << std::endl;
+        variances[i] = 1e-50;
+      }
+    }
+  }
 };
 
 }; // namespace gmm
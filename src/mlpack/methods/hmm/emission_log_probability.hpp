@@ -0,0 +1,69 @@
+/**
+ * @file emission_log_probability.hpp
+ *
+ * Evaluation of the log probabilities of a batch of observations under an
+ * emission distribution, using the distribution's own batch LogProbability()
+ * when it has one.
+ */
+#ifndef __MLPACK_METHODS_HMM_EMISSION_LOG_PROBABILITY_HPP
+#define __MLPACK_METHODS_HMM_EMISSION_LOG_PROBABILITY_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * An emission distribution may optionally implement
+ *
+ *   void LogProbability(const arma::mat& observations,
+ *                       arma::vec& logProbabilities) const;
+ *
+ * which stores the log probability of each observation (column).  This is
+ * usually much faster than calling Probability() once for each observation,
+ * and does not underflow for observations that are very unlikely.
+ */
+HAS_MEM_FUNC(LogProbability, HasLogProbabilitySignature);
+
+//! Whether or not Distribution implements the batch LogProbability().
+template<typename Distribution>
+struct HasBatchLogProbability
+{
+  static const bool value = HasLogProbabilitySignature<Distribution,
+      void(Distribution::*)(const arma::mat&, arma::vec&) const>::value;
+};
+
+/**
+ * Compute the log probability of each observation with the distribution's
+ * batch LogProbability().
+ */
+template<typename Distribution>
+typename boost::enable_if_c<HasBatchLogProbability<Distribution>::value>::type
+EmissionLogProbability(const Distribution& distribution,
+                       const arma::mat& observations,
+                       arma::vec& logProbabilities)
+{
+  distribution.LogProbability(observations, logProbabilities);
+}
+
+/**
+ * Compute the log probability of each observation, for a distribution without
+ * the batch LogProbability().
+ */
+template<typename Distribution>
+typename boost::disable_if_c<HasBatchLogProbability<Distribution>::value>::type
+EmissionLogProbability(const Distribution& distribution,
+                       const arma::mat& observations,
+                       arma::vec& logProbabilities)
+{
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    logProbabilities[i] = log(distribution.Probability(
+        observations.unsafe_col(i)));
+}
+
+}; // namespace hmm
+}; // namespace mlpack
+
+#endif
@@ -11,6 +11,8 @@
 
 #include <mlpack/core.hpp>
 
+#include "emission_log_probability.hpp"
+
 namespace mlpack {
 namespace hmm /** Hidden Markov Models. */ {
 
@@ -50,6 +52,14 @@ namespace hmm /** Hidden Markov Models. */ {
  * Gaussians (GMM), or any other probability distribution implementing the
  * four Distribution functions.
  *
+ * The distribution may also implement a batch LogProbability() function (see
+ * EmissionLogProbability()), like GaussianDistribution and GMM do.  The HMM
+ * evaluates the emission probabilities of all observations of a sequence at
+ * once, and this is then much faster, and does not underflow for observations
+ * that are unlikely under every state.  For high-dimensional observations,
+ * DiagonalGaussianDistribution (or a GMM of them) is much cheaper than
+ * GaussianDistribution, since its cost is linear in the dimensionality.
+ *
  * Usage of the HMM class generally involves either training an HMM or loading
  * an already-known HMM and taking probability measurements of sequences.
  * Example code for supervised training of a Gaussian HMM (that is, where the
@@ -152,6 +162,11 @@ class HMM
    * log-likelihood of the model between iterations is less than the tolerance,
    * the Baum-Welch algorithm terminates.
    *
+   * If OpenMP is available, the sequences are processed in parallel in each
+   * iteration, using as many threads as OpenMP allows (this can be set with
+   * omp_set_num_threads()).  The results are reduced in a fixed order, so for a
+   * given number of threads they are the same on every run.
+   *
    * @note
    * Train() can be called multiple times with different sequences; each time it
    * is called, it uses the current parameters of the HMM as a starting point
@@ -362,6 +377,59 @@ class HMM
                 const arma::vec& scales,
                 arma::mat& backwardProb) const;
 
+  /**
+   * Compute the log probability of each observation in the given data sequence
+   * under the emission distribution of each state.  The returned matrix has
+   * rows equal to the number of hidden states and columns equal to the number
+   * of observations.  The states are evaluated in parallel.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logEmissionProb Matrix in which log probabilities will be saved.
+   */
+  void LogEmissionProbabilities(const arma::mat& dataSeq,
+                                arma::mat& logEmissionProb) const;
+
+  /**
+   * Compute the emission probabilities of each observation in the given data
+   * sequence, where each column is scaled so that its largest element is 1.
+   * The emission probability of state i at time t is then
+   * emissionProb(i, t) * exp(logShifts[t]).
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionProb Matrix in which scaled probabilities will be saved.
+   * @param logShifts Vector in which the log of the scale of each column will
+   *     be saved.
+   */
+  void EmissionProbabilities(const arma::mat& dataSeq,
+                             arma::mat& emissionProb,
+                             arma::vec& logShifts) const;
+
+  /**
+   * The Forward algorithm, given the (scaled) emission probabilities computed
+   * by EmissionProbabilities().  The scaling factors are relative to the
+   * scaled emission probabilities.
+   *
+   * @param emissionProb Scaled emission probabilities.
+   * @param scales Vector in which scaling factors will be saved.
+   * @param forwardProb Matrix in which forward probabilities will be saved.
+   */
+  void ScaledForward(const arma::mat& emissionProb,
+                     arma::vec& scales,
+                     arma::mat& forwardProb) const;
+
+  /**
+   * The Backward algorithm, given the (scaled) emission probabilities computed
+   * by EmissionProbabilities() and the scaling factors computed from them by
+   * Forward().
+   *
+   * @param emissionProb Scaled emission probabilities.
+   * @param scales Vector of scaling factors.
+   * @param backwardProb Matrix in which backward probabilities will be saved.
+   */
+  void ScaledBackward(const arma::mat& emissionProb,
+                      const arma::vec& scales,
+                      arma::mat& backwardProb) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
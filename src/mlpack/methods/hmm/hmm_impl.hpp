@@ -93,75 +93,88 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
           << dimensionality << " dimensions)." << std::endl;
   }
 
-  // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
-  std::vector<arma::vec> emissionProb(transition.n_cols,
-      arma::vec(totalLength));
+  // Each sequence occupies a contiguous range of columns in the list of
+  // emission observations, which is used for training each distribution.  The
+  // observations don't change, so we only assemble it once.
+  std::vector<size_t> offsets(dataSeq.size());
   arma::mat emissionList(dimensionality, totalLength);
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    sumTime += dataSeq[seq].n_cols;
+  }
+
+  // The probability of each state for each emission observation.
+  arma::mat emissionProb(transition.n_rows, totalLength);
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
   // Markov Models: Estimation and Control", pp. 36-40.
   for (size_t iter = 0; iter < iterations; iter++)
   {
-    // Clear new transition matrix and emission probabilities.
-    arma::vec newInitial(transition.n_rows);
-    newInitial.zeros();
-    arma::mat newTransition(transition.n_rows, transition.n_cols);
-    newTransition.zeros();
-
-    // Reset log likelihood.
-    loglik = 0;
-
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // The sequences are independent, so the E-step is run for blocks of
+    // sequences in parallel.  Each block accumulates its own estimate of the
+    // new transition matrix and its own log-likelihood, and these are summed
+    // in a fixed order, so the result does not depend on thread scheduling.
+    // The state probabilities of each sequence are written to its own columns
+    // of emissionProb, so they need no reduction.
+    arma::mat newTransition;
     {
-      arma::mat stateProb;
-      arma::mat forward;
-      arma::mat backward;
-      arma::vec scales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; t++)
+      // The emission distributions may write to the log (for instance, on an
+      // invalid observation), which is not thread-safe, so it is silenced
+      // while the sequences are processed.
+      util::LogSilencer silencer;
+
+      math::ParallelColumnReduce(0, dataSeq.size(), [&](const size_t begin,
+          const size_t end, arma::mat& blockTransition, double& blockLoglik)
       {
-        for (size_t j = 0; j < transition.n_cols; j++)
-        {
-          // Add to estimate of initial probability for state j.
-          newInitial[j] = stateProb(j, 0);
+        blockTransition.zeros(transition.n_rows, transition.n_cols);
+        blockLoglik = 0;
 
-          if (t < dataSeq[seq].n_cols - 1)
+        arma::mat emissions, forward, backward;
+        arma::vec logShifts, scales;
+        for (size_t seq = begin; seq < end; seq++)
+        {
+          const size_t length = dataSeq[seq].n_cols;
+
+          // Run the forward-backward algorithm, and add the log-likelihood of
+          // this sequence.  This is the E-step.
+          EmissionProbabilities(dataSeq[seq], emissions, logShifts);
+          ScaledForward(emissions, scales, forward);
+          ScaledBackward(emissions, scales, backward);
+          blockLoglik += accu(log(scales)) + accu(logShifts);
+
+          emissionProb.cols(offsets[seq], offsets[seq] + length - 1) =
+              forward % backward;
+
+          // Now re-estimate the parameters.  This is the M-step.
+          //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+          //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+          //           b(i, t + 1)))
+          //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+          //           b(i, t)
+          // Estimate of T_ij (probability of transition from state j to state
+          // i), summed over all time steps in one matrix product.  We postpone
+          // multiplication of the old T_ij until later.  The scaled emission
+          // probabilities give the same result as the actual emission
+          // probabilities, because the scales are scaled the same way.
+          if (length > 1)
           {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
-          }
+            arma::mat next = backward.cols(1, length - 1) %
+                emissions.cols(1, length - 1);
+            for (size_t t = 1; t < length; t++)
+              next.col(t - 1) /= scales[t];
 
-          // Add to list of emission observations, for Distribution::Estimate().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
+            blockTransition += next * trans(forward.cols(0, length - 2));
+          }
         }
-        sumTime++;
-      }
+      }, newTransition, loglik);
     }
 
-    // Normalize the new initial probabilities.
-    if (dataSeq.size() == 0)
-      initial = newInitial / dataSeq.size();
-
     // Assign the new transition matrix.  We use %= (element-wise
     // multiplication) because every element of the new transition matrix must
     // still be multiplied by the old elements (this is the multiplication we
@@ -174,7 +187,10 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
 
     // Now estimate emission probabilities.
     for (size_t state = 0; state < transition.n_cols; state++)
-      emission[state].Estimate(emissionList, emissionProb[state]);
+    {
+      const arma::vec stateProb = trans(emissionProb.row(state));
+      emission[state].Estimate(emissionList, stateProb);
+    }
 
     Log::Debug << "Iteration " << iter << ": log-likelihood " << loglik
         << std::endl;
@@ -286,16 +302,27 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::mat& backwardProb,
                                    arma::vec& scales) const
 {
-  // First run the forward-backward algorithm.
-  Forward(dataSeq, scales, forwardProb);
-  Backward(dataSeq, scales, backwardProb);
+  // First run the forward-backward algorithm.  Both passes use the same
+  // emission probabilities, so we only calculate them once.
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbabilities(dataSeq, emissionProb, logShifts);
+
+  ScaledForward(emissionProb, scales, forwardProb);
+  ScaledBackward(emissionProb, scales, backwardProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
   stateProb = forwardProb % backwardProb;
 
-  // Finally assemble the log-likelihood and return it.
-  return accu(log(scales));
+  // Assemble the log-likelihood.  The scaling factors are relative to the
+  // scaled emission probabilities, so we have to add the shifts back.
+  const double logLikelihood = accu(log(scales)) + accu(logShifts);
+
+  // Return the scaling factors of the actual emission probabilities.
+  scales %= exp(logShifts);
+
+  return logLikelihood;
 }
 
 /**
@@ -372,9 +399,8 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Col<size_t>& stateSeq) const
 {
   // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
+  // probable sequence of states to produce the observed data sequence.  We work
+  // with log probabilities, so that long sequences don't underflow.
   stateSeq.set_size(dataSeq.n_cols);
   arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
   arma::mat stateSeqBack(transition.n_rows, dataSeq.n_cols);
@@ -383,16 +409,16 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   // will be using the rows of the transition matrix.
   arma::mat logTrans(log(trans(transition)));
 
+  // Calculate the log emission probabilities of every observation at once.
+  arma::mat logEmissionProb;
+  LogEmissionProbabilities(dataSeq, logEmissionProb);
+
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
+  logStateProb.col(0) = log(initial) + logEmissionProb.col(0);
   for (size_t state = 0; state < transition.n_rows; state++)
-  {
-    logStateProb(state, 0) = log(initial[state] *
-        emission[state].Probability(dataSeq.unsafe_col(0)));
     stateSeqBack(state, 0) = state;
-  }
 
   // Store the best first state.
   arma::uword index;
@@ -404,9 +430,8 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
     for (size_t j = 0; j < transition.n_rows; j++)
     {
       arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          log(emission[j].Probability(dataSeq.unsafe_col(t)));
-        stateSeqBack(j, t) = index;
+      logStateProb(j, t) = prob.max(index) + logEmissionProb(j, t);
+      stateSeqBack(j, t) = index;
     }
   }
 
@@ -426,13 +451,17 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbabilities(dataSeq, emissionProb, logShifts);
+
   arma::mat forward;
   arma::vec scales;
+  ScaledForward(emissionProb, scales, forward);
 
-  Forward(dataSeq, scales, forward);
-
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(log(scales));
+  // The log-likelihood is the log of the scales for each time step, plus the
+  // log of the scale of each column of the emission probabilities.
+  return accu(log(scales)) + accu(logShifts);
 }
 
 /**
@@ -484,37 +513,128 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& scales,
                                 arma::mat& forwardProb) const
+{
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbabilities(dataSeq, emissionProb, logShifts);
+
+  ScaledForward(emissionProb, scales, forwardProb);
+
+  // Return the scaling factors of the actual emission probabilities.
+  scales %= exp(logShifts);
+}
+
+/**
+ * The Backward procedure (part of the Forward-Backward algorithm).
+ */
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& scales,
+                                 arma::mat& backwardProb) const
+{
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  EmissionProbabilities(dataSeq, emissionProb, logShifts);
+
+  // The given scaling factors are for the actual emission probabilities, so
+  // scale them like the emission probabilities.
+  const arma::vec scaledScales = scales % exp(-logShifts);
+  ScaledBackward(emissionProb, scaledScales, backwardProb);
+}
+
+/**
+ * Compute the log probability of each observation under the emission
+ * distribution of each state.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogEmissionProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& logEmissionProb) const
+{
+  // Each state is evaluated with one batch call to its emission distribution.
+  // The results are stored as columns, so that each thread writes to
+  // contiguous memory, and transposed at the end.
+  arma::mat logProbs(dataSeq.n_cols, transition.n_rows);
+
+  // The emission distributions may write to the log (for instance, on an
+  // invalid observation), which is not thread-safe, so it is silenced while
+  // they run.
+  util::LogSilencer silencer;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t state = 0; state < transition.n_rows; state++)
+  {
+    arma::vec stateLogProbs;
+    EmissionLogProbability(emission[state], dataSeq, stateLogProbs);
+    logProbs.col(state) = stateLogProbs;
+  }
+
+  logEmissionProb = trans(logProbs);
+}
+
+/**
+ * Compute the emission probabilities of each observation, scaled so that the
+ * largest probability at each time step is 1.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionProbabilities(const arma::mat& dataSeq,
+                                              arma::mat& emissionProb,
+                                              arma::vec& logShifts) const
+{
+  LogEmissionProbabilities(dataSeq, emissionProb);
+
+  // Shifting each column of log probabilities by its maximum before taking
+  // the exponential means that an observation which is unlikely under every
+  // state doesn't underflow to zero for all states.  The Forward and Backward
+  // algorithms normalize every time step anyway, so only the log-likelihood
+  // needs to know about the shifts.
+  logShifts.set_size(dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+  {
+    logShifts[t] = emissionProb.col(t).max();
+
+    // If the observation is impossible under every state, there is nothing to
+    // be done.
+    if (logShifts[t] == -std::numeric_limits<double>::infinity())
+      logShifts[t] = 0;
+
+    emissionProb.col(t) = exp(emissionProb.col(t) - logShifts[t]);
+  }
+}
+
+/**
+ * The Forward procedure, given precalculated emission probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ScaledForward(const arma::mat& emissionProb,
+                                      arma::vec& scales,
+                                      arma::mat& forwardProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
-  scales.zeros(dataSeq.n_cols);
+  forwardProb.zeros(transition.n_rows, emissionProb.n_cols);
+  scales.zeros(emissionProb.n_cols);
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
+  forwardProb.col(0) = initial % emissionProb.col(0);
 
   // Then normalize the column.
   scales[0] = accu(forwardProb.col(0));
   forwardProb.col(0) /= scales[0];
 
   // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  for (size_t t = 1; t < emissionProb.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
-    }
+    // The forward probability of state j at time t is the sum over all states
+    // of the probability of the previous state transitioning to the current
+    // state and emitting the given observation.  For all j at once, this is
+    // one matrix-vector product.
+    forwardProb.col(t) = (transition * forwardProb.col(t - 1)) %
+        emissionProb.col(t);
 
     // Normalize probability.
     scales[t] = accu(forwardProb.col(t));
@@ -522,34 +642,31 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * The Backward procedure, given precalculated emission probabilities.
+ */
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& scales,
-                                 arma::mat& backwardProb) const
+void HMM<Distribution>::ScaledBackward(const arma::mat& emissionProb,
+                                       const arma::vec& scales,
+                                       arma::mat& backwardProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
+  backwardProb.zeros(transition.n_rows, emissionProb.n_cols);
 
   // The last element probability is 1.
-  backwardProb.col(dataSeq.n_cols - 1).fill(1);
+  backwardProb.col(emissionProb.n_cols - 1).fill(1);
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  for (size_t t = emissionProb.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      backwardProb(j, t) /= scales[t + 1];
-    }
+    // The backward probability of state j at time t is the sum over all states
+    // of the probability of the next state having been a transition from the
+    // current state multiplied by the probability of each of those states
+    // emitting the given observation.  This is normalized by the weights from
+    // the forward algorithm.
+    backwardProb.col(t) = trans(transition) * (backwardProb.col(t + 1) %
+        emissionProb.col(t + 1)) / scales[t + 1];
   }
 }
 
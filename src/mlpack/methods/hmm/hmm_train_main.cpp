@@ -24,7 +24,8 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Training", "This program allows a "
     "\n\n"
     "The HMM is trained with the Baum-Welch algorithm if no labels are "
     "provided.  The tolerance of the Baum-Welch algorithm can be set with the "
-    "--tolerance option."
+    "--tolerance option.  The sequences are processed in parallel, and the "
+    "number of threads can be set with --threads."
     "\n\n"
     "Optionally, a pre-created HMM model can be used as a guess for the "
     "transition matrix and emission probabilities; this is specifiable with "
@@ -47,6 +48,7 @@ PARAM_STRING("output_file", "File to save trained HMM to (XML).", "o",
     "output_hmm.xml");
 PARAM_INT("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 PARAM_DOUBLE("tolerance", "Tolerance of the Baum-Welch algorithm.", "T", 1e-5);
+PARAM_THREADS();
 
 using namespace mlpack;
 using namespace mlpack::hmm;
@@ -91,6 +93,8 @@ int main(int argc, char** argv)
         << " than or equal to 1." << endl;
   }
 
+  CLI::SetNumThreads("threads");
+
   // Load the dataset(s) and labels.
   vector<mat> trainSeq;
   vector<arma::Col<size_t> > labelSeq; // May be empty.
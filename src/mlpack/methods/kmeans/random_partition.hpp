@@ -41,8 +41,14 @@ class RandomPartition
                              arma::Col<size_t>& assignments)
   {
     // Implementation is so simple we'll put it here in the header file.
-    assignments = arma::shuffle(arma::linspace<arma::Col<size_t> >(0,
-        (clusters - 1), data.n_cols));
+    assignments = arma::linspace<arma::Col<size_t> >(0, (clusters - 1),
+        data.n_cols);
+
+    // Shuffle with mlpack's random number generator (a Fisher-Yates shuffle),
+    // so that the partition can be reproduced by seeding the generator of the
+    // calling thread.
+    for (size_t i = data.n_cols; i > 1; --i)
+      std::swap(assignments[i - 1], assignments[math::RandInt(i)]);
   }
 };
 
@@ -50,33 +50,20 @@ double LogisticRegressionFunction::Evaluate(const arma::mat& parameters)
   // We want to minimize this function.  L2-regularization is just lambda
   // multiplied by the squared l2-norm of the parameters then divided by two.
 
-  // For the regularization, we ignore the first term, which is the intercept
-  // term.
-  const double regularization = 0.5 * lambda *
-      arma::dot(parameters.col(0).subvec(1, parameters.n_elem - 1),
-                parameters.col(0).subvec(1, parameters.n_elem - 1));
-
-  // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
-  // does not need to be multiplied by any of the predictors.
-  const arma::vec exponents = parameters(0, 0) + predictors.t() *
-      parameters.col(0).subvec(1, parameters.n_elem - 1);
-  const arma::vec sigmoid = 1.0 / (1.0 + arma::exp(-exponents));
-
-  // Assemble full objective function.  Often the objective function and the
+  // The objective is a sum over the points (the regularization term is split
+  // evenly between them), so the points are split into batches that are
+  // evaluated in parallel.  Often the objective function and the
   // regularization as given are divided by the number of features, but this
   // doesn't actually affect the optimization result, so we'll just ignore those
   // terms for computational efficiency.
   double result = 0.0;
-  for (size_t i = 0; i < responses.n_elem; ++i)
-  {
-    if (responses[i] == 1)
-      result += log(sigmoid[i]);
-    else
-      result += log(1.0 - sigmoid[i]);
-  }
+  math::ParallelColumnReduce(0, predictors.n_cols,
+      [&](const size_t begin, const size_t end, double& batchResult)
+      {
+        batchResult = Evaluate(parameters, begin, end - begin);
+      }, result);
 
-  // Invert the result, because it's a minimization.
-  return -result + regularization;
+  return result;
 }
 
 /**
@@ -104,21 +91,56 @@ double LogisticRegressionFunction::Evaluate(const arma::mat& parameters,
     return -log(1.0 - sigmoid) + regularization;
 }
 
+/**
+ * Evaluate the logistic regression objective function, but with only a batch of
+ * points.  This is useful for optimizers that use batches of a separable
+ * objective function, such as mini-batch SGD.
+ */
+double LogisticRegressionFunction::Evaluate(const arma::mat& parameters,
+                                            const size_t begin,
+                                            const size_t batchSize) const
+{
+  // An empty batch contributes nothing (and can't be sliced).
+  if (batchSize == 0)
+    return 0.0;
+
+  // Calculate the regularization term, scaled by the fraction of points in the
+  // batch.
+  const double regularization = lambda *
+      (batchSize / (2.0 * predictors.n_cols)) *
+      arma::dot(parameters.col(0).subvec(1, parameters.n_elem - 1),
+                parameters.col(0).subvec(1, parameters.n_elem - 1));
+
+  // Calculate sigmoids for the batch.
+  const arma::vec exponents = parameters(0, 0) +
+      predictors.cols(begin, begin + batchSize - 1).t() *
+      parameters.col(0).subvec(1, parameters.n_elem - 1);
+  const arma::vec sigmoid = 1.0 / (1.0 + arma::exp(-exponents));
+
+  double result = 0.0;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    if (responses[begin + i] == 1)
+      result += log(sigmoid[i]);
+    else
+      result += log(1.0 - sigmoid[i]);
+  }
+
+  // Invert the result, because it's a minimization.
+  return -result + regularization;
+}
+
 //! Evaluate the gradient of the logistic regression objective function.
 void LogisticRegressionFunction::Gradient(const arma::mat& parameters,
                                           arma::mat& gradient) const
 {
-  // Regularization term.
-  arma::mat regularization;
-  regularization = lambda * parameters.col(0).subvec(1, parameters.n_elem - 1);
-
-  const arma::vec sigmoids = 1 / (1 + arma::exp(-parameters(0, 0)
-      - predictors.t() * parameters.col(0).subvec(1, parameters.n_elem - 1)));
-
-  gradient.set_size(parameters.n_elem);
-  gradient[0] = -arma::accu(responses - sigmoids);
-  gradient.col(0).subvec(1, parameters.n_elem - 1) = -predictors * (responses -
-      sigmoids) + regularization;
+  // The gradient is a sum over the points, so the points are split into
+  // batches whose gradients are calculated in parallel.
+  math::ParallelColumnReduce(0, predictors.n_cols,
+      [&](const size_t begin, const size_t end, arma::mat& batchGradient)
+      {
+        Gradient(parameters, begin, batchGradient, end - begin);
+      }, gradient);
 }
 
 /**
@@ -144,3 +166,124 @@ void LogisticRegressionFunction::Gradient(const arma::mat& parameters,
   gradient.col(0).subvec(1, parameters.n_elem - 1) = -predictors.col(i)
       * (responses[i] - sigmoid) + regularization;
 }
+
+/**
+ * Evaluate the gradient of the logistic regression objective function with
+ * respect to a batch of points.  This is useful for optimizers that use batches
+ * of a separable objective function, such as mini-batch SGD.
+ */
+void LogisticRegressionFunction::Gradient(const arma::mat& parameters,
+                                          const size_t begin,
+                                          arma::mat& gradient,
+                                          const size_t batchSize) const
+{
+  // An empty batch contributes nothing (and can't be sliced).
+  if (batchSize == 0)
+  {
+    gradient.zeros(parameters.n_elem);
+    return;
+  }
+
+  // Calculate the regularization term, scaled by the fraction of points in the
+  // batch.
+  arma::mat regularization;
+  regularization = lambda * parameters.col(0).subvec(1, parameters.n_elem - 1)
+      * batchSize / predictors.n_cols;
+
+  const arma::vec sigmoids = 1 / (1 + arma::exp(-parameters(0, 0)
+      - predictors.cols(begin, begin + batchSize - 1).t() *
+      parameters.col(0).subvec(1, parameters.n_elem - 1)));
+  const arma::vec errors = responses.subvec(begin, begin + batchSize - 1) -
+      sigmoids;
+
+  gradient.set_size(parameters.n_elem);
+  gradient[0] = -arma::accu(errors);
+  gradient.col(0).subvec(1, parameters.n_elem - 1) =
+      -predictors.cols(begin, begin + batchSize - 1) * errors + regularization;
+}
+
+//! Evaluate the objective function and its gradient together.
+double LogisticRegressionFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  // The objective and gradient are sums over the points, so, as in Evaluate()
+  // and Gradient(), the points are split into batches that are handled in
+  // parallel.
+  double objective = 0.0;
+  math::ParallelColumnReduce(0, predictors.n_cols,
+      [&](const size_t begin, const size_t end, double& batchObjective,
+          arma::mat& batchGradient)
+      {
+        batchObjective = EvaluateWithGradient(parameters, begin, batchGradient,
+            end - begin);
+      }, objective, gradient);
+
+  return objective;
+}
+
+/**
+ * Evaluate the objective function and its gradient with respect to one point.
+ * This is useful for optimizers that use a separable objective function, such
+ * as SGD.
+ */
+double LogisticRegressionFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t i,
+    arma::mat& gradient) const
+{
+  return EvaluateWithGradient(parameters, i, gradient, 1);
+}
+
+/**
+ * Evaluate the objective function and its gradient with respect to a batch of
+ * points.  This is the combination of the batch Evaluate() and Gradient().
+ */
+double LogisticRegressionFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  // An empty batch contributes nothing (and can't be sliced).
+  if (batchSize == 0)
+  {
+    gradient.zeros(parameters.n_elem);
+    return 0.0;
+  }
+
+  // Both regularization terms are scaled by the fraction of points in the
+  // batch.
+  const double regularization = lambda *
+      (batchSize / (2.0 * predictors.n_cols)) *
+      arma::dot(parameters.col(0).subvec(1, parameters.n_elem - 1),
+                parameters.col(0).subvec(1, parameters.n_elem - 1));
+
+  // Calculate the sigmoids for the batch; these are used for both the objective
+  // and the gradient.
+  const arma::vec sigmoids = 1.0 / (1.0 + arma::exp(-parameters(0, 0)
+      - predictors.cols(begin, begin + batchSize - 1).t() *
+      parameters.col(0).subvec(1, parameters.n_elem - 1)));
+
+  double result = 0.0;
+  for (size_t i = 0; i < batchSize; ++i)
+  {
+    if (responses[begin + i] == 1)
+      result += log(sigmoids[i]);
+    else
+      result += log(1.0 - sigmoids[i]);
+  }
+
+  const arma::vec errors = responses.subvec(begin, begin + batchSize - 1) -
+      sigmoids;
+
+  gradient.set_size(parameters.n_elem);
+  gradient[0] = -arma::accu(errors);
+  gradient.col(0).subvec(1, parameters.n_elem - 1) =
+      -predictors.cols(begin, begin + batchSize - 1) * errors + lambda *
+      parameters.col(0).subvec(1, parameters.n_elem - 1) * batchSize /
+      predictors.n_cols;
+
+  // Invert the result, because it's a minimization.
+  return -result + regularization;
+}
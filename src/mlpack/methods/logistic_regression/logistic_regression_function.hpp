@@ -75,6 +75,21 @@ class LogisticRegressionFunction
    */
   double Evaluate(const arma::mat& parameters, const size_t i) const;
 
+  /**
+   * Evaluate the logistic regression log-likelihood function with the given
+   * parameters, using only the batch of points begin through (begin +
+   * batchSize - 1).  This is the sum of Evaluate(parameters, i) over the batch,
+   * but it is computed with matrix operations.  This is useful for optimizers
+   * such as MiniBatchSGD.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point in the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters.
@@ -98,6 +113,65 @@ class LogisticRegressionFunction
                 const size_t i,
                 arma::mat& gradient) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, with respect to only the batch of points begin
+   * through (begin + batchSize - 1).  This is the sum of Gradient(parameters,
+   * i, gradient) over the batch, but it is computed with matrix operations.
+   * This is useful for optimizers such as MiniBatchSGD.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point in the batch.
+   * @param gradient Vector to output gradient into.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize) const;
+
+  /**
+   * Evaluate the logistic regression log-likelihood function and its gradient
+   * with the given parameters.  This is faster than calling Evaluate() and
+   * Gradient() separately, because the sigmoids are only calculated once.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param gradient Vector to output gradient into.
+   * @return Objective function value.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the logistic regression log-likelihood function and its gradient
+   * with the given parameters, with respect to only one point in the dataset.
+   * This is used by SGD.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param i Index of point to use.
+   * @param gradient Vector to output gradient into.
+   * @return Objective function value for the point.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t i,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the logistic regression log-likelihood function and its gradient
+   * with the given parameters, with respect to only the batch of points begin
+   * through (begin + batchSize - 1).
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point in the batch.
+   * @param gradient Vector to output gradient into.
+   * @param batchSize Number of points in the batch.
+   * @return Objective function value for the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize) const;
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
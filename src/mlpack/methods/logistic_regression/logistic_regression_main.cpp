@@ -8,6 +8,8 @@
 #include "logistic_regression.hpp"
 
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/minibatch_sgd/minibatch_sgd.hpp>
+#include <mlpack/core/optimizers/adaptive_sgd/adaptive_sgd.hpp>
 
 using namespace std;
 using namespace mlpack;
@@ -31,12 +33,15 @@ PROGRAM_INFO("L2-regularized Logistic Regression and Prediction",
     "specified when the --model_file parameter is given with --input_file or "
     "--input_responses.  The tolerance of the optimizer can be set with "
     "--tolerance; the maximum number of iterations of the optimizer can be set "
-    "with --max_iterations; and the type of the optimizer (SGD / L-BFGS) can be"
-    " set with " "the --optimizer option.  Both the SGD and L-BFGS optimizers "
-    "have more options, but the C++ interface must be used for those.  For the "
-    "SGD optimizer, the --step_size parameter controls the step size taken at "
-    "each iteration by the optimizer.  If the objective function for your data "
-    "is oscillating between Inf and 0, the step size is probably too large.\n"
+    "with --max_iterations; and the type of the optimizer (SGD / mini-batch "
+    "SGD / AdaGrad / RMSProp / Adam / L-BFGS) can be set with the --optimizer "
+    "option.  All of the optimizers have more options, but the C++ interface "
+    "must be used for those.  For all optimizers except L-BFGS, the "
+    "--step_size parameter controls the step size taken at each iteration by "
+    "the optimizer.  If the objective function for your data is oscillating "
+    "between Inf and 0, the step size is probably too large.  For the "
+    "mini-batch optimizers (all but SGD and L-BFGS), the --batch_size "
+    "parameter controls the number of points in each batch.\n"
     "\n"
     "This implementation of logistic regression supports L2-regularization, "
     "which can help the parameter vector b from overfitting.  This parameter "
@@ -73,12 +78,35 @@ PARAM_DOUBLE("decision_boundary", "Decision boundary for prediction; if the "
     "taken to be 0; otherwise, the class is 1.", "d", 0.5);
 
 PARAM_DOUBLE("lambda", "L2-regularization parameter for training.", "l", 0.0);
-PARAM_STRING("optimizer", "Optimizer to use for training ('lbfgs' or 'sgd').",
-    "O", "lbfgs");
+PARAM_STRING("optimizer", "Optimizer to use for training ('lbfgs', 'sgd', "
+    "'minibatch-sgd', 'adagrad', 'rmsprop', or 'adam').", "O", "lbfgs");
 PARAM_DOUBLE("tolerance", "Convergence tolerance for optimizer.", "T", 1e-10);
 PARAM_INT("max_iterations", "Maximum iterations for optimizer (0 indicates no "
     "limit).", "M", 0);
-PARAM_DOUBLE("step_size", "Step size for SGD optimizer.", "s", 0.01);
+PARAM_DOUBLE("step_size", "Step size for SGD optimizers.", "s", 0.01);
+PARAM_INT("batch_size", "Batch size for mini-batch optimizers.", "b", 50);
+
+/**
+ * Train a logistic regression model with one of the mini-batch optimizers that
+ * share MiniBatchSGD's interface, and return the parameters.
+ */
+template<template<typename> class OptimizerType>
+arma::mat TrainMiniBatch(LogisticRegressionFunction& lrf,
+                         const size_t maxIterations,
+                         const double tolerance,
+                         const double stepSize,
+                         const size_t batchSize)
+{
+  OptimizerType<LogisticRegressionFunction> opt(lrf);
+  opt.MaxIterations() = maxIterations;
+  opt.Tolerance() = tolerance;
+  opt.StepSize() = stepSize;
+  opt.BatchSize() = batchSize;
+
+  // This will train the model.
+  LogisticRegression<OptimizerType> lr(opt);
+  return lr.Parameters();
+}
 
 int main(int argc, char** argv)
 {
@@ -98,6 +126,7 @@ int main(int argc, char** argv)
   const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
   const double decisionBoundary = CLI::GetParam<double>("decision_boundary");
   const double stepSize = CLI::GetParam<double>("step_size");
+  const int batchSize = CLI::GetParam<int>("batch_size");
 
   // One of inputFile and modelFile must be specified.
   if (inputFile.empty() && modelFile.empty())
@@ -121,9 +150,12 @@ int main(int argc, char** argv)
     Log::Fatal << "Tolerance must be positive (received " << tolerance << ")."
         << endl;
 
-  // Optimizer has to be L-BFGS or SGD.
-  if (optimizerType != "lbfgs" && optimizerType != "sgd")
-    Log::Fatal << "--optimizer must be 'lbfgs' or 'sgd'." << endl;
+  // Check that the optimizer is one we know.
+  if (optimizerType != "lbfgs" && optimizerType != "sgd" &&
+      optimizerType != "minibatch-sgd" && optimizerType != "adagrad" &&
+      optimizerType != "rmsprop" && optimizerType != "adam")
+    Log::Fatal << "--optimizer must be 'lbfgs', 'sgd', 'minibatch-sgd', "
+        << "'adagrad', 'rmsprop', or 'adam'." << endl;
 
   // Lambda must be positive.
   if (lambda < 0.0)
@@ -135,10 +167,15 @@ int main(int argc, char** argv)
     Log::Fatal << "Decision boundary (--decision_boundary) must be between 0.0 "
         << "and 1.0 (received " << decisionBoundary << ")." << endl;
 
-  if ((stepSize < 0.0) && (optimizerType == "sgd"))
+  if ((stepSize < 0.0) && (optimizerType != "lbfgs"))
     Log::Fatal << "Step size (--step_size) must be positive (received "
         << stepSize << ")." << endl;
 
+  if ((batchSize <= 0) && (optimizerType != "lbfgs") &&
+      (optimizerType != "sgd"))
+    Log::Fatal << "Batch size (--batch_size) must be positive (received "
+        << batchSize << ")." << endl;
+
   // These are the matrices we might use.
   arma::mat regressors;
   arma::mat responses;
@@ -222,6 +259,24 @@ int main(int argc, char** argv)
       // Extract the newly trained model.
       model = lr.Parameters();
     }
+    else
+    {
+      Log::Info << "Training model with " << optimizerType << " optimizer "
+          << "(batch size " << batchSize << ")." << endl;
+
+      if (optimizerType == "minibatch-sgd")
+        model = TrainMiniBatch<MiniBatchSGD>(lrf, maxIterations, tolerance,
+            stepSize, (size_t) batchSize);
+      else if (optimizerType == "adagrad")
+        model = TrainMiniBatch<AdaGrad>(lrf, maxIterations, tolerance,
+            stepSize, (size_t) batchSize);
+      else if (optimizerType == "rmsprop")
+        model = TrainMiniBatch<RMSProp>(lrf, maxIterations, tolerance,
+            stepSize, (size_t) batchSize);
+      else
+        model = TrainMiniBatch<Adam>(lrf, maxIterations, tolerance,
+            stepSize, (size_t) batchSize);
+    }
   }
 
   if (!testSet.empty())
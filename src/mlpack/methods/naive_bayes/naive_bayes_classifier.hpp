@@ -51,7 +51,21 @@ class NaiveBayesClassifier
   //! Class probabilities.
   arma::vec probabilities;
 
+  //! Number of training points seen for each class.
+  arma::vec counts;
+
  public:
+  /**
+   * Initialize the classifier without training it.  The model has the given
+   * number of features and classes, and has not seen any points; Train() can
+   * then be used to train it incrementally.
+   *
+   * @param dimensionality Number of features of each point.
+   * @param classes Number of classes in this classifier.
+   */
+  NaiveBayesClassifier(const size_t dimensionality = 0,
+                       const size_t classes = 0);
+
   /**
    * Initializes the classifier as per the input and then trains it by
    * calculating the sample mean and variances.  The input data is expected to
@@ -77,9 +91,36 @@ class NaiveBayesClassifier
                        const size_t classes,
                        const bool incrementalVariance = false);
 
+  /**
+   * Train the classifier on a batch of labeled points, in addition to all of
+   * the points it has been trained on so far.  The counts, means, and
+   * variances of the batch are computed, and then combined with those of the
+   * model with the pairwise update of Chan, Golub, and LeVeque (which is
+   * Welford's algorithm for whole batches), so the result is the same as
+   * training on all of the points at once, but the earlier points are not
+   * needed.
+   *
+   * @code
+   * NaiveBayesClassifier<> nbc(dimensionality, classes);
+   * while (ReadBatch(data, labels))
+   *   nbc.Train(data, labels);
+   * @endcode
+   *
+   * @param data Training data points.
+   * @param labels Labels corresponding to training data points.
+   * @param incrementalVariance If true, an incremental algorithm is used to
+   *     calculate the variance of the batch; this can prevent loss of
+   *     precision in some cases, but will be somewhat slower to calculate.
+   */
+  void Train(const MatType& data,
+             const arma::Col<size_t>& labels,
+             const bool incrementalVariance = false);
+
   /**
    * Given a bunch of data points, this function evaluates the class of each of
-   * those data points, and puts it in the vector 'results'.
+   * those data points, and puts it in the vector 'results'.  The probabilities
+   * are computed in log space, and blocks of points are classified in
+   * parallel if OpenMP is available.
    *
    * @code
    * arma::mat test_data; // each column is a test point
@@ -91,7 +132,7 @@ class NaiveBayesClassifier
    * @param data List of data points.
    * @param results Vector that class predictions will be placed into.
    */
-  void Classify(const MatType& data, arma::Col<size_t>& results);
+  void Classify(const MatType& data, arma::Col<size_t>& results) const;
 
   //! Get the sample means for each class.
   const MatType& Means() const { return means; }
@@ -107,6 +148,29 @@ class NaiveBayesClassifier
   const arma::vec& Probabilities() const { return probabilities; }
   //! Modify the prior probabilities for each class.
   arma::vec& Probabilities() { return probabilities; }
+
+  //! Get the number of training points seen for each class.
+  const arma::vec& Counts() const { return counts; }
+
+  /**
+   * Save the classifier to a SaveRestoreUtility.  The number of points seen
+   * for each class is saved too, so training can be resumed with Train()
+   * after the classifier is loaded.
+   *
+   * @param sr SaveRestoreUtility to save to.
+   */
+  void Save(util::SaveRestoreUtility& sr) const;
+
+  /**
+   * Load the classifier from a SaveRestoreUtility.  The format should be the
+   * same as is generated by Save().
+   *
+   * @param sr SaveRestoreUtility to load from.
+   */
+  void Load(const util::SaveRestoreUtility& sr);
+
+  //! Return the type of the model, for the SaveRestoreUtility.
+  static std::string const Type() { return "NaiveBayesClassifier"; }
 };
 
 }; // namespace naive_bayes
@@ -26,36 +26,74 @@ NaiveBayesClassifier<MatType>::NaiveBayesClassifier(
     const size_t classes,
     const bool incrementalVariance)
 {
-  const size_t dimensionality = data.n_rows;
-
   // Update the variables according to the number of features and classes
   // present in the data.
   probabilities.zeros(classes);
+  counts.zeros(classes);
+  means.zeros(data.n_rows, classes);
+  variances.zeros(data.n_rows, classes);
+
+  Train(data, labels, incrementalVariance);
+}
+
+template<typename MatType>
+NaiveBayesClassifier<MatType>::NaiveBayesClassifier(
+    const size_t dimensionality,
+    const size_t classes)
+{
+  // No points have been seen yet, so all of the classes are equally likely.
+  probabilities.set_size(classes);
+  probabilities.fill(1.0 / classes);
+  counts.zeros(classes);
   means.zeros(dimensionality, classes);
-  variances.zeros(dimensionality, classes);
+  variances.ones(dimensionality, classes);
+}
+
+template<typename MatType>
+void NaiveBayesClassifier<MatType>::Train(const MatType& data,
+                                          const arma::Col<size_t>& labels,
+                                          const bool incrementalVariance)
+{
+  const size_t dimensionality = means.n_rows;
+  const size_t classes = means.n_cols;
+
+  if (data.n_rows != dimensionality)
+    Log::Fatal << "NaiveBayesClassifier::Train(): data dimensionality ("
+        << data.n_rows << ") must be the same as the model dimensionality ("
+        << dimensionality << ")!" << std::endl;
+  if (labels.n_elem != data.n_cols)
+    Log::Fatal << "NaiveBayesClassifier::Train(): number of labels ("
+        << labels.n_elem << ") must be the same as the number of points ("
+        << data.n_cols << ")!" << std::endl;
+  if (labels.n_elem > 0 && arma::max(labels) >= classes)
+    Log::Fatal << "NaiveBayesClassifier::Train(): label " << arma::max(labels)
+        << " is not a valid class (there are " << classes << " classes)!"
+        << std::endl;
 
   Log::Info << "Training Naive Bayes classifier on " << data.n_cols
       << " examples with " << dimensionality << " features each." << std::endl;
 
-  // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
+  // Calculate the number of points of each class in this batch, as well as the
+  // sample mean of each of the features and the sum of the squared differences
+  // from it with respect to each of the labels.
+  arma::vec batchCounts(classes);
+  MatType batchMeans(dimensionality, classes);
+  MatType batchSquares(dimensionality, classes);
+  batchCounts.zeros();
+  batchMeans.zeros();
+  batchSquares.zeros();
+
   if (incrementalVariance)
   {
     // Use incremental algorithm.
     for (size_t j = 0; j < data.n_cols; ++j)
     {
       const size_t label = labels[j];
-      ++probabilities[label];
+      ++batchCounts[label];
 
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
-    }
-
-    for (size_t i = 0; i < classes; ++i)
-    {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
+      arma::vec delta = data.col(j) - batchMeans.col(label);
+      batchMeans.col(label) += delta / batchCounts[label];
+      batchSquares.col(label) += delta % (data.col(j) - batchMeans.col(label));
     }
   }
   else
@@ -65,31 +103,86 @@ NaiveBayesClassifier<MatType>::NaiveBayesClassifier(
     // algorithm but there are some precision and stability issues.  If this is
     // too slow, it's an option to use the faster algorithm by default and then
     // have this (and the incremental algorithm) be other options.
-
-    // Calculate the means.
+    //
+    // The points are first bucketed by label (with a counting sort), so that
+    // the points of each class are a contiguous block of columns.  Each pass
+    // then sums over blocks of points in parallel, and within a block, each
+    // class is reduced with one operation on its columns.  This takes O(nd)
+    // time, no matter how many classes there are.
+    arma::Col<size_t> offsets(classes + 1);
+    offsets.zeros();
     for (size_t j = 0; j < data.n_cols; ++j)
+      ++offsets[labels[j] + 1];
+    for (size_t i = 0; i < classes; ++i)
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
+      batchCounts[i] = offsets[i + 1];
+      offsets[i + 1] += offsets[i];
     }
 
+    MatType sortedData(dimensionality, data.n_cols);
+    arma::Col<size_t> next(offsets);
+    for (size_t j = 0; j < data.n_cols; ++j)
+      sortedData.col(next[labels[j]]++) = data.col(j);
+
+    // Calculate the sums of the points of each class.  A block of points may
+    // contain the end of the points of one class and the start of the next.
+    const size_t minBlockSize = 1024;
+    math::ParallelColumnReduce(0, data.n_cols, [&](const size_t begin,
+        const size_t end, MatType& blockSums)
+    {
+      blockSums.zeros(dimensionality, classes);
+      for (size_t i = 0; i < classes; ++i)
+      {
+        const size_t first = std::max(begin, (size_t) offsets[i]);
+        const size_t last = std::min(end, (size_t) offsets[i + 1]);
+        if (first < last)
+          blockSums.col(i) = arma::sum(sortedData.cols(first, last - 1), 1);
+      }
+    }, batchMeans, minBlockSize);
+
     // Normalize means.
     for (size_t i = 0; i < classes; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+      if (batchCounts[i] != 0.0)
+        batchMeans.col(i) /= batchCounts[i];
 
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
+    // Calculate the squared differences.
+    math::ParallelColumnReduce(0, data.n_cols, [&](const size_t begin,
+        const size_t end, MatType& blockSquares)
     {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
-    }
+      blockSquares.zeros(dimensionality, classes);
+      for (size_t i = 0; i < classes; ++i)
+      {
+        const size_t first = std::max(begin, (size_t) offsets[i]);
+        const size_t last = std::min(end, (size_t) offsets[i + 1]);
+        if (first < last)
+        {
+          MatType diffs = sortedData.cols(first, last - 1);
+          diffs.each_col() -= batchMeans.col(i);
+          blockSquares.col(i) = arma::sum(diffs % diffs, 1);
+        }
+      }
+    }, batchSquares, minBlockSize);
+  }
 
-    // Normalize variances.
-    for (size_t i = 0; i < classes; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
+  // Now combine the statistics of the batch with those of the model.  The sum
+  // of squared differences of the model is recovered from its variance.
+  for (size_t i = 0; i < classes; ++i)
+  {
+    if (batchCounts[i] == 0.0)
+      continue;
+
+    const double count = counts[i] + batchCounts[i];
+    const arma::vec delta = batchMeans.col(i) - means.col(i);
+
+    arma::vec squares = batchSquares.col(i) + (delta % delta) *
+        (counts[i] * batchCounts[i] / count);
+    if (counts[i] > 1)
+      squares += variances.col(i) * (counts[i] - 1);
+
+    means.col(i) += delta * (batchCounts[i] / count);
+    variances.col(i) = (count > 1) ? arma::vec(squares / (count - 1)) :
+        squares;
+    counts[i] = count;
   }
 
   // Ensure that the variances are invertible.
@@ -97,57 +190,88 @@ NaiveBayesClassifier<MatType>::NaiveBayesClassifier(
     if (variances[i] == 0.0)
       variances[i] = 1e-50;
 
-  probabilities /= data.n_cols;
+  probabilities = counts / arma::accu(counts);
 }
 
 template<typename MatType>
 void NaiveBayesClassifier<MatType>::Classify(const MatType& data,
-                                             arma::Col<size_t>& results)
+                                             arma::Col<size_t>& results) const
 {
   // Check that the number of features in the test data is same as in the
   // training data.
   Log::Assert(data.n_rows == means.n_rows);
 
-  arma::vec probs = arma::log(probabilities);
-  arma::mat invVar = 1.0 / variances;
-
-  arma::mat testProbs = arma::repmat(probs.t(), data.n_cols, 1);
-
   results.set_size(data.n_cols); // No need to fill with anything yet.
 
   Log::Info << "Running Naive Bayes classifier on " << data.n_cols
       << " data points with " << data.n_rows << " features each." << std::endl;
 
-  // Calculate the joint probability for each of the data points for each of the
-  // means.n_cols.
+  // We work with the log of the joint probability of each point and each
+  // class, which is the log of the class probability plus the log of a
+  // Gaussian density with diagonal covariance.  The parts that don't depend on
+  // the point are computed once for each class.
+  const arma::vec logConstants = arma::log(probabilities) - 0.5 *
+      (data.n_rows * log(2 * M_PI) + trans(arma::sum(arma::log(variances), 0)));
+  const arma::mat invVariances = 1.0 / variances;
 
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
-  {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    arma::mat diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    arma::mat rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::vec exponents(diffs.n_cols);
-    for (size_t j = 0; j < diffs.n_cols; ++j)
-      exponents(j) = std::exp(arma::accu(diffs.col(j) % rhs.unsafe_col(j)));
-
-    testProbs.col(i) += log(pow(2 * M_PI, (double) data.n_rows / -2.0) *
-        pow(det(arma::diagmat(invVar.col(i))), -0.5) * exponents);
-  }
+  // The points are independent, so blocks of them are classified in parallel.
+  const size_t blockSize = 4096;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
 
-  // Now calculate the label.
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for schedule(static)
+  for (size_t b = 0; b < numBlocks; ++b)
   {
-    // Find the index of the class with maximum probability for this point.
-    arma::uword maxIndex = 0;
-    arma::vec pointProbs = testProbs.row(i).t();
-    pointProbs.max(maxIndex);
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+
+    // Row i holds the log joint probability of each point in the block and
+    // class i.
+    arma::mat logProbs(means.n_cols, end - begin);
+    for (size_t i = 0; i < means.n_cols; ++i)
+    {
+      const arma::mat diffs = data.cols(begin, end - 1) -
+          means.col(i) * arma::ones<arma::rowvec>(end - begin);
+      logProbs.row(i) = logConstants[i] - 0.5 *
+          trans(invVariances.col(i)) * (diffs % diffs);
+    }
 
-    results[i] = maxIndex;
+    // Now calculate the label: the class with maximum probability.
+    for (size_t j = 0; j < logProbs.n_cols; ++j)
+    {
+      size_t maxIndex = 0;
+      for (size_t i = 1; i < logProbs.n_rows; ++i)
+        if (logProbs(i, j) > logProbs(maxIndex, j))
+          maxIndex = i;
+
+      results[begin + j] = maxIndex;
+    }
   }
+}
 
-  return;
+template<typename MatType>
+void NaiveBayesClassifier<MatType>::Save(util::SaveRestoreUtility& sr) const
+{
+  sr.SaveParameter(Type(), "type");
+  sr.SaveParameter(means, "means");
+  sr.SaveParameter(variances, "variances");
+  sr.SaveParameter(probabilities, "probabilities");
+  sr.SaveParameter(counts, "counts");
+}
+
+template<typename MatType>
+void NaiveBayesClassifier<MatType>::Load(const util::SaveRestoreUtility& sr)
+{
+  sr.LoadParameter(means, "means");
+  sr.LoadParameter(variances, "variances");
+  sr.LoadParameter(probabilities, "probabilities");
+  sr.LoadParameter(counts, "counts");
+
+  if (variances.n_rows != means.n_rows || variances.n_cols != means.n_cols ||
+      probabilities.n_elem != means.n_cols || counts.n_elem != means.n_cols)
+  {
+    Log::Fatal << "NaiveBayesClassifier::Load(): sizes of means, variances, "
+        << "probabilities, and counts do not match!" << std::endl;
+  }
 }
 
 }; // namespace naive_bayes
@@ -22,20 +22,37 @@ PROGRAM_INFO("Parametric Naive Bayes Classifier",
     "\n\n"
     "The '--incremental_variance' option can be used to force the training to "
     "use an incremental algorithm for calculating variance.  This is slower, "
-    "but can help avoid loss of precision in some cases.");
+    "but can help avoid loss of precision in some cases."
+    "\n\n"
+    "The trained model can be saved with --output_model_file.  A saved model "
+    "can be loaded with --input_model_file; if a training set is also given, "
+    "the model is then updated with it, which gives the same model as training "
+    "on all of the points at once, without needing the earlier training sets.  "
+    "The test set (--test_file) is optional, so that a model can be updated "
+    "without classifying anything."
+    "\n\n"
+    "Training and classification are done in parallel over blocks of points, "
+    "and the number of threads can be set with --threads.");
 
-PARAM_STRING_REQ("train_file", "A file containing the training set.", "t");
-PARAM_STRING_REQ("test_file", "A file containing the test set.", "T");
+PARAM_STRING("train_file", "A file containing the training set (required "
+    "unless --input_model_file is given).", "t", "");
+PARAM_STRING("test_file", "A file containing the test set.", "T", "");
 
 PARAM_STRING("labels_file", "A file containing labels for the training set.",
     "l", "");
 PARAM_STRING("output", "The file in which the predicted labels for the test set"
     " will be written.", "o", "output.csv");
+PARAM_STRING("input_model_file", "A file containing a saved model to load (and "
+    "update, if a training set is given).", "m", "");
+PARAM_STRING("output_model_file", "A file to save the trained model to.", "M",
+    "");
 PARAM_FLAG("incremental_variance", "The variance of each class will be "
     "calculated incrementally.", "I");
+PARAM_THREADS();
 
 using namespace mlpack;
 using namespace mlpack::naive_bayes;
+using namespace mlpack::util;
 using namespace std;
 using namespace arma;
 
@@ -43,68 +60,138 @@ int main(int argc, char* argv[])
 {
   CLI::ParseCommandLine(argc, argv);
 
-  // Check input parameters.
-  const string trainingDataFilename = CLI::GetParam<string>("train_file");
-  mat trainingData;
-  data::Load(trainingDataFilename, trainingData, true);
+  CLI::SetNumThreads("threads");
 
-  // Normalize labels.
-  Col<size_t> labels;
+  const string trainingDataFilename = CLI::GetParam<string>("train_file");
+  const string inputModelFilename = CLI::GetParam<string>("input_model_file");
+  if (trainingDataFilename == "" && inputModelFilename == "")
+    Log::Fatal << "Either --train_file or --input_model_file must be given!"
+        << endl;
+
+  // The model, and the mapping from the normalized labels used by the model to
+  // the labels in the data.
+  NaiveBayesClassifier<> nbc;
   vec mappings;
-
-  // Did the user pass in labels?
-  const string labelsFilename = CLI::GetParam<string>("labels_file");
-  if (labelsFilename != "")
+  if (inputModelFilename != "")
   {
-    // Load labels.
-    mat rawLabels;
-    data::Load(labelsFilename, rawLabels, true, false);
-
-    // Do the labels need to be transposed?
-    if (rawLabels.n_rows == 1)
-      rawLabels = rawLabels.t();
-
-    data::NormalizeLabels(rawLabels.unsafe_col(0), labels, mappings);
+    SaveRestoreUtility load;
+    if (!load.ReadFile(inputModelFilename))
+      Log::Fatal << "Could not read model file '" << inputModelFilename
+          << "'!" << endl;
+
+    nbc.Load(load);
+    load.LoadParameter(mappings, "mappings");
+    if (mappings.n_elem != nbc.Means().n_cols)
+      Log::Fatal << "Model file '" << inputModelFilename << "' has "
+          << mappings.n_elem << " label mappings but " << nbc.Means().n_cols
+          << " classes!" << endl;
   }
-  else
+
+  if (trainingDataFilename != "")
   {
-    // Use the last row of the training data as the labels.
-    Log::Info << "Using last dimension of training data as training labels."
-        << std::endl;
-    vec rawLabels = trans(trainingData.row(trainingData.n_rows - 1));
-    data::NormalizeLabels(rawLabels, labels, mappings);
-    // Remove the label row.
-    trainingData.shed_row(trainingData.n_rows - 1);
+    mat trainingData;
+    data::Load(trainingDataFilename, trainingData, true);
+
+    // Did the user pass in labels?
+    vec rawLabels;
+    const string labelsFilename = CLI::GetParam<string>("labels_file");
+    if (labelsFilename != "")
+    {
+      // Load labels.
+      mat labelsMatrix;
+      data::Load(labelsFilename, labelsMatrix, true, false);
+
+      // Do the labels need to be transposed?
+      if (labelsMatrix.n_rows == 1)
+        labelsMatrix = labelsMatrix.t();
+
+      rawLabels = labelsMatrix.unsafe_col(0);
+    }
+    else
+    {
+      // Use the last row of the training data as the labels.
+      Log::Info << "Using last dimension of training data as training labels."
+          << std::endl;
+      rawLabels = trans(trainingData.row(trainingData.n_rows - 1));
+      // Remove the label row.
+      trainingData.shed_row(trainingData.n_rows - 1);
+    }
+
+    Col<size_t> labels;
+    if (inputModelFilename == "")
+    {
+      // Normalize labels.
+      data::NormalizeLabels(rawLabels, labels, mappings);
+
+      // Create and train the classifier.
+      Timer::Start("training");
+      nbc = NaiveBayesClassifier<>(trainingData, labels, mappings.n_elem,
+          CLI::HasParam("incremental_variance"));
+      Timer::Stop("training");
+    }
+    else
+    {
+      // Map the labels with the mappings of the model.
+      labels.set_size(rawLabels.n_elem);
+      for (size_t i = 0; i < rawLabels.n_elem; ++i)
+      {
+        size_t j = 0;
+        while (j < mappings.n_elem && mappings[j] != rawLabels[i])
+          ++j;
+
+        if (j == mappings.n_elem)
+          Log::Fatal << "Label " << rawLabels[i] << " of point " << i << " is "
+              << "not a class of the model in '" << inputModelFilename << "'!"
+              << endl;
+        labels[i] = j;
+      }
+
+      if (trainingData.n_rows != nbc.Means().n_rows)
+        Log::Fatal << "Training data dimensionality (" << trainingData.n_rows
+            << ") must be the same as the model dimensionality ("
+            << nbc.Means().n_rows << ")!" << endl;
+
+      // Update the classifier with the new training set.
+      Timer::Start("training");
+      nbc.Train(trainingData, labels, CLI::HasParam("incremental_variance"));
+      Timer::Stop("training");
+    }
   }
 
   const string testingDataFilename = CLI::GetParam<std::string>("test_file");
-  mat testingData;
-  data::Load(testingDataFilename, testingData, true);
-
-  if (testingData.n_rows != trainingData.n_rows)
-    Log::Fatal << "Test data dimensionality (" << testingData.n_rows << ") "
-        << "must be the same as training data (" << trainingData.n_rows
-        << ")!" << std::endl;
-
-  const bool incrementalVariance = CLI::HasParam("incremental_variance");
-
-  // Create and train the classifier.
-  Timer::Start("training");
-  NaiveBayesClassifier<> nbc(trainingData, labels, mappings.n_elem,
-      incrementalVariance);
-  Timer::Stop("training");
-
-  // Time the running of the Naive Bayes Classifier.
-  Col<size_t> results;
-  Timer::Start("testing");
-  nbc.Classify(testingData, results);
-  Timer::Stop("testing");
-
-  // Un-normalize labels to prepare output.
-  vec rawResults;
-  data::RevertLabels(results, mappings, rawResults);
-
-  // Output results.  Don't transpose: one result per line.
-  const string outputFilename = CLI::GetParam<string>("output");
-  data::Save(outputFilename, rawResults, true, false);
+  if (testingDataFilename != "")
+  {
+    mat testingData;
+    data::Load(testingDataFilename, testingData, true);
+
+    if (testingData.n_rows != nbc.Means().n_rows)
+      Log::Fatal << "Test data dimensionality (" << testingData.n_rows << ") "
+          << "must be the same as training data (" << nbc.Means().n_rows
+          << ")!" << std::endl;
+
+    // Time the running of the Naive Bayes Classifier.
+    Col<size_t> results;
+    Timer::Start("testing");
+    nbc.Classify(testingData, results);
+    Timer::Stop("testing");
+
+    // Un-normalize labels to prepare output.
+    vec rawResults;
+    data::RevertLabels(results, mappings, rawResults);
+
+    // Output results.  Don't transpose: one result per line.
+    const string outputFilename = CLI::GetParam<string>("output");
+    data::Save(outputFilename, rawResults, true, false);
+  }
+
+  const string outputModelFilename = CLI::GetParam<string>("output_model_file");
+  if (outputModelFilename != "")
+  {
+    SaveRestoreUtility save;
+    nbc.Save(save);
+    save.SaveParameter(mappings, "mappings");
+    if (!save.WriteFile(outputModelFilename))
+      Log::Warn << "Error saving model to '" << outputModelFilename << "'."
+          << endl;
+  }
 }
@@ -98,29 +98,47 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
   //   otherwise, add
   //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
+  //
+  // The outer loop is split between threads, each of which sums its terms
+  // separately.  Point i has (n - 1 - i) pairs, so contiguous blocks of i would
+  // not have the same amount of work; instead, the split is over the folded
+  // index c, which covers points c and (n - 1 - c), or (n - 1) pairs in total.
+  const size_t n = stretchedDataset.n_cols;
   arma::mat sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
-  {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; k++)
-    {
-      // Calculate p_ik and p_ki first.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-      double p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
-
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      arma::vec x_ik = dataset.col(i) - dataset.col(k);
-      arma::mat secondTerm = (x_ik * trans(x_ik));
-
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
-    }
-  }
+  math::ParallelColumnReduce(0, (n + 1) / 2,
+      [&](const size_t begin, const size_t end, arma::mat& blockSum)
+      {
+        blockSum.zeros(dataset.n_rows, dataset.n_rows);
+        for (size_t c = begin; c < end; c++)
+        {
+          // If n is odd, the middle point is only visited once.
+          const size_t numFolded = (c == n - 1 - c) ? 1 : 2;
+          for (size_t f = 0; f < numFolded; f++)
+          {
+            const size_t i = (f == 0) ? c : n - 1 - c;
+            for (size_t k = (i + 1); k < n; k++)
+            {
+              // Calculate p_ik and p_ki first.
+              double eval = exp(-metric.Evaluate(
+                  stretchedDataset.unsafe_col(i),
+                  stretchedDataset.unsafe_col(k)));
+              double p_ik = 0, p_ki = 0;
+              p_ik = eval / denominators(i);
+              p_ki = eval / denominators(k);
+
+              // Subtract x_i from x_k.  We are not using stretched points here.
+              arma::vec x_ik = dataset.col(i) - dataset.col(k);
+              arma::mat secondTerm = (x_ik * trans(x_ik));
+
+              if (labels[i] == labels[k])
+                blockSum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) *
+                    secondTerm;
+              else
+                blockSum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
+            }
+          }
+        }
+      }, sum);
 
   // Assemble the final gradient.
   gradient = -2 * coordinates * sum;
@@ -224,28 +242,51 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   // We will do this by keeping track of the denominators for each i as well as
   // the numerators (the sum for all j in class of i).  This will be on the
   // order of O((n * (n + 1)) / 2), which really isn't all that great.
-  p.zeros(stretchedDataset.n_cols);
-  denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
-  {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; j++)
-    {
-      // Evaluate exp(-d(x_i, x_j)).
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(j)));
-
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      denominators[i] += eval;
-      denominators[j] += eval;
-
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
+  //
+  // The outer loop is split between threads.  Because each pair adds to the
+  // values of both of its points, each thread keeps its own numerators (first
+  // column) and denominators (second column) for every point, and these are
+  // summed afterwards.  As in Gradient(), the split is over the folded index c,
+  // which covers points c and (n - 1 - c), so each thread gets the same number
+  // of pairs.
+  const size_t n = stretchedDataset.n_cols;
+  arma::mat sums;
+  math::ParallelColumnReduce(0, (n + 1) / 2,
+      [&](const size_t begin, const size_t end, arma::mat& blockSums)
       {
-        p[i] += eval;
-        p[j] += eval;
-      }
-    }
-  }
+        blockSums.zeros(n, 2);
+        for (size_t c = begin; c < end; c++)
+        {
+          // If n is odd, the middle point is only visited once.
+          const size_t numFolded = (c == n - 1 - c) ? 1 : 2;
+          for (size_t f = 0; f < numFolded; f++)
+          {
+            const size_t i = (f == 0) ? c : n - 1 - c;
+            for (size_t j = (i + 1); j < n; j++)
+            {
+              // Evaluate exp(-d(x_i, x_j)).
+              double eval = exp(-metric.Evaluate(
+                  stretchedDataset.unsafe_col(i),
+                  stretchedDataset.unsafe_col(j)));
+
+              // Add this to the denominators of both p_i and p_j: K(i, j) =
+              // K(j, i).
+              blockSums(i, 1) += eval;
+              blockSums(j, 1) += eval;
+
+              // If i and j are the same class, add to numerator of both.
+              if (labels[i] == labels[j])
+              {
+                blockSums(i, 0) += eval;
+                blockSums(j, 0) += eval;
+              }
+            }
+          }
+        }
+      }, sums);
+
+  p = sums.col(0);
+  denominators = sums.col(1);
 
   // Divide p_i by their denominators.
   p /= denominators;
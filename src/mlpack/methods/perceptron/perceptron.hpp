@@ -21,6 +21,30 @@ namespace perceptron {
  * network).  It converges if the supplied training dataset is linearly
  * separable.
  *
+ * The perceptron can be trained in parallel with iterative parameter mixing,
+ * by passing a number of shards greater than one to the constructor.  The
+ * training points are then dealt out to the shards, and in each iteration every
+ * shard makes one pass of the perceptron learning rule over its own points in
+ * parallel, starting from the current weights; the new weights are the average
+ * of the weights found by the shards.  This converges if the dataset is
+ * linearly separable too.  The weights that are kept at the end are those of
+ * the averaged perceptron: the average of the weights of each shard after each
+ * of its points, over all of the iterations, which is less sensitive to the
+ * last few updates than the final weights.  For a given number of shards, the
+ * result does not depend on the number of threads.  For more information, see
+ *
+ * @code
+ * @inproceedings{mcdonald2010distributed,
+ *   title={Distributed training strategies for the structured perceptron},
+ *   author={McDonald, Ryan and Hall, Keith and Mann, Gideon},
+ *   booktitle={Human Language Technologies: The 2010 Annual Conference of the
+ *       North American Chapter of the Association for Computational
+ *       Linguistics},
+ *   pages={456--464},
+ *   year={2010}
+ * }
+ * @endcode
+ *
  * @tparam LearnPolicy Options of SimpleWeightUpdate and GradientDescent.
  * @tparam WeightInitializationPolicy Option of ZeroInitialization and
  *      RandomInitialization.
@@ -40,12 +64,20 @@ class Perceptron
    * @param labels Labels of dataset.
    * @param iterations Maximum number of iterations for the perceptron learning
    *     algorithm.
+   * @param shards Number of shards to train in parallel with iterative
+   *     parameter mixing; 1 trains serially, and 0 uses one shard for each
+   *     thread.
    */
-  Perceptron(const MatType& data, const arma::Row<size_t>& labels, int iterations);
+  Perceptron(const MatType& data,
+             const arma::Row<size_t>& labels,
+             int iterations,
+             const size_t shards = 1);
 
   /**
    * Classification function. After training, use the weightVectors matrix to
-   * classify test, and put the predicted classes in predictedLabels.
+   * classify test, and put the predicted classes in predictedLabels.  The test
+   * points are classified in blocks, with one matrix multiplication for each
+   * block, and the blocks are classified in parallel.
    *
    * @param test Testing data or data to classify.
    * @param predictedLabels Vector to store the predicted classes after
@@ -65,10 +97,16 @@ class Perceptron
    */
   Perceptron(const Perceptron<>& other, MatType& data, const arma::rowvec& D, const arma::Row<size_t>& labels);
 
+  //! Get the number of shards used for training.
+  size_t Shards() const { return shards; }
+
 private:
   //! To store the number of iterations
   size_t iter;
 
+  //! Number of shards to train in parallel (1 for serial training).
+  size_t shards;
+
   //! Stores the class labels for the input data.
   arma::Row<size_t> classLabels;
 
@@ -84,6 +122,16 @@ private:
    *  @param D Cost matrix. Stores the cost of mispredicting instances
    */
   void Train(const arma::rowvec& D);
+
+  /**
+   *  Training Function for iterative parameter mixing. It trains on trainData
+   *  using the cost matrix D, with the given number of shards, and keeps the
+   *  averaged weights.
+   *
+   *  @param D Cost matrix. Stores the cost of mispredicting instances
+   *  @param numShards Number of shards to split the training points into.
+   */
+  void TrainShards(const arma::rowvec& D, const size_t numShards);
 };
 
 } // namespace perceptron
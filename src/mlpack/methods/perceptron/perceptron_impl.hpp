@@ -22,6 +22,8 @@ namespace perceptron {
  * @param labels Labels of dataset.
  * @param iterations Maximum number of iterations for the perceptron learning
  *      algorithm.
+ * @param shards Number of shards to train in parallel with iterative parameter
+ *      mixing; 1 trains serially, and 0 uses one shard for each thread.
  */
 template<
     typename LearnPolicy,
@@ -31,7 +33,9 @@ template<
 Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const MatType& data,
     const arma::Row<size_t>& labels,
-    int iterations)
+    int iterations,
+    const size_t shards) :
+    shards(shards)
 {
   WeightInitializationPolicy WIP;
   WIP.Initialize(weightVectors, arma::max(labels) + 1, data.n_rows + 1);
@@ -66,18 +70,34 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::mat tempLabelMat;
-  arma::uword maxIndexRow, maxIndexCol;
+  predictedLabels.set_size(test.n_cols);
+
+  // Split the weights from the biases once.
+  const arma::mat weights = weightVectors.cols(1, weightVectors.n_cols - 1);
+  const arma::vec biases = weightVectors.col(0);
 
-  for (size_t i = 0; i < test.n_cols; i++)
+  // Classify the points in blocks, so that the scores of all the points in a
+  // block are computed with one matrix multiplication.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (test.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < numBlocks; b++)
   {
-    tempLabelMat = weightVectors.submat(0, 1, weightVectors.n_rows - 1,
-                                        weightVectors.n_cols - 1) * 
-                                        test.col(i) + weightVectors.col(0);
-    tempLabelMat.max(maxIndexRow, maxIndexCol);
-    predictedLabels(0, i) = maxIndexRow;
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) test.n_cols);
+
+    const arma::mat scores = weights * test.cols(begin, end - 1) +
+        biases * arma::ones<arma::rowvec>(end - begin);
+
+    // Take the class with the highest score (the first one, if there is a
+    // tie).
+    arma::uword maxIndexRow;
+    for (size_t i = 0; i < scores.n_cols; i++)
+    {
+      scores.unsafe_col(i).max(maxIndexRow);
+      predictedLabels(0, begin + i) = maxIndexRow;
+    }
   }
-  // predictedLabels.print("These are the labels predicted by the perceptron");
 }
 
 /**
@@ -98,6 +118,7 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
   classLabels = labels;
   trainData = data;
   iter = other.iter;
+  shards = other.shards;
 
   // Insert a row of ones at the top of the training data set.
   MatType zOnes(1, data.n_cols);
@@ -123,6 +144,20 @@ template<
 void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
      const arma::rowvec& D)
 {
+  // Find the number of shards to use, if the training is parallel.
+#ifdef _OPENMP
+  size_t numShards = (shards == 0) ? (size_t) omp_get_max_threads() : shards;
+#else
+  size_t numShards = (shards == 0) ? 1 : shards;
+#endif
+  numShards = std::min(numShards, (size_t) trainData.n_cols);
+
+  if (numShards > 1)
+  {
+    TrainShards(D, numShards);
+    return;
+  }
+
   size_t j, i = 0;
   bool converged = false;
   size_t tempLabel;
@@ -162,6 +197,105 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
   }
 }
 
+/**
+ *  Training Function for iterative parameter mixing. It trains on trainData
+ *  using the cost matrix D, with the given number of shards, and keeps the
+ *  averaged weights.
+ *
+ *  @param D Cost matrix. Stores the cost of mispredicting instances
+ *  @param numShards Number of shards to split the training points into.
+ */
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::TrainShards(
+     const arma::rowvec& D,
+     const size_t numShards)
+{
+  size_t i = 0;
+  bool converged = false;
+
+  // The weights found by each shard, and whether each shard classified all of
+  // its points correctly.
+  std::vector<arma::mat> shardWeights(numShards);
+  arma::uvec shardConverged(numShards);
+
+  // For the averaged perceptron, each shard sums its weights after each of its
+  // points, and these are added to the running sum over all iterations.
+  std::vector<arma::mat> shardSums(numShards);
+  arma::mat weightSum;
+  weightSum.zeros(weightVectors.n_rows, weightVectors.n_cols);
+  size_t weightCount = 0;
+
+  while ((i < iter) && (!converged))
+  {
+    i++;
+
+    // Each shard makes one pass over its points (every numShards-th point,
+    // so that the shards are balanced even if the points are sorted),
+    // starting from the current weights.
+    #pragma omp parallel for schedule(static)
+    for (size_t s = 0; s < numShards; s++)
+    {
+      LearnPolicy LP;
+      arma::mat& shardWeightVectors = shardWeights[s];
+      shardWeightVectors = weightVectors;
+      shardConverged[s] = 1;
+
+      // The weights only change on a mistake, so they are added to the sum
+      // once for each of the points since the last change, just before they
+      // change (and at the end of the pass).
+      arma::mat& shardSum = shardSums[s];
+      shardSum.zeros(weightVectors.n_rows, weightVectors.n_cols);
+      size_t unchanged = 0;
+
+      arma::uword maxIndexRow, maxIndexCol;
+      arma::mat tempLabelMat;
+      for (size_t j = s; j < trainData.n_cols; j += numShards)
+      {
+        tempLabelMat = shardWeightVectors * trainData.col(j);
+        tempLabelMat.max(maxIndexRow, maxIndexCol);
+
+        if (maxIndexRow != classLabels(0, j))
+        {
+          shardConverged[s] = 0;
+          shardSum += (double) unchanged * shardWeightVectors;
+          unchanged = 0;
+          LP.UpdateWeights(trainData, shardWeightVectors, j, classLabels(0, j),
+              maxIndexRow, D);
+        }
+
+        ++unchanged;
+      }
+      shardSum += (double) unchanged * shardWeightVectors;
+    }
+
+    // Every point was visited by exactly one shard.  The sums are added in
+    // order, so that the result does not depend on the number of threads.
+    for (size_t s = 0; s < numShards; s++)
+      weightSum += shardSums[s];
+    weightCount += trainData.n_cols;
+
+    // If no shard made a mistake, the weights have not changed.
+    converged = (arma::accu(shardConverged) == numShards);
+    if (converged)
+      break;
+
+    // Mix the weights of the shards, summing them in order so that the result
+    // does not depend on the number of threads.
+    weightVectors = shardWeights[0];
+    for (size_t s = 1; s < numShards; s++)
+      weightVectors += shardWeights[s];
+    weightVectors /= numShards;
+  }
+
+  // Keep the averaged weights.
+  if (weightCount > 0)
+    weightVectors = weightSum / (double) weightCount;
+}
+
 }; // namespace perceptron
 }; // namespace mlpack
 
@@ -37,6 +37,15 @@ PROGRAM_INFO("Perceptron",
     "A test file is given through the --test_file (-T) parameter.  The "
     "predicted labels for the test set will be stored in the file specified by "
     "the --output_file (-o) parameter."
+    "\n\n"
+    "The perceptron can be trained in parallel with iterative parameter "
+    "mixing: the training points are split into --shards (-s) shards, each "
+    "iteration makes one pass over each shard in parallel, and the weights "
+    "found by the shards are averaged.  The final weights are those of the "
+    "averaged perceptron (the average of the weights after each training "
+    "point over all iterations).  With --shards 0, one shard is used for "
+    "each thread.  The number of threads can be set with --threads; the test "
+    "set is also classified in parallel."
     );
 
 // Necessary parameters
@@ -50,11 +59,23 @@ PARAM_STRING("output", "The file in which the predicted labels for the test set"
     " will be written.", "o", "output.csv");
 PARAM_INT("iterations","The maximum number of iterations the perceptron is "
   "to be run", "i", 1000);
+PARAM_INT("shards", "The number of shards to train in parallel with iterative "
+    "parameter mixing (1 trains serially; 0 uses one shard for each thread).",
+    "s", 1);
+PARAM_THREADS();
 
 int main(int argc, char** argv)
 {
   CLI::ParseCommandLine(argc, argv);
 
+  CLI::SetNumThreads("threads");
+
+  if (CLI::GetParam<int>("shards") < 0)
+  {
+    Log::Fatal << "Invalid number of shards (" << CLI::GetParam<int>("shards")
+        << "); must be 0 or greater." << endl;
+  }
+
   // Get reference dataset filename.
   const string trainingDataFilename = CLI::GetParam<string>("train_file");
   mat trainingData;
@@ -102,10 +123,11 @@ int main(int argc, char** argv)
   }
 
   int iterations = CLI::GetParam<int>("iterations");
-  
+  const size_t shards = CLI::GetParam<int>("shards");
+
   // Create and train the classifier.
   Timer::Start("Training");
-  Perceptron<> p(trainingData, labels.t(), iterations);
+  Perceptron<> p(trainingData, labels.t(), iterations, shards);
   Timer::Stop("Training");
 
   // Time the running of the Perceptron Classifier.
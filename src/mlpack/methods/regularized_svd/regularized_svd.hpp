@@ -10,6 +10,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/parallel_sgd.hpp>
 #include <mlpack/methods/cf/cf.hpp>
 
 #include "regularized_svd_function.hpp"
@@ -48,6 +49,19 @@ namespace svd {
  * // Use the Apply() method to get a factorization.
  * rSVD.Apply(data, rank, u, v);
  * @endcode
+ *
+ * To train with several threads, use the ParallelSGD optimizer, which updates
+ * the user and item matrices from all threads without locking:
+ *
+ * @code
+ * RegularizedSVD<mlpack::optimization::ParallelSGD> rSVD(iterations, alpha,
+ *     lambda);
+ * @endcode
+ *
+ * The mini-batch optimizers (MiniBatchSGD, and the adaptive AdaGrad, RMSProp
+ * and Adam) can be used too.  They only update the user and item columns of
+ * the ratings in each batch, so a step takes time proportional to the batch
+ * size.
  */
 
 template<
@@ -61,7 +75,8 @@ class RegularizedSVD
    * Constructor for Regularized SVD. Obtains the user and item matrices after
    * training on the passed data. The constructor initiates an object of class
    * RegularizedSVDFunction for optimization. It uses the SGD optimizer by
-   * default. The optimizer uses a template specialization of Optimize().
+   * default. Both SGD and ParallelSGD use a template specialization of
+   * Optimize().
    *
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
@@ -100,8 +115,8 @@ namespace mlpack {
 namespace cf {
 
 //! Factorizer traits of Regularized SVD.
-template<>
-class FactorizerTraits<mlpack::svd::RegularizedSVD<> >
+template<template<typename> class OptimizerType>
+class FactorizerTraits<mlpack::svd::RegularizedSVD<OptimizerType> >
 {
  public:
   //! Data provided to RegularizedSVD need not be cleaned.
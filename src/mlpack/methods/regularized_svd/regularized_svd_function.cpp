@@ -60,6 +60,17 @@ double RegularizedSVDFunction::Evaluate(const arma::mat& parameters) const
   return cost;
 }
 
+double RegularizedSVDFunction::Evaluate(const arma::mat& parameters,
+                                        const size_t begin,
+                                        const size_t batchSize) const
+{
+  double cost = 0.0;
+  for (size_t i = begin; i < begin + batchSize; i++)
+    cost += Evaluate(parameters, i);
+
+  return cost;
+}
+
 double RegularizedSVDFunction::Evaluate(const arma::mat& parameters,
                                         const size_t i) const
 {
@@ -116,6 +127,51 @@ void RegularizedSVDFunction::Gradient(const arma::mat& parameters,
   }
 }
 
+void RegularizedSVDFunction::Gradient(const arma::mat& parameters,
+                                      const size_t begin,
+                                      arma::uvec& columns,
+                                      arma::mat& gradient,
+                                      const size_t batchSize) const
+{
+  // This is the same as the full gradient, but only the examples in the batch
+  // contribute, so only their user and item columns are nonzero.  Find those
+  // columns first, without duplicates.
+  columns.set_size(2 * batchSize);
+  for (size_t i = 0; i < batchSize; i++)
+  {
+    columns[2 * i] = data(0, begin + i);
+    columns[2 * i + 1] = data(1, begin + i) + numUsers;
+  }
+  std::sort(columns.begin(), columns.end());
+  columns.resize(std::unique(columns.begin(), columns.end()) -
+      columns.begin());
+
+  gradient.zeros(rank, columns.n_elem);
+
+  for (size_t i = begin; i < begin + batchSize; i++)
+  {
+    // Indices for accessing the the correct parameter columns.
+    const size_t user = data(0, i);
+    const size_t item = data(1, i) + numUsers;
+
+    // Positions of those columns in the gradient.
+    const size_t userIndex = std::lower_bound(columns.begin(), columns.end(),
+        user) - columns.begin();
+    const size_t itemIndex = std::lower_bound(columns.begin(), columns.end(),
+        item) - columns.begin();
+
+    // Prediction error for the example.
+    const double rating = data(2, i);
+    double ratingError = rating - arma::dot(parameters.col(user),
+                                            parameters.col(item));
+
+    gradient.col(userIndex) += 2 * (lambda * parameters.col(user) -
+                                    ratingError * parameters.col(item));
+    gradient.col(itemIndex) += 2 * (lambda * parameters.col(item) -
+                                    ratingError * parameters.col(user));
+  }
+}
+
 }; // namespace svd
 }; // namespace mlpack
 
@@ -177,5 +233,76 @@ double SGD<mlpack::svd::RegularizedSVDFunction>::Optimize(arma::mat& parameters)
   return overallObjective;
 }
 
+template<>
+double ParallelSGD<mlpack::svd::RegularizedSVDFunction>::Optimize(
+    arma::mat& parameters)
+{
+  // Find the number of functions to use.
+  const size_t numFunctions = function.NumFunctions();
+
+  const arma::mat& data = function.Dataset();
+  const size_t numUsers = function.NumUsers();
+  const size_t rank = function.Rank();
+  const double lambda = function.Lambda();
+
+  arma::Col<size_t> visitationOrder(numFunctions);
+  for (size_t i = 0; i < numFunctions; ++i)
+    visitationOrder[i] = i;
+
+  // To keep track of where we are and how things are going.
+  size_t iteration = 0;
+  double overallObjective = Evaluate(parameters);
+  double lastObjective = DBL_MAX;
+
+  while (!Terminate(iteration, overallObjective, lastObjective))
+  {
+    if (shuffle) // Determine order of visitation.
+      visitationOrder = arma::shuffle(visitationOrder);
+
+    // Don't take more than maxIterations steps in total.
+    const size_t passSize = (maxIterations == 0) ? numFunctions :
+        std::min(numFunctions, maxIterations - iteration);
+
+    // Each thread takes a contiguous part of the visitation order and updates
+    // the user and item columns of its ratings without locking.  Two threads
+    // only conflict if they happen to visit the same user or item at the same
+    // time.
+    #pragma omp parallel for schedule(static)
+    for (size_t j = 0; j < passSize; ++j)
+    {
+      const size_t i = visitationOrder[j];
+
+      // Indices for accessing the the correct parameter columns.
+      const size_t user = data(0, i);
+      const size_t item = data(1, i) + numUsers;
+
+      double* userVec = parameters.colptr(user);
+      double* itemVec = parameters.colptr(item);
+
+      // Prediction error for the example.
+      double ratingError = data(2, i);
+      for (size_t k = 0; k < rank; ++k)
+        ratingError -= userVec[k] * itemVec[k];
+
+      // Gradient is non-zero only for the parameter columns corresponding to
+      // the example.
+      for (size_t k = 0; k < rank; ++k)
+      {
+        const double userValue = userVec[k];
+        userVec[k] -= stepSize * (lambda * userValue -
+                                  ratingError * itemVec[k]);
+        itemVec[k] -= stepSize * (lambda * itemVec[k] -
+                                  ratingError * userValue);
+      }
+    }
+
+    iteration += passSize;
+    lastObjective = overallObjective;
+    overallObjective = Evaluate(parameters);
+  }
+
+  return overallObjective;
+}
+
 }; // namespace optimization
 }; // namespace mlpack
@@ -10,6 +10,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/parallel_sgd/parallel_sgd.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -47,6 +48,18 @@ class RegularizedSVDFunction
    */
   double Evaluate(const arma::mat& parameters,
                   const size_t i) const;
+
+  /**
+   * Evaluates the cost function for the batch of training examples begin
+   * through (begin + batchSize - 1).  Useful for the MiniBatchSGD optimizer.
+   *
+   * @param parameters Parameters(user/item matrices) of the decomposition.
+   * @param begin Index of the first training example in the batch.
+   * @param batchSize Number of training examples in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
   
   /**
    * Evaluates the full gradient of the cost function over all the training
@@ -57,6 +70,27 @@ class RegularizedSVDFunction
    */
   void Gradient(const arma::mat& parameters,
                 arma::mat& gradient) const;
+
+  /**
+   * Evaluates the gradient of the cost function over the batch of training
+   * examples begin through (begin + batchSize - 1).  Useful for the
+   * MiniBatchSGD optimizer.  The gradient is nonzero only in the user and item
+   * columns of the ratings in the batch, so only those columns are calculated,
+   * and the cost does not depend on the number of users and items.
+   *
+   * @param parameters Parameters(user/item matrices) of the decomposition.
+   * @param begin Index of the first training example in the batch.
+   * @param columns Sorted indices of the parameter columns with a nonzero
+   *     gradient.
+   * @param gradient Calculated gradient for those columns (column k holds the
+   *     gradient of column columns[k] of the parameters).
+   * @param batchSize Number of training examples in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::uvec& columns,
+                arma::mat& gradient,
+                const size_t batchSize) const;
   
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
@@ -109,6 +143,15 @@ namespace optimization {
   double SGD<mlpack::svd::RegularizedSVDFunction>::Optimize(
       arma::mat& parameters);
 
+  /**
+   * Template specialization for the ParallelSGD optimizer.  Each thread updates
+   * the user and item columns of its ratings directly, without forming a
+   * sparse gradient.
+   */
+  template<>
+  double ParallelSGD<mlpack::svd::RegularizedSVDFunction>::Optimize(
+      arma::mat& parameters);
+
 }; // namespace optimization
 }; // namespace mlpack
 
@@ -92,29 +92,16 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
   // The cost also takes into account the regularization to control the
   // parameter weights.
   
-  // Calculate the class probabilities for each training example. The
-  // probabilities for each of the classes are given by:
-  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
-  // The sum is calculated over all the classes.
-  // x_i is the input vector for a particular training example.
-  // theta_j is the parameter vector associated with a particular class.
-  arma::mat hypothesis, probabilities;
-  
-  hypothesis = arma::exp(parameters * data);
-  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
-                                            numClasses, 1);
-                                            
-  // Calculate the log likelihood and regularization terms.
-  double logLikelihood, weightDecay, cost;
-  
-  logLikelihood = arma::accu(groundTruth % arma::log(probabilities)) /
-      data.n_cols;
-  weightDecay = 0.5 * lambda * arma::accu(parameters % parameters);
-  
-  // The cost is the sum of the negative log likelihood and the regularization
-  // terms. 
-  cost = -logLikelihood + weightDecay;
-      
+  // The cost is a sum over the training examples (the weight decay is split
+  // evenly between them), so the examples are split into batches that are
+  // evaluated in parallel.
+  double cost = 0.0;
+  math::ParallelColumnReduce(0, data.n_cols,
+      [&](const size_t begin, const size_t end, double& batchCost)
+      {
+        batchCost = Evaluate(parameters, begin, end - begin);
+      }, cost);
+
   return cost;
 }
 
@@ -124,19 +111,138 @@ double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters) const
 void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
                                          arma::mat& gradient) const
 {
-  // Calculate the class probabilities for each training example. The
-  // probabilities for each of the classes are given by:
-  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
-  // The sum is calculated over all the classes.
-  // x_i is the input vector for a particular training example.
-  // theta_j is the parameter vector associated with a particular class.
+  // The gradient is a sum over the training examples, so the examples are
+  // split into batches whose gradients are calculated in parallel.
+  math::ParallelColumnReduce(0, data.n_cols,
+      [&](const size_t begin, const size_t end, arma::mat& batchGradient)
+      {
+        Gradient(parameters, begin, batchGradient, end - begin);
+      }, gradient);
+}
+
+/**
+ * Evaluates the objective function over a batch of training examples.
+ */
+double SoftmaxRegressionFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t begin,
+                                           const size_t batchSize) const
+{
+  // An empty batch contributes nothing (and can't be sliced).
+  if (batchSize == 0)
+    return 0.0;
+
+  // Calculate the class probabilities for the examples in the batch.
   arma::mat hypothesis, probabilities;
-  
-  hypothesis = arma::exp(parameters * data);
+
+  hypothesis = arma::exp(parameters * data.cols(begin, begin + batchSize - 1));
+  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
+                                            numClasses, 1);
+
+  // Only the probability of the correct class contributes to the log
+  // likelihood.
+  double logLikelihood = 0.0;
+  for (size_t i = 0; i < batchSize; i++)
+    logLikelihood += std::log(probabilities((size_t) labels(begin + i), i));
+  logLikelihood /= data.n_cols;
+
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters % parameters)
+      * batchSize / data.n_cols;
+
+  return -logLikelihood + weightDecay;
+}
+
+/**
+ * Calculates the gradient over a batch of training examples.
+ */
+void SoftmaxRegressionFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         arma::mat& gradient,
+                                         const size_t batchSize) const
+{
+  // An empty batch contributes nothing (and can't be sliced).
+  if (batchSize == 0)
+  {
+    gradient.zeros(parameters.n_rows, parameters.n_cols);
+    return;
+  }
+
+  // Calculate the class probabilities for the examples in the batch.
+  arma::mat hypothesis, probabilities;
+
+  hypothesis = arma::exp(parameters * data.cols(begin, begin + batchSize - 1));
   probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
                                             numClasses, 1);
-                                            
-  // Calculate the parameter gradients.
-  gradient = (probabilities - groundTruth) * data.t() / data.n_cols +
-      lambda * parameters;
+
+  // Subtract the ground truth, which is 1 for the correct class of each
+  // example.
+  for (size_t i = 0; i < batchSize; i++)
+    probabilities((size_t) labels(begin + i), i) -= 1.0;
+
+  gradient = (probabilities * data.cols(begin, begin + batchSize - 1).t() +
+      lambda * batchSize * parameters) / data.n_cols;
+}
+
+/**
+ * Evaluates the objective function and its gradient given the parameters.
+ */
+double SoftmaxRegressionFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  // As in Evaluate() and Gradient(), the examples are split into batches that
+  // are handled in parallel.
+  double cost = 0.0;
+  math::ParallelColumnReduce(0, data.n_cols,
+      [&](const size_t begin, const size_t end, double& batchCost,
+          arma::mat& batchGradient)
+      {
+        batchCost = EvaluateWithGradient(parameters, begin, batchGradient,
+            end - begin);
+      }, cost, gradient);
+
+  return cost;
+}
+
+/**
+ * Evaluates the objective function and its gradient over a batch of training
+ * examples.
+ */
+double SoftmaxRegressionFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  // An empty batch contributes nothing (and can't be sliced).
+  if (batchSize == 0)
+  {
+    gradient.zeros(parameters.n_rows, parameters.n_cols);
+    return 0.0;
+  }
+
+  // Calculate the class probabilities for the examples in the batch.  These are
+  // used for both the cost and the gradient.
+  arma::mat hypothesis, probabilities;
+
+  hypothesis = arma::exp(parameters * data.cols(begin, begin + batchSize - 1));
+  probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
+                                            numClasses, 1);
+
+  // Only the probability of the correct class contributes to the log
+  // likelihood; then the ground truth is subtracted for the gradient.
+  double logLikelihood = 0.0;
+  for (size_t i = 0; i < batchSize; i++)
+  {
+    logLikelihood += std::log(probabilities((size_t) labels(begin + i), i));
+    probabilities((size_t) labels(begin + i), i) -= 1.0;
+  }
+  logLikelihood /= data.n_cols;
+
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters % parameters)
+      * batchSize / data.n_cols;
+
+  gradient = (probabilities * data.cols(begin, begin + batchSize - 1).t() +
+      lambda * batchSize * parameters) / data.n_cols;
+
+  return -logLikelihood + weightDecay;
 }
@@ -64,9 +64,69 @@ class SoftmaxRegressionFunction
    * @param gradient Matrix where gradient values will be stored.
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
-  
+
+  /**
+   * Evaluates the objective function over only the batch of training examples
+   * begin through (begin + batchSize - 1).  The regularization cost is scaled
+   * by the fraction of examples in the batch, so that the sum over all batches
+   * is the value of Evaluate(parameters).  This is useful for optimizers such
+   * as MiniBatchSGD.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first example in the batch.
+   * @param batchSize Number of examples in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
+
+  /**
+   * Evaluates the gradient of the objective function over only the batch of
+   * training examples begin through (begin + batchSize - 1).  As with the
+   * batch Evaluate(), the sum over all batches is the full gradient.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first example in the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of examples in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize) const;
+
+  /**
+   * Evaluates the objective function and its gradient given the current set of
+   * parameters.  This is faster than calling Evaluate() and Gradient()
+   * separately, because the class probabilities are only calculated once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   * @return Value of the objective function.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluates the objective function and its gradient over only the batch of
+   * training examples begin through (begin + batchSize - 1).
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first example in the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of examples in the batch.
+   * @return Value of the objective function over the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize) const;
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
+
+  //! Return the number of training examples.
+  size_t NumFunctions() const { return data.n_cols; }
   
   //! Sets the size of the input vector.
   void InputSize(const size_t input)
@@ -91,23 +91,39 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
+  // The activations are computed for batches of the data in parallel.  For
+  // each batch we need the sum of the hidden layer activations and the sum of
+  // the squared reconstruction errors; these are stored in one vector, with the
+  // squared error as the last element, so they can be summed together.
+  arma::vec sums;
+  math::ParallelColumnReduce(0, data.n_cols,
+      [&](const size_t begin, const size_t end, arma::vec& batchSums)
+      {
+        batchSums.zeros(hiddenSize + 1);
+        if (begin == end)
+          return;
+
+        const size_t batchSize = end - begin;
+        arma::mat hiddenLayer, outputLayer;
+
+        // Compute activations of the hidden and output layers.
+        Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) *
+            data.cols(begin, end - 1) + arma::repmat(parameters.submat(0, l2,
+            l1 - 1, l2), 1, batchSize), hiddenLayer);
+
+        Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
+            arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1,
+            batchSize), outputLayer);
+
+        // Difference between the reconstructed data and the original data.
+        const arma::mat diff = outputLayer - data.cols(begin, end - 1);
+
+        batchSums.subvec(0, hiddenSize - 1) = arma::sum(hiddenLayer, 1);
+        batchSums[hiddenSize] = arma::accu(diff % diff);
+      }, sums);
 
   // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
+  const arma::vec rhoCap = sums.subvec(0, hiddenSize - 1) / data.n_cols;
 
   double wL2SquaredNorm;
 
@@ -123,7 +139,7 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
-  sumOfSquaresError = 0.5 * arma::accu(diff % diff) / data.n_cols;
+  sumOfSquaresError = 0.5 * sums[hiddenSize] / data.n_cols;
   weightDecay = 0.5 * lambda * wL2SquaredNorm;
   klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) + (1 - rho) *
       arma::log((1 - rho) / (1 - rhoCap)));
@@ -138,6 +154,19 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   */
 void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
                                          arma::mat& gradient) const
+{
+  // The objective is cheap to compute along with the gradient, so there is no
+  // need for a separate implementation.
+  EvaluateWithGradient(parameters, gradient);
+}
+
+/**
+ * Calculates the objective function and stores the gradient values given a set
+ * of parameters.
+ */
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
 {
   // Performs a feedforward pass of the neural network, and computes the
   // activations of the output layer as in the Evaluate() method. It uses the
@@ -158,25 +187,30 @@ void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
+  // The work is split between threads in two passes over the data, because the
+  // delta values of the hidden layer depend on the average activations of the
+  // hidden layer over the whole dataset.  The first pass computes the hidden
+  // layer activations; each thread writes its own columns.
+  arma::mat hiddenLayer(hiddenSize, data.n_cols);
+  arma::vec hiddenSums;
+  math::ParallelColumnReduce(0, data.n_cols,
+      [&](const size_t begin, const size_t end, arma::vec& batchSums)
+      {
+        batchSums.zeros(hiddenSize);
+        if (begin == end)
+          return;
+
+        arma::mat batchHidden;
+        Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) *
+            data.cols(begin, end - 1) + arma::repmat(parameters.submat(0, l2,
+            l1 - 1, l2), 1, end - begin), batchHidden);
+
+        hiddenLayer.cols(begin, end - 1) = batchHidden;
+        batchSums = arma::sum(batchHidden, 1);
+      }, hiddenSums);
 
   // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  arma::mat klDivGrad, delOut, delHid;
+  const arma::vec rhoCap = hiddenSums / data.n_cols;
 
   // The delta vector for the output layer is given by diff * f'(z), where z is
   // the preactivation and f is the activation function. The derivative of the
@@ -184,22 +218,59 @@ void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
   // in the neural network which comes before the output layer, the delta values
   // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
   // includes the KL divergence term, we adjust for that in the formula below.
-  klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
-  delOut = diff % outputLayer % (1 - outputLayer);
-  delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      arma::repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
-      (1 - hiddenLayer);
-
-  gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
-
-  // Compute the gradient values using the activations and the delta values. The
-  // formula also accounts for the regularization terms in the objective.
-  // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
-      lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
-  gradient.submat(l1, 0, l3 - 1, l2 - 1) =
-      (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
-  gradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / data.n_cols;
-  gradient.submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) / data.n_cols).t();
+  const arma::vec klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+      (1 - rhoCap));
+
+  // The second pass computes the output layer and the delta values of each
+  // batch, and sums the squared reconstruction errors and the unregularized
+  // gradients of the batches.
+  double squaredError = 0.0;
+  math::ParallelColumnReduce(0, data.n_cols,
+      [&](const size_t begin, const size_t end, double& batchSquaredError,
+          arma::mat& batchGradient)
+      {
+        batchSquaredError = 0;
+        batchGradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
+        if (begin == end)
+          return;
+
+        const size_t batchSize = end - begin;
+        const arma::mat batchHidden = hiddenLayer.cols(begin, end - 1);
+
+        arma::mat outputLayer;
+        Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * batchHidden +
+            arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1,
+            batchSize), outputLayer);
+
+        // Difference between the reconstructed data and the original data.
+        const arma::mat diff = outputLayer - data.cols(begin, end - 1);
+        batchSquaredError = arma::accu(diff % diff);
+
+        const arma::mat delOut = diff % outputLayer % (1 - outputLayer);
+        const arma::mat delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) *
+            delOut + arma::repmat(klDivGrad, 1, batchSize)) % batchHidden %
+            (1 - batchHidden);
+
+        batchGradient.submat(0, 0, l1 - 1, l2 - 1) = delHid *
+            data.cols(begin, end - 1).t();
+        batchGradient.submat(l1, 0, l3 - 1, l2 - 1) = batchHidden * delOut.t();
+        batchGradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1);
+        batchGradient.submat(l3, 0, l3, l2 - 1) = arma::sum(delOut, 1).t();
+      }, squaredError, gradient);
+
+  // Average the gradient over the data, and add the regularization terms of the
+  // weights w1 and w2.
+  gradient /= data.n_cols;
+  gradient.submat(0, 0, l3 - 1, l2 - 1) += lambda *
+      parameters.submat(0, 0, l3 - 1, l2 - 1);
+
+  // The terms of the objective are the same as in Evaluate().
+  const double sumOfSquaresError = 0.5 * squaredError / data.n_cols;
+  const double weightDecay = 0.5 * lambda * arma::accu(
+      parameters.submat(0, 0, l3 - 1, l2 - 1) %
+      parameters.submat(0, 0, l3 - 1, l2 - 1));
+  const double klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) +
+      (1 - rho) * arma::log((1 - rho) / (1 - rhoCap)));
+
+  return sumOfSquaresError + weightDecay + klDivergence;
 }
@@ -45,6 +45,12 @@ problems.  It should only be necessary to include <mlpack/core.hpp> and not\
   #define force_inline __forceinline
 #endif
 
+// If OpenMP is available, include it.  Parallelized code uses '#pragma omp' so
+// that it still compiles (serially) when OpenMP is not available.
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 // Now include Armadillo through the special mlpack extensions.
 #include <mlpack/core/arma_extend/arma_extend.hpp>
 
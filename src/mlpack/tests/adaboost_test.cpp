@@ -717,4 +717,51 @@ BOOST_AUTO_TEST_CASE(ClassifyTest_IRIS)
   BOOST_REQUIRE(lError <= 0.30);
 }
 
+/**
+ *  This test case checks that classification with the ensemble does not depend
+ *  on how the test points are split into blocks (or on the number of threads):
+ *  classifying a large set at once should give the same labels as classifying
+ *  it in pieces, and the same labels as with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ClassifyBlocksTest)
+{
+  // Three classes in a noisy, overlapping dataset with more points than one
+  // block.
+  arma::mat inputData = arma::randn<arma::mat>(3, 10000);
+  arma::Row<size_t> labels(inputData.n_cols);
+  for (size_t i = 0; i < inputData.n_cols; i++)
+  {
+    labels[i] = i % 3;
+    inputData(labels[i], i) += 2.0;
+  }
+
+  decision_stump::DecisionStump<> ds(inputData, labels, 3, 10);
+  AdaBoost<arma::mat, mlpack::decision_stump::DecisionStump<> > a(inputData,
+      labels, 20, 1e-10, ds);
+
+  arma::Row<size_t> predictedLabels;
+  a.Classify(inputData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, inputData.n_cols);
+
+  arma::Row<size_t> firstLabels, secondLabels;
+  a.Classify(inputData.cols(0, 4999), firstLabels);
+  a.Classify(inputData.cols(5000, 9999), secondLabels);
+  for (size_t i = 0; i < 5000; i++)
+  {
+    BOOST_REQUIRE_EQUAL(predictedLabels[i], firstLabels[i]);
+    BOOST_REQUIRE_EQUAL(predictedLabels[5000 + i], secondLabels[i]);
+  }
+
+#ifdef _OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  arma::Row<size_t> serialLabels;
+  a.Classify(inputData, serialLabels);
+  omp_set_num_threads(threads);
+
+  for (size_t i = 0; i < inputData.n_cols; i++)
+    BOOST_REQUIRE_EQUAL(predictedLabels[i], serialLabels[i]);
+#endif
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,114 @@
+/**
+ * @file adaptive_sgd_test.cpp
+ *
+ * Tests for the AdaGrad, RMSProp, and Adam optimizers.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/optimizers/adaptive_sgd/adaptive_sgd.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+#include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "old_boost_test_definitions.hpp"
+
+using namespace mlpack;
+using namespace mlpack::regression;
+using namespace mlpack::optimization;
+using namespace mlpack::distribution;
+
+BOOST_AUTO_TEST_SUITE(AdaptiveSGDTest);
+
+/**
+ * Train logistic regression with the given optimizer on an interleaved
+ * two-Gaussian dataset, and make sure that the training and test accuracy are
+ * close to 100%.
+ */
+template<template<typename> class OptimizerType>
+void LogisticRegressionGaussianTest()
+{
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::vec responses(1000);
+  for (size_t i = 0; i < 1000; i += 2)
+  {
+    data.col(i) = g1.Random();
+    responses[i] = 0;
+    data.col(i + 1) = g2.Random();
+    responses[i + 1] = 1;
+  }
+
+  // Train with the default parameters, which should be reasonable for each
+  // optimizer.
+  LogisticRegression<OptimizerType> lr(data, responses, 0.5);
+
+  const double acc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 0.3); // 0.3% error tolerance.
+
+  // Create a test set.
+  for (size_t i = 0; i < 1000; i += 2)
+  {
+    data.col(i) = g1.Random();
+    data.col(i + 1) = g2.Random();
+  }
+
+  const double testAcc = lr.ComputeAccuracy(data, responses);
+  BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
+}
+
+BOOST_AUTO_TEST_CASE(AdaGradLogisticRegressionTest)
+{
+  LogisticRegressionGaussianTest<AdaGrad>();
+}
+
+BOOST_AUTO_TEST_CASE(RMSPropLogisticRegressionTest)
+{
+  LogisticRegressionGaussianTest<RMSProp>();
+}
+
+BOOST_AUTO_TEST_CASE(AdamLogisticRegressionTest)
+{
+  LogisticRegressionGaussianTest<Adam>();
+}
+
+/**
+ * Make sure Adam can be used to train RegularizedSVD, and reaches a low error
+ * on a dataset generated from a low-rank model.
+ */
+BOOST_AUTO_TEST_CASE(AdamRegularizedSVDTest)
+{
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 1000;
+  const size_t rank = 5;
+
+  // Make a random rating dataset from random parameters.
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  arma::mat u, v;
+  svd::RegularizedSVD<Adam> rsvd(200, 0.01, 0.0);
+  rsvd.Apply(data, rank, u, v);
+
+  // Calculate the relative error of the predictions.
+  arma::rowvec predictions(numRatings);
+  for (size_t i = 0; i < numRatings; i++)
+    predictions[i] = arma::dot(u.row(data(1, i)), v.col(data(0, i)));
+
+  const double relativeError = arma::norm(data.row(2) - predictions, 2) /
+      arma::norm(data.row(2), 2);
+
+  BOOST_REQUIRE_SMALL(relativeError, 0.1);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -61,5 +61,44 @@ BOOST_AUTO_TEST_CASE(GockenbachFunctionTest)
   BOOST_REQUIRE_CLOSE(coords[2], 0.015099932, 1e-3);
 }
 
+/**
+ * Make sure that AugLagrangianFunction::EvaluateWithGradient() gives the same
+ * results as Evaluate() and Gradient().
+ */
+BOOST_AUTO_TEST_CASE(AugLagrangianFunctionEvaluateWithGradientTest)
+{
+  GockenbachFunction f;
+  AugLagrangianFunction<GockenbachFunction> alf(f, arma::vec("1.5 -0.5"),
+      10.0);
+
+  BOOST_REQUIRE(HasEvaluateWithGradient<
+      AugLagrangianFunction<GockenbachFunction> >::value);
+
+  for (size_t trial = 0; trial < 10; ++trial)
+  {
+    arma::mat coordinates(3, 1);
+    coordinates.randn();
+
+    const double objective = alf.Evaluate(coordinates);
+    arma::mat gradient;
+    alf.Gradient(coordinates, gradient);
+
+    arma::mat fusedGradient;
+    const double fusedObjective = alf.EvaluateWithGradient(coordinates,
+        fusedGradient);
+
+    BOOST_REQUIRE_CLOSE(fusedObjective, objective, 1e-5);
+    BOOST_REQUIRE_EQUAL(fusedGradient.n_rows, gradient.n_rows);
+    BOOST_REQUIRE_EQUAL(fusedGradient.n_cols, gradient.n_cols);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+    {
+      if (std::abs(gradient[i]) < 1e-8)
+        BOOST_REQUIRE_SMALL(fusedGradient[i], 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(fusedGradient[i], gradient[i], 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
@@ -175,4 +175,61 @@ BOOST_AUTO_TEST_CASE(RecommendationAccuracyTest)
   BOOST_REQUIRE_LT(failures, 100);
 }
 
+/**
+ * Make sure that the recommendations computed from the factors directly are
+ * the same as the ones computed by forming the full rating matrix W * H,
+ * searching for neighbors in it, and averaging the neighbors' ratings.
+ */
+BOOST_AUTO_TEST_CASE(FactoredRecommendationsMatchDenseTest)
+{
+  const size_t numUsers = 50;
+  const size_t numRecs = 5;
+  const size_t neighborhoodSize = 5;
+
+  arma::Col<size_t> users(numUsers);
+  for (size_t i = 0; i < numUsers; i++)
+    users(i) = i;
+
+  arma::mat dataset;
+  data::Load("GroupLens100k.csv", dataset);
+
+  CF<> c(dataset, amf::NMFALSFactorizer(), neighborhoodSize, 10);
+
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(numRecs, recommendations, users);
+
+  // Now compute the recommendations the slow way.
+  const arma::mat rating = c.Rating();
+  arma::mat query(rating.n_rows, numUsers);
+  for (size_t i = 0; i < numUsers; i++)
+    query.col(i) = rating.col(users(i));
+
+  arma::Mat<size_t> neighborhood;
+  arma::mat distances;
+  neighbor::AllkNN a(rating, query);
+  a.Search(neighborhoodSize, neighborhood, distances);
+
+  size_t matches = 0;
+  for (size_t i = 0; i < numUsers; i++)
+  {
+    arma::vec averages = arma::zeros<arma::vec>(rating.n_rows);
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      averages += rating.col(neighborhood(j, i));
+    averages /= neighborhood.n_rows;
+
+    // Rated items can't be recommended.
+    for (size_t j = 0; j < averages.n_elem; ++j)
+      if (c.CleanedData()(j, users(i)) != 0.0)
+        averages[j] = -DBL_MAX;
+
+    const arma::uvec order = arma::sort_index(averages, 1);
+    for (size_t k = 0; k < numRecs; ++k)
+      if (recommendations(k, i) == order[k])
+        ++matches;
+  }
+
+  // Allow for a few differences because of floating-point ties.
+  BOOST_REQUIRE_GE(matches, size_t(0.95 * numUsers * numRecs));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -307,4 +307,101 @@ BOOST_AUTO_TEST_CASE(DimensionSelectionTest)
   }
 }
 
+/**
+ * A weighted stump constructed from a weighted stump trained on the same data
+ * reuses its sort order; make sure it is the same as the stump found when the
+ * data has to be sorted again.  The data has many ties, to check that they are
+ * ordered the same way.
+ */
+BOOST_AUTO_TEST_CASE(PresortedWeightedStumpTest)
+{
+  const size_t numClasses = 3;
+  const size_t inpBucketSize = 4;
+
+  arma::mat dataset = arma::floor(5.0 * arma::randu<arma::mat>(4, 300));
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = (dataset(2, i) < 2.0) ? 0 : ((dataset(2, i) < 4.0) ? 1 :
+        math::RandInt(numClasses));
+
+  // This stump is trained on the same data, and the other on different data.
+  // Only a stump trained with weights keeps its sort order.
+  DecisionStump<> initialDs(dataset, labels, numClasses, inpBucketSize);
+  const arma::rowvec uniformWeights = arma::ones<arma::rowvec>(dataset.n_cols) /
+      dataset.n_cols;
+  DecisionStump<> ds(initialDs, dataset, uniformWeights, labels);
+  arma::mat otherDataset = arma::randu<arma::mat>(4, 300);
+  DecisionStump<> otherDs(otherDataset, labels, numClasses, inpBucketSize);
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    const arma::rowvec weights = arma::randu<arma::rowvec>(dataset.n_cols) /
+        dataset.n_cols;
+
+    DecisionStump<> presorted(ds, dataset, weights, labels);
+    DecisionStump<> sorted(otherDs, dataset, weights, labels);
+
+    BOOST_REQUIRE_EQUAL(presorted.SplitAttribute(), sorted.SplitAttribute());
+    BOOST_REQUIRE_EQUAL(presorted.Split().n_elem, sorted.Split().n_elem);
+    for (size_t i = 0; i < sorted.Split().n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(presorted.Split()[i], sorted.Split()[i]);
+      BOOST_REQUIRE_EQUAL(presorted.BinLabels()[i], sorted.BinLabels()[i]);
+    }
+  }
+}
+
+/**
+ * Train a stump on quantized data, and make sure it splits on the separable
+ * dimension and classifies most points correctly.  Also make sure a weighted
+ * stump reusing the bins gives the same result as one that has to compute them.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedStumpTest)
+{
+  const size_t numClasses = 2;
+  const size_t inpBucketSize = 10;
+  const size_t bins = 32;
+
+  // Only the second dimension separates the classes.
+  arma::mat dataset = arma::randn<arma::mat>(3, 2000);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = (i < 1000) ? 0 : 1;
+    dataset(1, i) += (i < 1000) ? -5.0 : 5.0;
+  }
+
+  DecisionStump<> ds(dataset, labels, numClasses, inpBucketSize, bins);
+  BOOST_REQUIRE_EQUAL(ds.Bins(), bins);
+  BOOST_REQUIRE_EQUAL(ds.SplitAttribute(), 1);
+
+  arma::Row<size_t> predictedLabels(dataset.n_cols);
+  ds.Classify(dataset, predictedLabels);
+  size_t correct = 0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    if (predictedLabels[i] == labels[i])
+      ++correct;
+  BOOST_REQUIRE_GT(correct, 1980);
+
+  arma::mat otherDataset = arma::randu<arma::mat>(3, 2000);
+  DecisionStump<> otherDs(otherDataset, labels, numClasses, inpBucketSize,
+      bins);
+
+  // Only a stump trained with weights keeps its bins.
+  const arma::rowvec weights = arma::randu<arma::rowvec>(dataset.n_cols) /
+      dataset.n_cols;
+  DecisionStump<> weightedDs(ds, dataset, weights, labels);
+  DecisionStump<> reused(weightedDs, dataset, weights, labels);
+  DecisionStump<> quantized(otherDs, dataset, weights, labels);
+
+  BOOST_REQUIRE_EQUAL(reused.Bins(), bins);
+  BOOST_REQUIRE_EQUAL(reused.SplitAttribute(), quantized.SplitAttribute());
+  BOOST_REQUIRE_EQUAL(reused.Split().n_elem, quantized.Split().n_elem);
+  for (size_t i = 0; i < quantized.Split().n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(reused.Split()[i], quantized.Split()[i]);
+    BOOST_REQUIRE_EQUAL(reused.BinLabels()[i], quantized.BinLabels()[i]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -18,6 +18,7 @@
 
 #include <mlpack/methods/det/dtree.hpp>
 #include <mlpack/methods/det/dt_utils.hpp>
+#include <mlpack/methods/det/flat_dtree.hpp>
 
 #ifndef _WIN32
   #undef protected
@@ -106,9 +107,12 @@ BOOST_AUTO_TEST_CASE(TestFindSplit)
   trueLeftError = 2 * log(2.0 / 5.0) - (log(7.0) + log(4.0) + log(4.5));
   trueRightError = 2 * log(3.0 / 5.0) - (log(7.0) + log(4.0) + log(2.5));
 
+  arma::Col<size_t> indices(5);
+  indices << 0 << 1 << 2 << 3 << 4;
+
   testDTree.logVolume = log(7.0) + log(4.0) + log(7.0);
-  BOOST_REQUIRE(testDTree.FindSplit(testData, obDim, obSplit, obLeftError,
-      obRightError, 1));
+  BOOST_REQUIRE(testDTree.FindSplit(testData, indices, obDim, obSplit,
+      obLeftError, obRightError, 1));
 
   BOOST_REQUIRE(trueDim == obDim);
   BOOST_REQUIRE_CLOSE(trueSplit, obSplit, 1e-10);
@@ -128,7 +132,7 @@ BOOST_AUTO_TEST_CASE(TestSplitData)
   DTree testDTree(testData);
 
   arma::Col<size_t> oTest(5);
-  oTest << 1 << 2 << 3 << 4 << 5;
+  oTest << 0 << 1 << 2 << 3 << 4;
 
   size_t splitDim = 2;
   double trueSplitVal = 5.5;
@@ -138,11 +142,11 @@ BOOST_AUTO_TEST_CASE(TestSplitData)
 
   BOOST_REQUIRE_EQUAL(splitInd, 2); // 2 points on left side.
 
-  BOOST_REQUIRE_EQUAL(oTest[0], 1);
-  BOOST_REQUIRE_EQUAL(oTest[1], 4);
-  BOOST_REQUIRE_EQUAL(oTest[2], 3);
-  BOOST_REQUIRE_EQUAL(oTest[3], 2);
-  BOOST_REQUIRE_EQUAL(oTest[4], 5);
+  BOOST_REQUIRE_EQUAL(oTest[0], 0);
+  BOOST_REQUIRE_EQUAL(oTest[1], 3);
+  BOOST_REQUIRE_EQUAL(oTest[2], 2);
+  BOOST_REQUIRE_EQUAL(oTest[3], 1);
+  BOOST_REQUIRE_EQUAL(oTest[4], 4);
 }
 #endif
 
@@ -212,6 +216,56 @@ BOOST_AUTO_TEST_CASE(TestGrow)
   BOOST_REQUIRE_CLOSE(alpha, min(rootAlpha, rAlpha), 1e-10);
 }
 
+/**
+ * Make sure that a tree grown on the indices of a subset of the dataset is the
+ * same as a tree grown on a copy of that subset, and that the dataset is not
+ * modified.
+ */
+BOOST_AUTO_TEST_CASE(TestGrowIndices)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200);
+  const arma::mat originalDataset(dataset);
+
+  // Take every other point.
+  arma::Col<size_t> indices(100);
+  arma::mat subset(3, 100);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    indices[i] = 2 * i;
+    subset.col(i) = dataset.col(2 * i);
+  }
+
+  arma::Col<size_t> oldFromNew(100);
+  for (size_t i = 0; i < 100; ++i)
+    oldFromNew[i] = i;
+
+  DTree subsetDTree(subset);
+  const double alpha = subsetDTree.Grow(subset, oldFromNew, false, 10, 5);
+
+  DTree indicesDTree(subsetDTree.MaxVals(), subsetDTree.MinVals(), 100);
+  const double indicesAlpha = indicesDTree.GrowIndices(dataset, indices, false,
+      10, 5);
+
+  BOOST_REQUIRE_CLOSE(alpha, indicesAlpha, 1e-10);
+  BOOST_REQUIRE_EQUAL(subsetDTree.SubtreeLeaves(),
+      indicesDTree.SubtreeLeaves());
+
+  // The points are reordered in the same way.
+  for (size_t i = 0; i < 100; ++i)
+    BOOST_REQUIRE_EQUAL(indices[i], 2 * oldFromNew[i]);
+
+  // The density estimates are the same.
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    arma::vec point = dataset.col(i);
+    BOOST_REQUIRE_CLOSE(subsetDTree.ComputeValue(point),
+        indicesDTree.ComputeValue(point), 1e-10);
+  }
+
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(dataset[i], originalDataset[i]);
+}
+
 BOOST_AUTO_TEST_CASE(TestPruneAndUpdate)
 {
   arma::mat testData(3, 5);
@@ -277,6 +331,53 @@ BOOST_AUTO_TEST_CASE(TestComputeValue)
   BOOST_REQUIRE_CLOSE(0.0, testDTree.ComputeValue(q4), 1e-10);
 }
 
+/**
+ * Make sure that the batch ComputeValue() (which goes through FlatDTree) gives
+ * the same results as the single-point ComputeValue(), before and after
+ * pruning.
+ */
+BOOST_AUTO_TEST_CASE(TestBatchComputeValue)
+{
+  arma::mat testData(3, 5);
+
+  testData << 4 << 5 << 7 << 3 << 5 << arma::endr
+           << 5 << 0 << 1 << 7 << 1 << arma::endr
+           << 5 << 6 << 7 << 1 << 8 << arma::endr;
+
+  arma::mat queries(3, 4);
+  queries << 4 << 5 << 5 << 2 << arma::endr
+          << 2 << 0.25 << 3 << 3 << arma::endr
+          << 2 << 6 << 7 << 3 << arma::endr;
+
+  arma::Col<size_t> oTest(5);
+  oTest << 0 << 1 << 2 << 3 << 4;
+
+  DTree testDTree(testData);
+  double alpha = testDTree.Grow(testData, oTest, false, 2, 1);
+
+  arma::vec values;
+  testDTree.ComputeValue(queries, values);
+
+  BOOST_REQUIRE_EQUAL(values.n_elem, 4);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    const arma::vec query = queries.col(i);
+    BOOST_REQUIRE_CLOSE(values[i], testDTree.ComputeValue(query), 1e-10);
+  }
+
+  FlatDTree flatTree(testDTree);
+  BOOST_REQUIRE_EQUAL(flatTree.NumNodes(), 2 * testDTree.SubtreeLeaves() - 1);
+
+  testDTree.PruneAndUpdate(alpha, testData.n_cols, false);
+  testDTree.ComputeValue(queries, values);
+
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    const arma::vec query = queries.col(i);
+    BOOST_REQUIRE_CLOSE(values[i], testDTree.ComputeValue(query), 1e-10);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(TestVariableImportance)
 {
   arma::mat testData(3, 5);
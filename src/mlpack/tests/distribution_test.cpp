@@ -356,4 +356,142 @@ BOOST_AUTO_TEST_CASE(GaussianDistributionEstimateTest)
       BOOST_REQUIRE_SMALL(d.Covariance()(i, j) - actualCov(i, j), 1e-5);
 }
 
+/**
+ * Make sure the log probabilities are the logs of the probabilities, for single
+ * points and for batches, and that setting the covariance updates the cached
+ * factorization.
+ */
+BOOST_AUTO_TEST_CASE(GaussianDistributionLogProbabilityTest)
+{
+  arma::vec mean = "5 6 3 3 2";
+  arma::mat cov = "6 1 1 1 2;"
+                  "1 7 1 0 0;"
+                  "1 1 4 1 1;"
+                  "1 0 1 7 0;"
+                  "2 0 1 0 6";
+
+  GaussianDistribution g(mean, cov);
+
+  arma::mat points = "0 3 -1 5;"
+                     "1 6 2 6;"
+                     "2 3 0 3;"
+                     "3 2 1 3;"
+                     "4 1 0 2";
+
+  arma::vec logProbabilities;
+  g.LogProbability(points, logProbabilities);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, 4);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const double p = g.Probability(points.unsafe_col(i));
+    BOOST_REQUIRE_CLOSE(g.LogProbability(points.unsafe_col(i)), log(p), 1e-5);
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], log(p), 1e-5);
+  }
+
+  // The density at the mean depends only on the determinant of the covariance.
+  BOOST_REQUIRE_CLOSE(g.LogProbability(mean),
+      -0.5 * (5 * log(2 * M_PI) + log(arma::det(cov))), 1e-5);
+
+  // Now change the covariance, both through the setter and through the
+  // modifiable reference, and make sure the results agree.
+  arma::mat newCov = 2 * cov;
+  GaussianDistribution g2(mean, cov);
+  g.Covariance(newCov);
+  g2.Covariance() = newCov;
+
+  g.LogProbability(points, logProbabilities);
+  arma::vec logProbabilities2;
+  g2.LogProbability(points, logProbabilities2);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], logProbabilities2[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(g.LogProbability(points.unsafe_col(i)),
+        logProbabilities2[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that a diagonal Gaussian gives the same results as a Gaussian with
+ * the equivalent diagonal covariance matrix.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionProbabilityTest)
+{
+  arma::vec mean = "5 6 3 3 2";
+  arma::vec variances = "6 7 4 0.5 2";
+
+  DiagonalGaussianDistribution d(mean, variances);
+  GaussianDistribution g(mean, arma::diagmat(variances));
+
+  arma::mat points = "0 3 -1 5;"
+                     "1 6 2 6;"
+                     "2 3 0 3;"
+                     "3 2 1 3;"
+                     "4 1 0 2";
+
+  arma::vec logProbabilities, probabilities;
+  d.LogProbability(points, logProbabilities);
+  d.Probability(points, probabilities);
+
+  BOOST_REQUIRE_EQUAL(d.Dimensionality(), 5);
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, 4);
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, 4);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    const double logP = g.LogProbability(points.unsafe_col(i));
+    BOOST_REQUIRE_CLOSE(d.LogProbability(points.unsafe_col(i)), logP, 1e-5);
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], logP, 1e-5);
+    BOOST_REQUIRE_CLOSE(d.Probability(points.unsafe_col(i)), exp(logP), 1e-5);
+    BOOST_REQUIRE_CLOSE(probabilities[i], exp(logP), 1e-5);
+  }
+
+  // Changing the variances through the modifiable reference must give the same
+  // results as the setter.
+  DiagonalGaussianDistribution d2(mean, variances);
+  d.Variances(2 * variances);
+  d2.Variances() = 2 * variances;
+
+  d.LogProbability(points, logProbabilities);
+  arma::vec logProbabilities2;
+  d2.LogProbability(points, logProbabilities2);
+  for (size_t i = 0; i < 4; ++i)
+    BOOST_REQUIRE_CLOSE(logProbabilities[i], logProbabilities2[i], 1e-5);
+}
+
+/**
+ * Make sure that estimating a diagonal Gaussian gives the diagonal of the
+ * covariance estimated by GaussianDistribution, with and without
+ * probabilities.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionEstimateTest)
+{
+  arma::mat data = arma::randn<arma::mat>(4, 500);
+  data.row(1) *= 3.0;
+  data.row(2) += 2.0;
+  arma::vec probabilities = arma::randu<arma::vec>(500);
+
+  DiagonalGaussianDistribution d;
+  GaussianDistribution g;
+
+  d.Estimate(data);
+  g.Estimate(data);
+
+  BOOST_REQUIRE_EQUAL(d.Mean().n_elem, 4);
+  BOOST_REQUIRE_EQUAL(d.Variances().n_elem, 4);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(d.Mean()[i], g.Mean()[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(d.Variances()[i], g.Covariance()(i, i), 1e-5);
+  }
+
+  d.Estimate(data, probabilities);
+  g.Estimate(data, probabilities);
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(d.Mean()[i], g.Mean()[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(d.Variances()[i], g.Covariance()(i, i), 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -5,6 +5,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/emst/dendrogram.hpp>
 #include <boost/test/unit_test.hpp>
 #include "old_boost_test_definitions.hpp"
 
@@ -277,4 +278,117 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
 
 }
 
+/**
+ * Make sure that the parallel traversal (when OpenMP is available) and the
+ * cached component membership of larger leaves give the same results as the
+ * naive computation.
+ */
+BOOST_AUTO_TEST_CASE(ParallelLargeLeafVsNaive)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  // Build the tree by hand to get a leaf size of 10.
+  typedef BinarySpaceTree<HRectBound<2>, DTBStat> TreeType;
+  arma::mat dualData = inputData;
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dualData, oldFromNew, 10);
+
+#ifdef _OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  DualTreeBoruvka<> dtb(&tree, dualData);
+  arma::mat dualResults;
+  dtb.ComputeMST(dualResults);
+
+#ifdef _OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  DualTreeBoruvka<> dtbNaive(inputData, true);
+  arma::mat naiveResults;
+  dtbNaive.ComputeMST(naiveResults);
+
+  BOOST_REQUIRE_EQUAL(dualResults.n_cols, naiveResults.n_cols);
+  for (size_t i = 0; i < dualResults.n_cols; ++i)
+  {
+    // The dual-tree results are in terms of the permuted dataset.
+    const size_t a = oldFromNew[size_t(dualResults(0, i))];
+    const size_t b = oldFromNew[size_t(dualResults(1, i))];
+
+    BOOST_REQUIRE_EQUAL(std::min(a, b), naiveResults(0, i));
+    BOOST_REQUIRE_EQUAL(std::max(a, b), naiveResults(1, i));
+    BOOST_REQUIRE_CLOSE(dualResults(2, i), naiveResults(2, i), 1e-5);
+  }
+}
+
+/**
+ * Check the single-linkage dendrogram and flat cuts on the same synthetic
+ * dataset as ExhaustiveSyntheticTest, where the answer can be worked out by
+ * hand.
+ */
+BOOST_AUTO_TEST_CASE(SyntheticDendrogramTest)
+{
+  arma::mat data(1, 11);
+  data[0] = 0.05;
+  data[1] = 0.37;
+  data[2] = 0.15;
+  data[3] = 1.25;
+  data[4] = 5.05;
+  data[5] = -0.22;
+  data[6] = -2.00;
+  data[7] = -1.30;
+  data[8] = 0.45;
+  data[9] = 0.91;
+  data[10] = 1.00;
+
+  DualTreeBoruvka<> dtb(data, true);
+  arma::mat results;
+  dtb.ComputeMST(results);
+
+  Dendrogram dendrogram(results);
+  const arma::mat& merges = dendrogram.Merges();
+
+  BOOST_REQUIRE_EQUAL(dendrogram.NumPoints(), 11);
+  BOOST_REQUIRE_EQUAL(merges.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(merges.n_cols, 10);
+
+  // Merged clusters, in order.
+  const size_t expected[10][3] = { { 1, 8, 2 }, { 9, 10, 2 }, { 0, 2, 2 },
+      { 11, 13, 4 }, { 3, 12, 3 }, { 5, 14, 5 }, { 15, 16, 8 }, { 6, 7, 2 },
+      { 17, 18, 10 }, { 4, 19, 11 } };
+  for (size_t i = 0; i < 10; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(merges(0, i), expected[i][0]);
+    BOOST_REQUIRE_EQUAL(merges(1, i), expected[i][1]);
+    BOOST_REQUIRE_CLOSE(merges(2, i), results(2, i), 1e-5);
+    BOOST_REQUIRE_EQUAL(merges(3, i), expected[i][2]);
+  }
+
+  // Cut into three clusters.
+  arma::Col<size_t> labels;
+  dendrogram.Cut(3, labels);
+  const size_t expectedCut[11] = { 0, 0, 0, 0, 1, 0, 2, 2, 0, 0, 0 };
+  BOOST_REQUIRE_EQUAL(labels.n_elem, 11);
+  for (size_t i = 0; i < 11; ++i)
+    BOOST_REQUIRE_EQUAL(labels[i], expectedCut[i]);
+
+  // Cut at a distance; the edge of length 0.70 separates points 6 and 7.
+  BOOST_REQUIRE_EQUAL(dendrogram.CutAtDistance(0.5, labels), 4);
+  const size_t expectedDistanceCut[11] = { 0, 0, 0, 0, 1, 0, 2, 3, 0, 0, 0 };
+  for (size_t i = 0; i < 11; ++i)
+    BOOST_REQUIRE_EQUAL(labels[i], expectedDistanceCut[i]);
+
+  // One cluster and N clusters.
+  dendrogram.Cut(1, labels);
+  for (size_t i = 0; i < 11; ++i)
+    BOOST_REQUIRE_EQUAL(labels[i], 0);
+  dendrogram.Cut(11, labels);
+  for (size_t i = 0; i < 11; ++i)
+    BOOST_REQUIRE_EQUAL(labels[i], i);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
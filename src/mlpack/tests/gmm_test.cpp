@@ -8,6 +8,7 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/online_em_fit.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -219,6 +220,58 @@ BOOST_AUTO_TEST_CASE(GMMTrainEMMultipleGaussians)
   }
 }
 
+/**
+ * Make sure that the trials of GMM::Estimate() give the same model for the
+ * same random seed, no matter how many threads run them.
+ */
+BOOST_AUTO_TEST_CASE(GMMTrainEMTrialsThreadsTest)
+{
+  // Generate a dataset from three overlapping Gaussians, so that the trials
+  // find different models.
+  arma::mat data(2, 600);
+  data.randn();
+  data.cols(200, 399) += 2.0;
+  data.cols(400, 599) -= 2.0;
+
+  GMM<> gmm1(3, 2);
+  GMM<> gmm2(3, 2);
+
+#ifdef _OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  math::RandomSeed(42);
+  const double likelihood1 = gmm1.Estimate(data, 6);
+
+#ifdef _OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  math::RandomSeed(42);
+  const double likelihood2 = gmm2.Estimate(data, 6);
+
+#ifdef _OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  BOOST_REQUIRE_CLOSE(likelihood1, likelihood2, 1e-5);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(gmm1.Weights()[i], gmm2.Weights()[i], 1e-5);
+    for (size_t j = 0; j < 2; ++j)
+      BOOST_REQUIRE_CLOSE(gmm1.Component(i).Mean()[j],
+          gmm2.Component(i).Mean()[j], 1e-5);
+  }
+
+  // The random number generator of the calling thread must be in the same
+  // state after both runs.
+  const double random1 = math::Random();
+  math::RandomSeed(42);
+  gmm2.Estimate(data, 6);
+  BOOST_REQUIRE_CLOSE(math::Random(), random1, 1e-10);
+}
+
 /**
  * Train a single-gaussian mixture, but using the overload of Estimate() where
  * probabilities of the observation are given.
@@ -433,6 +486,133 @@ BOOST_AUTO_TEST_CASE(GMMRandomTest)
       gmm2.Component(sortedIndices[1]).Covariance()(1, 1), 13.0);
 }
 
+/**
+ * In high dimensions, the probability of every point under every Gaussian can
+ * be smaller than the smallest double.  Make sure that EM still works then,
+ * with a diagonal covariance constraint.
+ */
+BOOST_AUTO_TEST_CASE(GMMTrainEMHighDimensionalTest)
+{
+  // The log-density of a point from one of these Gaussians is about
+  // -0.5 * 300 * (log(2 pi 100) + 1), which is about -1100.
+  const size_t dims = 300;
+  arma::mat data(dims, 400);
+  data.randn();
+  data *= 10.0;
+  data.cols(200, 399) += 100.0;
+
+  GMM<EMFit<kmeans::KMeans<>, DiagonalConstraint> > gmm(2, dims);
+  const double likelihood = gmm.Estimate(data);
+
+  BOOST_REQUIRE(likelihood > -std::numeric_limits<double>::infinity());
+  BOOST_REQUIRE_CLOSE(gmm.Weights()[0], 0.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(gmm.Weights()[1], 0.5, 1e-5);
+
+  // Each Gaussian should have found one of the clusters.
+  const size_t first = (gmm.Component(0).Mean()[0] < 50.0) ? 0 : 1;
+  const arma::vec mean0 = arma::mean(data.cols(0, 199), 1);
+  const arma::vec mean1 = arma::mean(data.cols(200, 399), 1);
+  for (size_t j = 0; j < dims; ++j)
+  {
+    BOOST_REQUIRE_CLOSE(gmm.Component(first).Mean()[j], mean0[j], 1e-5);
+    BOOST_REQUIRE_CLOSE(gmm.Component(1 - first).Mean()[j], mean1[j], 1e-5);
+  }
+
+  // The covariances must be diagonal.
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const arma::mat& covariance = gmm.Component(i).Covariance();
+    BOOST_REQUIRE_SMALL(accu(abs(covariance - diagmat(covariance))), 1e-50);
+  }
+}
+
+/**
+ * A GMM of diagonal Gaussians must find the same model as a GMM of full
+ * Gaussians with the diagonal constraint, since both start from the same
+ * clustering.
+ */
+BOOST_AUTO_TEST_CASE(GMMTrainEMDiagonalGaussianTest)
+{
+  const size_t dims = 50;
+  arma::mat data(dims, 400);
+  data.randn();
+  data.cols(0, 199) *= 2.0;
+  data.cols(200, 399) += 10.0;
+
+  GMM<EMFit<kmeans::KMeans<>, DiagonalConstraint> > gmm(2, dims);
+  GMM<EMFit<kmeans::KMeans<>, DiagonalConstraint,
+      distribution::DiagonalGaussianDistribution> > diagGMM(2, dims);
+
+  math::RandomSeed(10);
+  const double likelihood = gmm.Estimate(data);
+  math::RandomSeed(10);
+  const double diagLikelihood = diagGMM.Estimate(data);
+
+  BOOST_REQUIRE_CLOSE(diagLikelihood, likelihood, 1e-5);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(diagGMM.Weights()[i], gmm.Weights()[i], 1e-5);
+    for (size_t j = 0; j < dims; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(diagGMM.Component(i).Mean()[j],
+          gmm.Component(i).Mean()[j], 1e-5);
+      BOOST_REQUIRE_CLOSE(diagGMM.Component(i).Variances()[j],
+          gmm.Component(i).Covariance()(j, j), 1e-5);
+    }
+  }
+
+  // The probabilities of points under each model must match too.
+  arma::vec logProbabilities, diagLogProbabilities;
+  gmm.LogProbability(data, logProbabilities);
+  diagGMM.LogProbability(data, diagLogProbabilities);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(diagLogProbabilities[i], logProbabilities[i], 1e-5);
+}
+
+/**
+ * Train a GMM with online EM on a stream of batches from a known mixture, and
+ * make sure it finds the mixture without seeing more than one batch at a time.
+ */
+BOOST_AUTO_TEST_CASE(GMMTrainOnlineEMTest)
+{
+  // The mixture has two well-separated Gaussians.
+  distribution::GaussianDistribution d1("0.0 0.0", "1.0 0.3; 0.3 1.0");
+  distribution::GaussianDistribution d2("6.0 3.0", "2.0 -0.5; -0.5 1.0");
+  const double weight1 = 0.3;
+
+  arma::mat batch(2, 200);
+  GMM<OnlineEMFit<> > gmm(2, 2);
+  for (size_t b = 0; b < 100; ++b)
+  {
+    for (size_t i = 0; i < batch.n_cols; ++i)
+      batch.col(i) = (math::Random() < weight1) ? d1.Random() : d2.Random();
+
+    // The first batch finds the initial model; the others update it.
+    gmm.Estimate(batch, 1, (b > 0));
+  }
+
+  // Two steps are taken for each batch, since the batch size is 100.
+  BOOST_REQUIRE_EQUAL(gmm.Fitter().Steps(), 200);
+
+  const size_t first = (gmm.Component(0).Mean()[0] < 3.0) ? 0 : 1;
+  BOOST_REQUIRE_SMALL(gmm.Weights()[first] - weight1, 0.03);
+  BOOST_REQUIRE_SMALL(gmm.Weights()[1 - first] - (1.0 - weight1), 0.03);
+
+  for (size_t j = 0; j < 2; ++j)
+  {
+    BOOST_REQUIRE_SMALL(gmm.Component(first).Mean()[j] - d1.Mean()[j], 0.15);
+    BOOST_REQUIRE_SMALL(gmm.Component(1 - first).Mean()[j] - d2.Mean()[j],
+        0.15);
+    for (size_t k = 0; k < 2; ++k)
+    {
+      BOOST_REQUIRE_SMALL(gmm.Component(first).Covariance()(j, k) -
+          d1.Covariance()(j, k), 0.25);
+      BOOST_REQUIRE_SMALL(gmm.Component(1 - first).Covariance()(j, k) -
+          d2.Covariance()(j, k), 0.25);
+    }
+  }
+}
+
 /**
  * Test classification of observations by component.
  */
@@ -209,6 +209,76 @@ BOOST_AUTO_TEST_CASE(SimpleBaumWelchDiscreteHMM)
   BOOST_REQUIRE_CLOSE(hmm.Initial()[0], 1.0, 1e-5);
 }
 
+/**
+ * Make sure that Baum-Welch training gives the same model when the sequences
+ * are processed with one thread and with several threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBaumWelchDiscreteHMM)
+{
+  // Generate the training sequences from a known model.
+  arma::mat transition("0.7 0.2 0.3;"
+                       "0.2 0.6 0.2;"
+                       "0.1 0.2 0.5");
+  std::vector<DiscreteDistribution> emission(3);
+  emission[0] = DiscreteDistribution("0.6 0.2 0.1 0.1");
+  emission[1] = DiscreteDistribution("0.1 0.6 0.2 0.1");
+  emission[2] = DiscreteDistribution("0.1 0.1 0.2 0.6");
+
+  HMM<DiscreteDistribution> hmm(arma::vec("0.4 0.3 0.3"), transition,
+      emission);
+
+  std::vector<arma::mat> observations(200);
+  arma::Col<size_t> states;
+  for (size_t i = 0; i < observations.size(); ++i)
+    hmm.Generate(20 + (i % 15), observations[i], states, i % 3);
+
+  // Start both models from the same random guess.
+  std::vector<DiscreteDistribution> guess(3);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    guess[i].Probabilities() = arma::randu<arma::vec>(4);
+    guess[i].Probabilities() /= accu(guess[i].Probabilities());
+  }
+  arma::mat guessTransition = arma::randu<arma::mat>(3, 3);
+  for (size_t i = 0; i < 3; ++i)
+    guessTransition.col(i) /= accu(guessTransition.col(i));
+
+  HMM<DiscreteDistribution> serialHMM(arma::vec("0.4 0.3 0.3"),
+      guessTransition, guess);
+  HMM<DiscreteDistribution> parallelHMM(arma::vec("0.4 0.3 0.3"),
+      guessTransition, guess);
+
+#ifdef _OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  serialHMM.Train(observations);
+
+#ifdef _OPENMP
+  omp_set_num_threads(4);
+#endif
+
+  parallelHMM.Train(observations);
+
+#ifdef _OPENMP
+  omp_set_num_threads(oldThreads);
+#endif
+
+  // The sums are done in a different order, so the models may be very slightly
+  // different.
+  for (size_t i = 0; i < 3; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+      BOOST_REQUIRE_CLOSE(parallelHMM.Transition()(i, j),
+          serialHMM.Transition()(i, j), 1e-3);
+
+    for (size_t j = 0; j < 4; ++j)
+      BOOST_REQUIRE_CLOSE(parallelHMM.Emission()[i].Probabilities()[j],
+          serialHMM.Emission()[i].Probabilities()[j], 1e-3);
+  }
+}
+
 /**
  * Increasing complexity, but still simple; 4 emissions, 2 states; the state can
  * be determined directly by the emission.
@@ -580,6 +650,54 @@ BOOST_AUTO_TEST_CASE(GaussianHMMSimpleTest)
   }
 }
 
+/**
+ * Make sure that an observation far away from the emission distributions of
+ * every state doesn't make the likelihood of the sequence underflow.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMOutlierTest)
+{
+  GaussianDistribution g1("5.0 5.0", "1.0 0.0; 0.0 1.0");
+  GaussianDistribution g2("-5.0 -5.0", "1.0 0.0; 0.0 1.0");
+
+  arma::vec initial("0.5 0.5");
+  arma::mat transition("0.75 0.25; 0.25 0.75");
+
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(g1);
+  emission.push_back(g2);
+
+  HMM<GaussianDistribution> hmm(initial, transition, emission);
+
+  // The probability of the third observation is exp(-9025) / (2 pi) for the
+  // first state, which is zero in double precision.
+  arma::mat observations("5.0 -5.0 100.0 5.0;"
+                         "5.0 -5.0 100.0 5.0");
+
+  arma::mat stateProb, forwardProb, backwardProb;
+  arma::vec scales;
+  const double estimateLogLikelihood = hmm.Estimate(observations, stateProb,
+      forwardProb, backwardProb, scales);
+  const double logLikelihood = hmm.LogLikelihood(observations);
+
+  BOOST_REQUIRE(logLikelihood > -std::numeric_limits<double>::infinity());
+  BOOST_REQUIRE_LT(logLikelihood, -9025.0);
+  BOOST_REQUIRE_CLOSE(estimateLogLikelihood, logLikelihood, 1e-5);
+
+  // The state probabilities must still be valid.
+  for (size_t t = 0; t < observations.n_cols; ++t)
+    BOOST_REQUIRE_CLOSE(accu(stateProb.col(t)), 1.0, 1e-5);
+
+  // The outlier is much closer to the first Gaussian.
+  arma::Col<size_t> predictedClasses;
+  hmm.Predict(observations, predictedClasses);
+
+  BOOST_REQUIRE_EQUAL(predictedClasses[0], 0);
+  BOOST_REQUIRE_EQUAL(predictedClasses[1], 1);
+  BOOST_REQUIRE_EQUAL(predictedClasses[2], 0);
+  BOOST_REQUIRE_EQUAL(predictedClasses[3], 0);
+  BOOST_REQUIRE_SMALL(stateProb(1, 2), 1e-5);
+}
+
 /**
  * Ensure that Gaussian HMMs can be trained properly, for the labeled training
  * case and also for the unlabeled training case.
@@ -764,6 +882,49 @@ BOOST_AUTO_TEST_CASE(GaussianHMMGenerateTest)
   }
 }
 
+/**
+ * Make sure that an HMM with diagonal Gaussian emissions can be trained on a
+ * sequence that it generated, and finds the original model.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianHMMGenerateTest)
+{
+  HMM<DiagonalGaussianDistribution> hmm(2, DiagonalGaussianDistribution(3));
+  hmm.Transition() = arma::mat("0.9 0.2; 0.1 0.8");
+  hmm.Emission()[0] = DiagonalGaussianDistribution("0.0 0.0 0.0",
+      "1.0 2.0 0.5");
+  hmm.Emission()[1] = DiagonalGaussianDistribution("3.0 -1.0 2.0",
+      "0.5 1.0 1.5");
+
+  std::vector<arma::mat> observations(1);
+  std::vector<arma::Col<size_t> > states(1);
+  hmm.Generate(10000, observations[0], states[0], 0);
+
+  HMM<DiagonalGaussianDistribution> hmm2(2, DiagonalGaussianDistribution(3));
+  hmm2.Train(observations, states);
+
+  for (size_t row = 0; row < 2; row++)
+    for (size_t col = 0; col < 2; col++)
+      BOOST_REQUIRE_SMALL(hmm.Transition()(row, col) - hmm2.Transition()(row,
+          col), 0.03);
+
+  for (size_t em = 0; em < 2; em++)
+  {
+    for (size_t d = 0; d < 3; d++)
+    {
+      BOOST_REQUIRE_SMALL(hmm.Emission()[em].Mean()[d] -
+          hmm2.Emission()[em].Mean()[d], 0.09);
+      BOOST_REQUIRE_SMALL(hmm.Emission()[em].Variances()[d] -
+          hmm2.Emission()[em].Variances()[d], 0.2);
+    }
+  }
+
+  // The most likely state sequence should be nearly the true one.
+  arma::Col<size_t> predictedStates;
+  hmm2.Predict(observations[0], predictedStates);
+  const size_t correct = arma::accu(predictedStates == states[0]);
+  BOOST_REQUIRE_GT(correct, 9500);
+}
+
 /**
  * Test that HMMs work with Gaussian mixture models.  We'll try putting in a
  * simple model by hand and making sure that prediction of observation sequences
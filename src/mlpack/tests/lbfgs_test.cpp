@@ -112,4 +112,74 @@ BOOST_AUTO_TEST_CASE(RosenbrockWoodFunctionTest)
   }
 }
 
+/**
+ * The Rosenbrock function, with an EvaluateWithGradient() function, which
+ * counts how many times each function is called.
+ */
+class FusedRosenbrockFunction
+{
+ public:
+  FusedRosenbrockFunction() : gradients(0), fusedEvaluations(0) { }
+
+  double Evaluate(const arma::mat& coordinates)
+  {
+    return f.Evaluate(coordinates);
+  }
+
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient)
+  {
+    ++gradients;
+    f.Gradient(coordinates, gradient);
+  }
+
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient)
+  {
+    ++fusedEvaluations;
+    f.Gradient(coordinates, gradient);
+    return f.Evaluate(coordinates);
+  }
+
+  const arma::mat& GetInitialPoint() const { return f.GetInitialPoint(); }
+
+  size_t gradients;
+  size_t fusedEvaluations;
+
+ private:
+  RosenbrockFunction f;
+};
+
+/**
+ * Make sure that L-BFGS uses EvaluateWithGradient() when the function has it,
+ * and that it gives the same result as with Evaluate() and Gradient().
+ */
+BOOST_AUTO_TEST_CASE(EvaluateWithGradientTest)
+{
+  RosenbrockFunction f;
+  L_BFGS<RosenbrockFunction> lbfgs(f);
+  lbfgs.MaxIterations() = 10000;
+
+  arma::mat coords = f.GetInitialPoint();
+  if (!lbfgs.Optimize(coords))
+    BOOST_FAIL("L-BFGS optimization reported failure.");
+
+  BOOST_REQUIRE(HasEvaluateWithGradient<FusedRosenbrockFunction>::value);
+
+  FusedRosenbrockFunction fusedF;
+  L_BFGS<FusedRosenbrockFunction> fusedLbfgs(fusedF);
+  fusedLbfgs.MaxIterations() = 10000;
+
+  arma::mat fusedCoords = fusedF.GetInitialPoint();
+  if (!fusedLbfgs.Optimize(fusedCoords))
+    BOOST_FAIL("L-BFGS optimization reported failure.");
+
+  // Every gradient should have been calculated by EvaluateWithGradient().
+  BOOST_REQUIRE_EQUAL(fusedF.gradients, (size_t) 0);
+  BOOST_REQUIRE_GT(fusedF.fusedEvaluations, 0);
+
+  // The same calculations were done, so the result should be the same.
+  BOOST_REQUIRE_CLOSE(fusedCoords[0], coords[0], 1e-10);
+  BOOST_REQUIRE_CLOSE(fusedCoords[1], coords[1], 1e-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
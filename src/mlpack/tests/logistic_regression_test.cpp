@@ -7,6 +7,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/logistic_regression/logistic_regression.hpp>
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
+#include <mlpack/core/optimizers/minibatch_sgd/minibatch_sgd.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "old_boost_test_definitions.hpp"
@@ -655,6 +656,96 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionSGDGaussianTest)
   BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
 }
 
+/**
+ * Test that the batch versions of Evaluate() and Gradient() are the sums of the
+ * separable versions.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionBatchTest)
+{
+  // Random dataset with random responses.
+  const size_t points = 500;
+  const size_t dimension = 10;
+  arma::mat data;
+  data.randu(dimension, points);
+  arma::vec responses(points);
+  for (size_t i = 0; i < points; ++i)
+    responses[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction lrf(data, responses, 0.3);
+
+  arma::vec parameters;
+  parameters.randu(dimension + 1);
+
+  for (size_t begin = 0; begin < points; begin += 128)
+  {
+    const size_t batchSize = std::min((size_t) 128, points - begin);
+
+    double cost = 0.0;
+    arma::mat gradient(dimension + 1, 1);
+    gradient.zeros();
+    for (size_t i = begin; i < begin + batchSize; ++i)
+    {
+      cost += lrf.Evaluate(parameters, i);
+
+      arma::mat pointGradient;
+      lrf.Gradient(parameters, i, pointGradient);
+      gradient += pointGradient;
+    }
+
+    BOOST_REQUIRE_CLOSE(lrf.Evaluate(parameters, begin, batchSize), cost,
+        1e-5);
+
+    arma::mat batchGradient;
+    lrf.Gradient(parameters, begin, batchGradient, batchSize);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(batchGradient[i], gradient[i], 1e-5);
+  }
+}
+
+/**
+ * Test mini-batch SGD on a two-Gaussian dataset.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionMiniBatchSGDGaussianTest)
+{
+  // Generate a two-Gaussian dataset, with the classes interleaved so that each
+  // batch has points of both classes.
+  GaussianDistribution g1(arma::vec("1.0 1.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("9.0 9.0 9.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(3, 1000);
+  arma::vec responses(1000);
+  for (size_t i = 0; i < 1000; i += 2)
+  {
+    data.col(i) = g1.Random();
+    responses[i] = 0;
+    data.col(i + 1) = g2.Random();
+    responses[i + 1] = 1;
+  }
+
+  // Now train a logistic regression object on it.
+  LogisticRegressionFunction lrf(data, responses, 0.5);
+  MiniBatchSGD<LogisticRegressionFunction> mbsgd(lrf, 0.001, 100000, 1e-5,
+      true, 10);
+  LogisticRegression<MiniBatchSGD> lr(mbsgd);
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(data, responses);
+
+  BOOST_REQUIRE_CLOSE(acc, 100.0, 0.3); // 0.3% error tolerance.
+
+  // Create a test set.
+  for (size_t i = 0; i < 1000; i += 2)
+  {
+    data.col(i) = g1.Random();
+    data.col(i + 1) = g2.Random();
+  }
+
+  // Ensure that the error is close to zero.
+  const double testAcc = lr.ComputeAccuracy(data, responses);
+
+  BOOST_REQUIRE_CLOSE(testAcc, 100.0, 0.6); // 0.6% error tolerance.
+}
+
 /**
  * Test constructor that takes an already-instantiated optimizer.
  */
@@ -696,4 +787,54 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionInstantiatedOptimizer)
   BOOST_REQUIRE_SMALL(sigmoids[2], 0.1);
 }
 
+/**
+ * Test that EvaluateWithGradient() gives the same results as Evaluate() and
+ * Gradient(), for the full, separable, and batch versions, and that the
+ * optimizers can detect it.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionEvaluateWithGradient)
+{
+  BOOST_REQUIRE(optimization::HasEvaluateWithGradient<
+      LogisticRegressionFunction>::value);
+  BOOST_REQUIRE(optimization::HasSeparableEvaluateWithGradient<
+      LogisticRegressionFunction>::value);
+
+  // Random dataset with random responses.
+  const size_t points = 500;
+  const size_t dimension = 10;
+  arma::mat data;
+  data.randu(dimension, points);
+  arma::vec responses(points);
+  for (size_t i = 0; i < points; ++i)
+    responses[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction lrf(data, responses, 0.3);
+
+  arma::vec parameters;
+  parameters.randu(dimension + 1);
+
+  arma::mat gradient, fusedGradient;
+  lrf.Gradient(parameters, gradient);
+  BOOST_REQUIRE_CLOSE(lrf.EvaluateWithGradient(parameters, fusedGradient),
+      lrf.Evaluate(parameters), 1e-5);
+  BOOST_REQUIRE_EQUAL(fusedGradient.n_elem, gradient.n_elem);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(fusedGradient[i], gradient[i], 1e-5);
+
+  for (size_t j = 0; j < points; j += 50)
+  {
+    lrf.Gradient(parameters, j, gradient);
+    BOOST_REQUIRE_CLOSE(lrf.EvaluateWithGradient(parameters, j, fusedGradient),
+        lrf.Evaluate(parameters, j), 1e-5);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(fusedGradient[i], gradient[i], 1e-5);
+  }
+
+  lrf.Gradient(parameters, 100, gradient, 128);
+  BOOST_REQUIRE_CLOSE(lrf.EvaluateWithGradient(parameters, 100, fusedGradient,
+      128), lrf.Evaluate(parameters, 100, 128), 1e-5);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(fusedGradient[i], gradient[i], 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -131,6 +131,54 @@ BOOST_AUTO_TEST_CASE(Johnson844LovaszThetaSDP)
   }
 }
 
+/**
+ * Make sure that the LRSDP specialization of
+ * AugLagrangianFunction::EvaluateWithGradient() gives the same results as
+ * Evaluate() and Gradient().
+ */
+BOOST_AUTO_TEST_CASE(LRSDPEvaluateWithGradientTest)
+{
+  arma::mat edges;
+  data::Load("johnson8-4-4.csv", edges, true);
+
+  arma::mat coordinates;
+  createLovaszThetaInitialPoint(edges, coordinates);
+
+  LRSDP lovasz(edges.n_cols + 1, coordinates);
+  setupLovaszTheta(edges, lovasz);
+
+  AugLagrangianFunction<LRSDPFunction> alf(lovasz.Function(),
+      lovasz.AugLag().Lambda(), 10.0);
+
+  // Check at the initial point and at a few perturbations of it, where the
+  // constraints are not satisfied.
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::mat point = coordinates;
+    if (trial > 0)
+      point += 0.1 * arma::randn<arma::mat>(point.n_rows, point.n_cols);
+
+    const double objective = alf.Evaluate(point);
+    arma::mat gradient;
+    alf.Gradient(point, gradient);
+
+    arma::mat fusedGradient;
+    const double fusedObjective = alf.EvaluateWithGradient(point,
+        fusedGradient);
+
+    BOOST_REQUIRE_CLOSE(fusedObjective, objective, 1e-5);
+    BOOST_REQUIRE_EQUAL(fusedGradient.n_rows, gradient.n_rows);
+    BOOST_REQUIRE_EQUAL(fusedGradient.n_cols, gradient.n_cols);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+    {
+      if (std::abs(gradient[i]) < 1e-8)
+        BOOST_REQUIRE_SMALL(fusedGradient[i], 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(fusedGradient[i], gradient[i], 1e-5);
+    }
+  }
+}
+
 /**
  * keller4.co test case for Lovasz-Theta LRSDP.
  * This is commented out because it takes a long time to run.
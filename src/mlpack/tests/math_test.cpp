@@ -5,6 +5,7 @@
  * Tests for everything in the math:: namespace.
  */
 #include <mlpack/core/math/clamp.hpp>
+#include <mlpack/core/math/parallel_column_reduce.hpp>
 #include <mlpack/core/math/random.hpp>
 #include <mlpack/core/math/range.hpp>
 #include <boost/test/unit_test.hpp>
@@ -578,4 +579,47 @@ BOOST_AUTO_TEST_CASE(RangeContainsRange)
   BOOST_REQUIRE_EQUAL(b.Contains(a), true);
 }
 
+/**
+ * Make sure ParallelColumnReduce() gives the same sums as a serial loop, for
+ * both scalar and matrix results, and over a range that does not start at 0.
+ */
+BOOST_AUTO_TEST_CASE(ParallelColumnReduceTest)
+{
+  arma::mat data;
+  data.randu(5, 1003);
+
+  double sum = 0.0;
+  ParallelColumnReduce(0, data.n_cols,
+      [&](const size_t begin, const size_t end, double& blockSum)
+      {
+        blockSum = arma::accu(data.cols(begin, end - 1));
+      }, sum);
+
+  BOOST_REQUIRE_CLOSE(sum, arma::accu(data), 1e-10);
+
+  arma::mat outerProducts;
+  ParallelColumnReduce(10, 500,
+      [&](const size_t begin, const size_t end, arma::mat& blockSum)
+      {
+        blockSum = data.cols(begin, end - 1) * data.cols(begin, end - 1).t();
+      }, outerProducts);
+
+  const arma::mat expected = data.cols(10, 499) * data.cols(10, 499).t();
+  BOOST_REQUIRE_EQUAL(outerProducts.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(outerProducts.n_cols, 5);
+  for (size_t i = 0; i < expected.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(outerProducts[i], expected[i], 1e-10);
+
+  // Every column must be visited exactly once, even with a large minimum block
+  // size.
+  size_t count = 0;
+  ParallelColumnReduce(0, 1003,
+      [&](const size_t begin, const size_t end, size_t& blockCount)
+      {
+        blockCount = end - begin;
+      }, count, 300);
+
+  BOOST_REQUIRE_EQUAL(count, 1003);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -122,4 +122,131 @@ BOOST_AUTO_TEST_CASE(NaiveBayesClassifierIncrementalTest)
     BOOST_REQUIRE_EQUAL(testRes(i), calcVec(i));
 }
 
+/**
+ * Train on a dataset large enough to be split into several blocks, and make
+ * sure the batched training gives the same model as the incremental algorithm,
+ * and that the classification matches a direct computation of the most likely
+ * class.  The dimensionality is high enough that the probabilities themselves
+ * underflow, so this also checks that classification works in log space.
+ */
+BOOST_AUTO_TEST_CASE(NaiveBayesClassifierBatchTest)
+{
+  const size_t classes = 4;
+  const size_t dimensionality = 500;
+  arma::mat data = arma::randn<arma::mat>(dimensionality, 10000);
+  arma::Col<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    labels[i] = math::RandInt(classes);
+    data.col(i) *= (labels[i] + 1);
+    data.col(i) += 0.1 * labels[i];
+  }
+
+  NaiveBayesClassifier<> nbc(data, labels, classes);
+  NaiveBayesClassifier<> incrementalNbc(data, labels, classes, true);
+
+  for (size_t i = 0; i < classes; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(nbc.Probabilities()[i],
+        incrementalNbc.Probabilities()[i], 1e-5);
+    for (size_t j = 0; j < dimensionality; ++j)
+    {
+      BOOST_REQUIRE_SMALL(nbc.Means()(j, i) - incrementalNbc.Means()(j, i),
+          1e-8);
+      BOOST_REQUIRE_CLOSE(nbc.Variances()(j, i),
+          incrementalNbc.Variances()(j, i), 1e-5);
+    }
+  }
+
+  arma::Col<size_t> results;
+  nbc.Classify(data, results);
+  BOOST_REQUIRE_EQUAL(results.n_elem, data.n_cols);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    // Find the most likely class directly.
+    size_t best = 0;
+    double bestLogProb = -std::numeric_limits<double>::infinity();
+    for (size_t c = 0; c < classes; ++c)
+    {
+      double logProb = log(nbc.Probabilities()[c]);
+      for (size_t j = 0; j < dimensionality; ++j)
+      {
+        const double diff = data(j, i) - nbc.Means()(j, c);
+        logProb -= 0.5 * (log(2 * M_PI * nbc.Variances()(j, c)) +
+            diff * diff / nbc.Variances()(j, c));
+      }
+
+      if (logProb > bestLogProb)
+      {
+        best = c;
+        bestLogProb = logProb;
+      }
+    }
+
+    BOOST_REQUIRE_EQUAL(results[i], best);
+    if (results[i] == labels[i])
+      ++correct;
+  }
+
+  // The classes have very different variances, so this should be easy.
+  BOOST_REQUIRE_GT(correct, 9900);
+}
+
+/**
+ * Training on a dataset in several batches (with Train()) should give the same
+ * model as training on all of it at once, and the model should survive a save
+ * and load.
+ */
+BOOST_AUTO_TEST_CASE(NaiveBayesClassifierTrainBatchesTest)
+{
+  const size_t classes = 3;
+  const size_t dimensionality = 10;
+  arma::mat data = arma::randn<arma::mat>(dimensionality, 3000);
+  arma::Col<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    labels[i] = math::RandInt(classes);
+    data.col(i) = 2.0 * data.col(i) + 5.0 * labels[i];
+  }
+
+  NaiveBayesClassifier<> nbc(data, labels, classes);
+
+  // Train in batches of different sizes, alternating the variance algorithm.
+  NaiveBayesClassifier<> batchNbc(dimensionality, classes);
+  batchNbc.Train(data.cols(0, 99), labels.subvec(0, 99));
+  batchNbc.Train(data.cols(100, 1099), labels.subvec(100, 1099), true);
+  batchNbc.Train(data.cols(1100, 2999), labels.subvec(1100, 2999));
+
+  for (size_t i = 0; i < classes; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(nbc.Probabilities()[i], batchNbc.Probabilities()[i],
+        1e-5);
+    BOOST_REQUIRE_CLOSE(nbc.Counts()[i], batchNbc.Counts()[i], 1e-5);
+    for (size_t j = 0; j < dimensionality; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(nbc.Means()(j, i), batchNbc.Means()(j, i), 1e-5);
+      BOOST_REQUIRE_CLOSE(nbc.Variances()(j, i), batchNbc.Variances()(j, i),
+          1e-5);
+    }
+  }
+
+  // Save and load the model, then make sure it classifies the same way.
+  util::SaveRestoreUtility sr;
+  batchNbc.Save(sr);
+  NaiveBayesClassifier<> loadedNbc;
+  loadedNbc.Load(sr);
+
+  BOOST_REQUIRE_EQUAL(loadedNbc.Counts().n_elem, classes);
+  for (size_t i = 0; i < classes; ++i)
+    BOOST_REQUIRE_CLOSE(loadedNbc.Counts()[i], batchNbc.Counts()[i], 1e-5);
+
+  arma::Col<size_t> results, loadedResults;
+  nbc.Classify(data, results);
+  loadedNbc.Classify(data, loadedResults);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(results[i], loadedResults[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -166,4 +166,41 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * This test trains the perceptron in parallel with iterative parameter mixing
+ * on a linearly separable dataset, and checks that it converges to a correct
+ * classifier, and that classifying a large set at once (in blocks) gives the
+ * same labels as classifying it in pieces.
+ */
+BOOST_AUTO_TEST_CASE(ShardedTraining)
+{
+  // Three well-separated classes.
+  mat trainData = 0.5 * randn<mat>(2, 3000);
+  Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+  {
+    labels[i] = i % 3;
+    trainData(0, i) += 10.0 * labels[i];
+    trainData(1, i) -= 10.0 * labels[i];
+  }
+
+  Perceptron<> p(trainData, labels, 1000, 4);
+  BOOST_REQUIRE_EQUAL(p.Shards(), 4);
+
+  Row<size_t> predictedLabels;
+  p.Classify(trainData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(predictedLabels[i], labels[i]);
+
+  Row<size_t> firstLabels, secondLabels;
+  p.Classify(trainData.cols(0, 1499), firstLabels);
+  p.Classify(trainData.cols(1500, 2999), secondLabels);
+  for (size_t i = 0; i < 1500; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictedLabels[i], firstLabels[i]);
+    BOOST_REQUIRE_EQUAL(predictedLabels[1500 + i], secondLabels[i]);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
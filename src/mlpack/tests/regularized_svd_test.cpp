@@ -244,4 +244,121 @@ BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimize)
   BOOST_REQUIRE_SMALL(relativeError, 1e-2);
 }
 
+/**
+ * Make sure that the batch gradients, which only hold the columns touched by
+ * each batch, sum to the full gradient.
+ */
+BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionBatchGradient)
+{
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t maxRating = 5;
+  const size_t rank = 10;
+  const size_t batchSize = 7;
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+  data.row(2) = floor(data.row(2) * maxRating + 0.5);
+
+  // Manually set last row to maximum user and maximum item.
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  RegularizedSVDFunction rSVDFunc(data, rank, 0.5);
+
+  arma::mat gradient;
+  rSVDFunc.Gradient(parameters, gradient);
+
+  arma::mat batchGradientSum;
+  batchGradientSum.zeros(rank, numUsers + numItems);
+  for (size_t begin = 0; begin < numRatings; begin += batchSize)
+  {
+    arma::uvec columns;
+    arma::mat batchGradient;
+    rSVDFunc.Gradient(parameters, begin, columns, batchGradient,
+        std::min(batchSize, numRatings - begin));
+
+    // Each batch touches at most one user and one item for each rating.
+    BOOST_REQUIRE_EQUAL(batchGradient.n_cols, columns.n_elem);
+    BOOST_REQUIRE_LE(columns.n_elem, 2 * batchSize);
+
+    for (size_t k = 0; k < columns.n_elem; ++k)
+      batchGradientSum.col(columns[k]) += batchGradient.col(k);
+  }
+
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    if (std::abs(gradient[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(batchGradientSum[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(batchGradientSum[i], gradient[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that the lock-free parallel optimizer converges about as well as
+ * the serial optimizer on a real dataset.
+ */
+BOOST_AUTO_TEST_CASE(RegularizedSVDParallelSGDTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLens100k.csv", dataset);
+
+  const size_t rank = 10;
+  const size_t iterations = 10;
+
+  // Factorize with both optimizers, starting from the same random seed.  Each
+  // factorization is timed, so that the throughput of the two optimizers can
+  // be compared with --verbose.
+  arma::mat u, v;
+  mlpack::math::RandomSeed(10);
+  RegularizedSVD<> serialSVD(iterations);
+  Timer::Start("serial_regularized_svd");
+  serialSVD.Apply(dataset, rank, u, v);
+  Timer::Stop("serial_regularized_svd");
+
+  arma::mat parallelU, parallelV;
+  mlpack::math::RandomSeed(10);
+  RegularizedSVD<mlpack::optimization::ParallelSGD> parallelSVD(iterations);
+  Timer::Start("parallel_regularized_svd");
+  parallelSVD.Apply(dataset, rank, parallelU, parallelV);
+  Timer::Stop("parallel_regularized_svd");
+
+  const timeval serialTime = Timer::Get("serial_regularized_svd");
+  const timeval parallelTime = Timer::Get("parallel_regularized_svd");
+  const double serialSeconds = serialTime.tv_sec + serialTime.tv_usec / 1e6;
+  const double parallelSeconds = parallelTime.tv_sec +
+      parallelTime.tv_usec / 1e6;
+  Log::Info << "RegularizedSVD on " << dataset.n_cols << " ratings: SGD took "
+      << serialSeconds << "s, ParallelSGD took " << parallelSeconds << "s ("
+      << (serialSeconds / parallelSeconds) << "x)." << std::endl;
+
+  // Compute the training RMSE of each factorization.  u holds the items and v
+  // holds the users.
+  double serialError = 0.0;
+  double parallelError = 0.0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    const size_t user = dataset(0, i);
+    const size_t item = dataset(1, i);
+
+    const double serialDiff = dataset(2, i) - arma::dot(u.row(item),
+        v.col(user));
+    const double parallelDiff = dataset(2, i) - arma::dot(
+        parallelU.row(item), parallelV.col(user));
+
+    serialError += serialDiff * serialDiff;
+    parallelError += parallelDiff * parallelDiff;
+  }
+  serialError = std::sqrt(serialError / dataset.n_cols);
+  parallelError = std::sqrt(parallelError / dataset.n_cols);
+
+  BOOST_REQUIRE_LT(parallelError, 1.1 * serialError);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -166,6 +166,53 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
   }
 }
 
+/**
+ * Make sure that the batch objective and gradient, summed over all batches, are
+ * the same as the full objective and gradient.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionBatchTest)
+{
+  const size_t points = 1000;
+  const size_t inputSize = 10;
+  const size_t numClasses = 5;
+  const size_t batchSize = 64;
+
+  // Initialize a random dataset.
+  arma::mat data;
+  data.randu(inputSize, points);
+
+  // Create random class labels.
+  arma::vec labels(points);
+  for(size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunction srf(data, labels, inputSize, numClasses, 0.5);
+  BOOST_REQUIRE_EQUAL(srf.NumFunctions(), points);
+
+  arma::mat parameters;
+  parameters.randu(numClasses, inputSize);
+
+  double batchCost = 0.0;
+  arma::mat batchGradient(numClasses, inputSize);
+  batchGradient.zeros();
+  for (size_t begin = 0; begin < points; begin += batchSize)
+  {
+    const size_t size = std::min(batchSize, points - begin);
+    batchCost += srf.Evaluate(parameters, begin, size);
+
+    arma::mat gradient;
+    srf.Gradient(parameters, begin, gradient, size);
+    batchGradient += gradient;
+  }
+
+  arma::mat gradient;
+  srf.Gradient(parameters, gradient);
+
+  BOOST_REQUIRE_CLOSE(batchCost, srf.Evaluate(parameters), 1e-5);
+  for (size_t i = 0; i < gradient.n_elem; i++)
+    BOOST_REQUIRE_CLOSE(batchGradient[i], gradient[i], 1e-5);
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTwoClasses)
 {
   const size_t points = 1000;
@@ -298,4 +345,41 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionMultipleClasses)
   BOOST_REQUIRE_CLOSE(testAcc, 100.0, 2.0);
 }
 
+/**
+ * Make sure that EvaluateWithGradient() gives the same results as Evaluate()
+ * and Gradient().
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluateWithGradient)
+{
+  const size_t points = 1000;
+  const size_t inputSize = 10;
+  const size_t numClasses = 5;
+
+  // Initialize a random dataset.
+  arma::mat data;
+  data.randu(inputSize, points);
+
+  // Create random class labels.
+  arma::vec labels(points);
+  for(size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunction srf(data, labels, inputSize, numClasses, 0.5);
+  BOOST_REQUIRE(optimization::HasEvaluateWithGradient<
+      SoftmaxRegressionFunction>::value);
+
+  arma::mat parameters;
+  parameters.randu(numClasses, inputSize);
+
+  arma::mat gradient, fusedGradient;
+  srf.Gradient(parameters, gradient);
+  const double cost = srf.EvaluateWithGradient(parameters, fusedGradient);
+
+  BOOST_REQUIRE_CLOSE(cost, srf.Evaluate(parameters), 1e-5);
+  BOOST_REQUIRE_EQUAL(fusedGradient.n_rows, numClasses);
+  BOOST_REQUIRE_EQUAL(fusedGradient.n_cols, inputSize);
+  for (size_t i = 0; i < gradient.n_elem; i++)
+    BOOST_REQUIRE_CLOSE(fusedGradient[i], gradient[i], 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
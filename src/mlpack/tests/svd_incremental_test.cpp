@@ -2,6 +2,7 @@
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/termination_policies/incomplete_incremental_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/complete_incremental_termination.hpp>
@@ -65,6 +66,29 @@ BOOST_AUTO_TEST_CASE(SVDCompleteIncrementalConvergenceTest)
                     amf.TerminationPolicy().MaxIterations());
 }
 
+/**
+ * Test for convergence of parallel incremental learning.
+ */
+BOOST_AUTO_TEST_CASE(SVDParallelIncrementalConvergenceTest)
+{
+  mlpack::math::RandomSeed(10);
+  sp_mat data;
+  data.sprandn(1000, 1000, 0.2);
+
+  SVDParallelIncrementalLearning svd(0.01);
+  SimpleToleranceTermination<sp_mat> stt;
+
+  AMF<SimpleToleranceTermination<sp_mat>,
+      RandomInitialization,
+      SVDParallelIncrementalLearning> amf(stt, RandomInitialization(), svd);
+
+  mat m1,m2;
+  amf.Apply(data, 2, m1, m2);
+
+  BOOST_REQUIRE_NE(amf.TerminationPolicy().Iteration(),
+                    amf.TerminationPolicy().MaxIterations());
+}
+
 
 BOOST_AUTO_TEST_CASE(SVDIncompleteIncrementalRegularizationTest)
 {
@@ -116,4 +140,42 @@ BOOST_AUTO_TEST_CASE(SVDIncompleteIncrementalRegularizationTest)
   BOOST_REQUIRE_LT(RMSE_2, RMSE_1);
 }
 
+/**
+ * Make sure that the sparse specializations of the incomplete incremental
+ * update rules give the same result as the dense rules, when there is no
+ * regularization (the dense rule regularizes every row of W, while the sparse
+ * rule only regularizes rows the user has rated).
+ */
+BOOST_AUTO_TEST_CASE(SVDIncompleteIncrementalSparseDenseTest)
+{
+  mlpack::math::RandomSeed(10);
+  sp_mat sparseData;
+  sparseData.sprandu(50, 30, 0.1);
+  mat denseData(sparseData);
+
+  mat W = randu<mat>(50, 3);
+  mat H = randu<mat>(3, 30);
+  mat sparseW = W, sparseH = H;
+  mat denseW = W, denseH = H;
+
+  SVDIncompleteIncrementalLearning sparseSVD(0.01);
+  SVDIncompleteIncrementalLearning denseSVD(0.01);
+  sparseSVD.Initialize(sparseData, 3);
+  denseSVD.Initialize(denseData, 3);
+
+  // Two passes over all the users.
+  for (size_t i = 0; i < 60; ++i)
+  {
+    sparseSVD.WUpdate(sparseData, sparseW, sparseH);
+    sparseSVD.HUpdate(sparseData, sparseW, sparseH);
+    denseSVD.WUpdate(denseData, denseW, denseH);
+    denseSVD.HUpdate(denseData, denseW, denseH);
+  }
+
+  for (size_t i = 0; i < W.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sparseW[i], denseW[i], 1e-8);
+  for (size_t i = 0; i < H.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sparseH[i], denseH[i], 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
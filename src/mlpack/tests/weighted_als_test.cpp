@@ -0,0 +1,96 @@
+/**
+ * @file weighted_als_test.cpp
+ *
+ * Tests for the weighted alternating least squares update rule for AMF.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/amf/amf.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
+#include <mlpack/methods/amf/init_rules/random_init.hpp>
+#include <mlpack/methods/amf/termination_policies/simple_tolerance_termination.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "old_boost_test_definitions.hpp"
+
+BOOST_AUTO_TEST_SUITE(WeightedALSTest);
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::amf;
+using namespace arma;
+
+/**
+ * Make sure that a low-rank matrix with missing entries is reconstructed well
+ * on the observed entries.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSLowRankTest)
+{
+  mlpack::math::RandomSeed(10);
+
+  // Make a random rank 3 matrix and observe 30% of it.
+  const mat w = randu<mat>(200, 3);
+  const mat h = randu<mat>(3, 100);
+  sp_mat data;
+  data.sprandu(200, 100, 0.3);
+  for (sp_mat::iterator it = data.begin(); it != data.end(); ++it)
+    (*it) = dot(w.row(it.row()), h.col(it.col()));
+
+  AMF<SimpleToleranceTermination<sp_mat>,
+      RandomInitialization,
+      WeightedALSUpdate> amf(SimpleToleranceTermination<sp_mat>(),
+                             RandomInitialization(),
+                             WeightedALSUpdate(1e-4));
+  mat m1, m2;
+  amf.Apply(data, 3, m1, m2);
+
+  double error = 0.0;
+  for (sp_mat::const_iterator it = data.begin(); it != data.end(); ++it)
+  {
+    const double diff = (*it) - dot(m1.row(it.row()), m2.col(it.col()));
+    error += diff * diff;
+  }
+  error = std::sqrt(error / data.n_nonzero);
+
+  BOOST_REQUIRE_SMALL(error, 0.05);
+}
+
+/**
+ * Make sure that the dense and sparse versions give the same results.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSSparseDenseTest)
+{
+  sp_mat data;
+  data.sprandu(100, 80, 0.2);
+  mat denseData(data);
+
+  AMF<SimpleToleranceTermination<sp_mat>,
+      RandomInitialization,
+      WeightedALSUpdate> sparseAMF;
+  AMF<SimpleToleranceTermination<mat>,
+      RandomInitialization,
+      WeightedALSUpdate> denseAMF;
+
+  mat w1, h1, w2, h2;
+  mlpack::math::RandomSeed(10);
+  sparseAMF.Apply(data, 5, w1, h1);
+  mlpack::math::RandomSeed(10);
+  denseAMF.Apply(denseData, 5, w2, h2);
+
+  for (size_t i = 0; i < w1.n_elem; ++i)
+  {
+    if (std::abs(w1[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(w2[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(w1[i], w2[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < h1.n_elem; ++i)
+  {
+    if (std::abs(h1[i]) < 1e-5)
+      BOOST_REQUIRE_SMALL(h2[i], 1e-5);
+    else
+      BOOST_REQUIRE_CLOSE(h1[i], h2[i], 1e-5);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END();